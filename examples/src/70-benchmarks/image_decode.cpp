@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <epoxy/gl.h>
+#include <GLFW/glfw3.h>
+
+#include <shadertoy/gl.hpp>
+#include <shadertoy/inputs/hdr_input.hpp>
+#include <shadertoy/inputs/jpeg_input.hpp>
+#include <shadertoy/inputs/qoi_input.hpp>
+#include <shadertoy/inputs/soil_input.hpp>
+
+#include "test_config.hpp"
+
+#if __cpp_lib_filesystem >= 201703
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem::v1;
+#endif
+
+using namespace shadertoy::inputs;
+
+namespace
+{
+
+/// Hidden window providing the GL context inputs need to be created
+class gl_context
+{
+	GLFWwindow *window_;
+
+public:
+	gl_context() : window_(nullptr)
+	{
+		if (glfwInit())
+		{
+			glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+			window_ = glfwCreateWindow(1, 1, "libshadertoy example 70-benchmarks", nullptr, nullptr);
+
+			if (window_)
+			{
+				glfwMakeContextCurrent(window_);
+			}
+		}
+	}
+
+	~gl_context()
+	{
+		if (window_)
+		{
+			glfwDestroyWindow(window_);
+		}
+
+		glfwTerminate();
+	}
+
+	explicit operator bool() const { return window_ != nullptr; }
+};
+
+bool has_gl_context()
+{
+	static gl_context context;
+	return static_cast<bool>(context);
+}
+
+/// Decoder to benchmark on the files of a corpus
+struct image_decoder
+{
+	/// Name of the decoder, used in benchmark names
+	const char *name;
+
+	/// Lowercase extensions of the files this decoder can read
+	std::vector<std::string> extensions;
+
+	/// true if the decoder is built into the library
+	std::function<bool()> supported;
+
+	/// Create an input of the type using this decoder
+	std::function<std::unique_ptr<file_input>()> create;
+};
+
+const std::vector<image_decoder> &image_decoders()
+{
+	static const std::vector<image_decoder> decoders{
+		{ "jpeg", { ".jpg", ".jpeg" }, &jpeg_input::supported, []() { return std::make_unique<jpeg_input>(); } },
+		{ "hdr", { ".hdr" }, &hdr_input::supported, []() { return std::make_unique<hdr_input>(); } },
+		{ "qoi", { ".qoi" }, &qoi_input::supported, []() { return std::make_unique<qoi_input>(); } },
+		{ "soil", { ".bmp", ".png", ".jpg", ".jpeg", ".tga", ".psd", ".hdr" }, &soil_input::supported,
+		  []() { return std::make_unique<soil_input>(); } },
+	};
+
+	return decoders;
+}
+
+/// Directory holding the images to decode
+std::string corpus_directory()
+{
+	if (const char *directory = std::getenv("LIBSHADERTOY_BENCHMARK_IMAGES"))
+	{
+		return directory;
+	}
+
+	return ST_BASE_DIR "/images";
+}
+
+void image_decode(benchmark::State &state, const image_decoder &decoder, const std::string &filename)
+{
+	if (!has_gl_context())
+	{
+		state.SkipWithError("Failed to create a GL context");
+		return;
+	}
+
+	auto decode(decoder.create()->decoder());
+	if (!decode)
+	{
+		state.SkipWithError("Decoder not available");
+		return;
+	}
+
+	size_t pixels = 0, bytes = 0;
+
+	for (auto _ : state)
+	{
+		auto image(decode(filename, false));
+		benchmark::DoNotOptimize(image.pixels.data());
+
+		pixels = static_cast<size_t>(image.width) * image.height;
+		bytes = image.pixels.size();
+	}
+
+	// Decoded pixels and bytes, so files of different sizes and decoders can be compared
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pixels));
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+/// Register one benchmark per file of the corpus and decoder able to read it
+int register_image_decode()
+{
+	std::error_code ec;
+	std::vector<fs::path> files;
+
+	for (fs::directory_iterator it(corpus_directory(), ec), end; !ec && it != end; it.increment(ec))
+	{
+		if (fs::is_regular_file(it->status()))
+		{
+			files.push_back(it->path());
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+
+	for (const auto &decoder : image_decoders())
+	{
+		if (!decoder.supported())
+		{
+			continue;
+		}
+
+		for (const auto &file : files)
+		{
+			auto ext(file.extension().string());
+			std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+			if (std::find(decoder.extensions.begin(), decoder.extensions.end(), ext) == decoder.extensions.end())
+			{
+				continue;
+			}
+
+			auto name("image_decode/" + std::string(decoder.name) + "/" + file.filename().string());
+			benchmark::RegisterBenchmark(name.c_str(), image_decode, decoder, file.string())
+			->Unit(benchmark::kMillisecond);
+		}
+	}
+
+	return 0;
+}
+
+const int image_decode_registered = register_image_decode();
+}
@@ -0,0 +1,82 @@
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <epoxy/gl.h>
+
+#include <shadertoy/compiler/shader_template.hpp>
+
+using shadertoy::compiler::shader_template;
+
+namespace
+{
+
+/// Generate a template of at least the given size, with a part directive every few lines
+std::string generate_template(size_t size)
+{
+	std::ostringstream ss;
+	ss << "#version 450\n";
+
+	for (int block = 0; static_cast<size_t>(ss.tellp()) < size; ++block)
+	{
+		ss << "#pragma shadertoy part *:defines_" << block << "\n";
+		ss << "#pragma shadertoy part buffer:uniforms_" << block << " begin\n";
+		ss << "uniform vec4 iParam" << block << ";\n";
+		ss << "#pragma shadertoy part end\n";
+
+		for (int line = 0; line < 16; ++line)
+		{
+			ss << "float helper_" << block << "_" << line << "(vec2 p) { return dot(p, vec2(" << line
+			   << ".0, 1.0)) * iParam" << block << ".x; }\n";
+		}
+
+		ss << "    // #pragma shadertoy part is only a directive at the start of a line\n";
+	}
+
+	return ss.str();
+}
+
+void template_parse(benchmark::State &state)
+{
+	auto source(generate_template(static_cast<size_t>(state.range(0)) << 20));
+
+	for (auto _ : state)
+	{
+		auto st(shader_template::parse(source, "generated"));
+		benchmark::DoNotOptimize(st);
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * source.size());
+}
+
+/// Baseline: match every line against the regular expression formerly used by shader_template::parse
+void template_parse_regex_baseline(benchmark::State &state)
+{
+	auto source(generate_template(static_cast<size_t>(state.range(0)) << 20));
+	std::regex directive(
+	"^\\s*#pragma\\s+shadertoy\\s+part\\s+(?:((?:\\*|[a-zA-Z_][a-zA-Z\\-_0-9]*):[a-zA-Z_][a-zA-Z\\-_0-9]*)(?:\\s+("
+	"begin))?|(end))\\s*$");
+
+	for (auto _ : state)
+	{
+		std::istringstream is(source);
+		std::string line;
+		std::smatch match;
+		size_t directives = 0;
+
+		while (std::getline(is, line))
+		{
+			if (std::regex_match(line, match, directive))
+				directives++;
+		}
+
+		benchmark::DoNotOptimize(directives);
+	}
+
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * source.size());
+}
+}
+
+BENCHMARK(template_parse)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
+BENCHMARK(template_parse_regex_baseline)->Arg(1)->Arg(4)->Arg(16)->Unit(benchmark::kMillisecond);
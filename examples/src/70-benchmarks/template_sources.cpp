@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <epoxy/gl.h>
+
+#include <shadertoy/compiler/shader_template.hpp>
+#include <shadertoy/compiler/template_part.hpp>
+
+using namespace shadertoy::compiler;
+
+namespace
+{
+/// Number of calls to the global operator new
+std::atomic<size_t> allocation_count(0);
+
+/// Number of bytes requested from the global operator new
+std::atomic<size_t> allocation_bytes(0);
+}
+
+void *operator new(std::size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+
+	if (void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+/// Number of specified parts in the generated template
+constexpr int template_parts = 64;
+
+/// Size of the GLSL source of each part
+constexpr size_t part_size = 8 << 10;
+
+/// Generate a GLSL source of roughly part_size bytes
+std::string generate_source(int part)
+{
+	std::string source;
+	for (int line = 0; source.size() < part_size; ++line)
+	{
+		source += "float helper_" + std::to_string(part) + "_" + std::to_string(line) +
+				  "(vec2 p) { return dot(p, vec2(1.0)); }\n";
+	}
+
+	return source;
+}
+
+/// Snapshot of the allocation counters, reported per iteration when the benchmark ends
+class allocation_counter
+{
+	benchmark::State &state_;
+	size_t count_;
+	size_t bytes_;
+
+public:
+	allocation_counter(benchmark::State &state)
+	: state_(state),
+	  count_(allocation_count.load()),
+	  bytes_(allocation_bytes.load())
+	{
+	}
+
+	~allocation_counter()
+	{
+		auto iterations(static_cast<double>(state_.iterations()));
+		state_.counters["allocs"] = (allocation_count.load() - count_) / iterations;
+		state_.counters["alloc_bytes"] = (allocation_bytes.load() - bytes_) / iterations;
+	}
+};
+
+/// Template made of specified parts and one unspecified buffer:sources part, as used by buffers
+shader_template generate_template()
+{
+	shader_template st;
+
+	for (int part = 0; part < template_parts; ++part)
+		st.push_back(std::make_unique<template_part>("glsl:part_" + std::to_string(part), generate_source(part)));
+
+	st.push_back(std::make_unique<template_part>("buffer:sources"));
+	return st;
+}
+
+/// Specify a template and get its sources, as is done when compiling a buffer
+void template_sources(benchmark::State &state)
+{
+	auto st(generate_template());
+	template_part buffer_sources("buffer:sources", generate_source(template_parts));
+
+	allocation_counter counter(state);
+	for (auto _ : state)
+	{
+		auto specified(st.specify([](const std::string &) { return std::vector<std::unique_ptr<basic_part>>(); },
+								  buffer_sources));
+		auto sources(specified.sources());
+		benchmark::DoNotOptimize(sources);
+	}
+}
+
+/// Part holding its sources by value, as template parts used to
+struct copied_part
+{
+	std::string name;
+	std::vector<named_source> sources;
+};
+
+/// Baseline: cloning a part and getting its sources copy the source contents
+void template_sources_copy_baseline(benchmark::State &state)
+{
+	std::vector<std::unique_ptr<copied_part>> parts;
+	for (int part = 0; part <= template_parts; ++part)
+	{
+		auto name("glsl:part_" + std::to_string(part));
+		parts.emplace_back(std::make_unique<copied_part>(copied_part{ name, { { name, generate_source(part) } } }));
+	}
+
+	allocation_counter counter(state);
+	for (auto _ : state)
+	{
+		std::vector<std::unique_ptr<copied_part>> specified;
+		for (const auto &part : parts)
+			specified.emplace_back(std::make_unique<copied_part>(*part));
+
+		std::vector<named_source> sources;
+		for (const auto &part : specified)
+		{
+			auto part_sources(part->sources);
+			std::copy(part_sources.begin(), part_sources.end(), std::back_inserter(sources));
+		}
+
+		benchmark::DoNotOptimize(sources);
+	}
+}
+}
+
+BENCHMARK(template_sources);
+BENCHMARK(template_sources_copy_baseline);
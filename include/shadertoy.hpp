@@ -17,6 +17,7 @@
 #include "shadertoy/compiler/template_error.hpp"
 #include "shadertoy/compiler/template_part.hpp"
 
+#include "shadertoy/compiler/deferred_program.hpp"
 #include "shadertoy/compiler/program_template.hpp"
 
 #include "shadertoy/geometry/basic_geometry.hpp"
@@ -25,12 +26,19 @@
 #include "shadertoy/inputs/basic_input.hpp"
 #include "shadertoy/inputs/buffer_input.hpp"
 #include "shadertoy/inputs/checker_input.hpp"
+#include "shadertoy/inputs/decoded_image.hpp"
+#include "shadertoy/inputs/dynamic_input.hpp"
 #include "shadertoy/inputs/error_input.hpp"
 #include "shadertoy/inputs/exr_input.hpp"
 #include "shadertoy/inputs/file_input.hpp"
+#include "shadertoy/inputs/hdr_input.hpp"
 #include "shadertoy/inputs/image_input.hpp"
 #include "shadertoy/inputs/jpeg_input.hpp"
+#include "shadertoy/inputs/ktx_input.hpp"
 #include "shadertoy/inputs/noise_input.hpp"
+#include "shadertoy/inputs/qoi_input.hpp"
+#include "shadertoy/inputs/sequence_input.hpp"
+#include "shadertoy/inputs/shared_input.hpp"
 #include "shadertoy/inputs/soil_input.hpp"
 
 #include "shadertoy/draw_state.hpp"
@@ -45,10 +53,15 @@
 #include "shadertoy/buffers/toy_buffer.hpp"
 #include "shadertoy/buffers/geometry_buffer.hpp"
 
+#include "shadertoy/program_cache.hpp"
 #include "shadertoy/program_interface.hpp"
+#include "shadertoy/program_registry.hpp"
+#include "shadertoy/texture_budget.hpp"
 
 #include "shadertoy/render_context.hpp"
 #include "shadertoy/shader_compiler.hpp"
+#include "shadertoy/spirv_compiler.hpp"
+#include "shadertoy/source_cache.hpp"
 #include "shadertoy/swap_chain.hpp"
 
 #include "shadertoy/utils.hpp"
@@ -76,6 +76,17 @@ protected:
 	 */
 	virtual void init_contents(const render_context &context, const io_resource &io) = 0;
 
+	/**
+	 * @brief     Start long-running initialization work for the contents of this
+	 *            buffer, such as submitting programs for compilation. This is
+	 *            called before basic_buffer#init_contents when initializing a
+	 *            swap_chain. The default implementation does nothing.
+	 *
+	 * @param[in]  context Rendering context to use for shared objects
+	 * @param[in]  io      IO resource object
+	 */
+	virtual void prepare_contents(const render_context &context, const io_resource &io);
+
 	/**
 	 * @brief     Allocate size-dependent resources for the contents of this buffer.
 	 *            This method must be implemented by derived classes to respond to
@@ -124,6 +135,15 @@ public:
 	 */
 	void init(const render_context &context, const io_resource &io);
 
+	/**
+	 * @brief      Start preparing the current buffer for rendering. Calling
+	 *             this method before basic_buffer#init is optional.
+	 *
+	 * @param[in]  context Rendering context to use for shared objects
+	 * @param[in]  io      IO resource object
+	 */
+	void prepare(const render_context &context, const io_resource &io);
+
 	/**
 	 * @brief      Allocate the textures for this buffer. Note that the current
 	 *             contents of previous textures are discarded.
@@ -163,6 +183,32 @@ public:
 	 * requested outputs
 	 */
 	virtual std::optional<std::vector<buffer_output>> get_buffer_outputs() const;
+
+	/**
+	 * @brief Create a copy of this buffer, used by swap_chain#clone
+	 *
+	 * The copy has the same configuration as this buffer, but its own GPU
+	 * resources. It must be initialized before being rendered.
+	 *
+	 * The default implementation throws, derived classes which can be cloned
+	 * should override this method.
+	 *
+	 * @return New buffer with the same configuration as this one
+	 *
+	 * @throws shadertoy_error This buffer cannot be cloned
+	 */
+	virtual std::shared_ptr<basic_buffer> clone() const;
+
+	/**
+	 * @brief Update the references of this buffer to members of a cloned chain
+	 *
+	 * This is called on the buffers returned by basic_buffer#clone once all
+	 * the members of the chain have been cloned. The default implementation
+	 * does nothing.
+	 *
+	 * @param clones Clones of the members of the original chain
+	 */
+	virtual void remap_members(const members::member_map_t &clones);
 };
 }
 }
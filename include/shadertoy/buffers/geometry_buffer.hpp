@@ -31,6 +31,13 @@ public:
 	 */
 	geometry_buffer(const std::string &id);
 
+	/**
+	 * @brief      Create a copy of this buffer
+	 *
+	 * @return     New buffer with the same configuration as this one
+	 */
+	std::shared_ptr<basic_buffer> clone() const override;
+
 	/**
 	 * @brief      Get the current geometry object
 	 *
@@ -44,7 +44,8 @@ protected:
 	void init_contents(const render_context &context, const io_resource &io) override;
 
 	/**
-	 * @brief     Initialize the renderbuffer object for the new specified size.
+	 * @brief     Initialize the renderbuffer object for the new specified size,
+	 *            and attach the target textures of \p io to the framebuffer.
 	 *
 	 * @param[in]  context Rendering context to use for shared objects
 	 * @param[in]  io      IO resource object
@@ -7,9 +7,13 @@
 
 #include "shadertoy/program_input.hpp"
 #include "shadertoy/program_interface.hpp"
+#include "shadertoy/program_registry.hpp"
 #include "shadertoy/compiler/program_template.hpp"
 
 #include <deque>
+#include <map>
+#include <memory>
+#include <vector>
 
 #define SHADERTOY_ICHANNEL_COUNT 4
 
@@ -24,11 +28,65 @@ namespace buffers
 class shadertoy_EXPORT program_buffer : public gl_buffer
 {
 private:
-	/// Buffer program
-	gl::program program_;
+	/// Buffer program and its interface, shared with identical buffers
+	std::shared_ptr<shared_program> program_;
 
-	/// Program interface details
-	std::unique_ptr<program_interface> program_interface_;
+	/// Registry key of the buffer program
+	program_registry::entry_key program_key_;
+
+	/// Uniform value set on this buffer
+	struct basic_uniform_value
+	{
+		virtual ~basic_uniform_value() = default;
+
+		/// Set the value on the given uniform
+		virtual void apply(const gl::uniform_location &location) const = 0;
+
+		/// Copy this value
+		virtual std::unique_ptr<basic_uniform_value> clone() const = 0;
+	};
+
+	/// Single uniform value
+	template<typename T>
+	struct uniform_value : public basic_uniform_value
+	{
+		T value;
+
+		explicit uniform_value(const T &value) : value(value) {}
+
+		void assign(const T &new_value)
+		{ value = new_value; }
+
+		void apply(const gl::uniform_location &location) const override
+		{ location.set_value(value); }
+
+		std::unique_ptr<basic_uniform_value> clone() const override
+		{ return std::make_unique<uniform_value<T>>(value); }
+	};
+
+	/// Array uniform value
+	template<typename T>
+	struct uniform_array_value : public basic_uniform_value
+	{
+		std::vector<T> values;
+
+		uniform_array_value(size_t count, const T *values) : values(values, values + count) {}
+
+		void assign(size_t count, const T *new_values)
+		{ values.assign(new_values, new_values + count); }
+
+		void apply(const gl::uniform_location &location) const override
+		{ location.set_value(values.size(), values.data()); }
+
+		std::unique_ptr<basic_uniform_value> clone() const override
+		{ return std::make_unique<uniform_array_value<T>>(values.size(), values.data()); }
+	};
+
+	/// Uniform values set on this buffer, by uniform name
+	std::map<std::string, std::unique_ptr<basic_uniform_value>> uniform_state_;
+
+	/// Program pipeline, used when the program template builds separable programs
+	std::unique_ptr<gl::program_pipeline> pipeline_;
 
 	/// Inputs for this shader
 	std::deque<program_input> inputs_;
@@ -42,6 +100,59 @@ private:
 	/// Pointer to the map to store compiled sources
 	std::map<GLenum, std::string> *source_map_;
 
+	/// true if prepare_contents has been called since the last init_contents
+	bool prepared_;
+
+	/// Program submitted for compilation by reload
+	std::unique_ptr<compiler::deferred_program> reload_program_;
+
+	/// Program cache key of the reloaded program
+	program_cache::entry_key reload_cache_key_;
+
+	/// Registry key of the reloaded program
+	program_registry::entry_key reload_key_;
+
+	/// Get the program template used to compile this buffer
+	const compiler::program_template &current_template(const render_context &context) const;
+
+	/// Get the fully specified sources of the program for this buffer
+	compiler::program_template::sources_map specify_sources(const render_context &context) const;
+
+	/// Build the interface of the newly linked program, and store it in the program cache
+	void init_program(const render_context &context);
+
+	/// Store the code compiled for the program in the source map, if any
+	void store_source_map(const compiler::program_template &buffer_template,
+						  const compiler::program_template::sources_map &sources) const;
+
+	/// Record a uniform value, and set it on the program. Values which are
+	/// set again with the same type are updated in place, without allocating.
+	template<typename TValue, typename TIndex, typename... TArgs>
+	bool set_uniform_state(const TIndex &identifier, TArgs &&... args)
+	{
+		auto resource = program_->interface->uniforms().try_get(identifier);
+		if (!resource)
+			return false;
+
+		auto &state(uniform_state_[resource->name]);
+		if (auto value = dynamic_cast<TValue *>(state.get()))
+			value->assign(std::forward<TArgs>(args)...);
+		else
+			state = std::make_unique<TValue>(std::forward<TArgs>(args)...);
+
+		state->apply(resource->get_location(program_->program));
+		return true;
+	}
+
+	/// Upload the uniform values of this buffer to its program
+	void apply_uniform_state() const;
+
+	/// Assign texture units to the sampler uniforms of the program
+	void bind_input_units();
+
+	/// Build the program pipeline if the program template builds separable programs
+	void init_pipeline(const render_context &context);
+
 protected:
 	/**
 	 * @brief      Initialize the geometry to use for this buffer
@@ -68,6 +179,15 @@ protected:
 	 */
 	void init_contents(const render_context &context, const io_resource &io) override;
 
+	/**
+	 * @brief      Submit the program of this buffer for compilation, or load it
+	 *             from the program cache
+	 *
+	 * @param[in]  context Rendering context to use for shared objects
+	 * @param[in]  io      IO resource object
+	 */
+	void prepare_contents(const render_context &context, const io_resource &io) override;
+
 	/**
 	 * @brief      Render the contents of this buffer.
 	 *
@@ -76,6 +196,16 @@ protected:
 	 */
 	void render_gl_contents(const render_context &context, const io_resource &io) override;
 
+	/**
+	 * @brief      Copy the configuration of this buffer to a clone
+	 *
+	 * The inputs, sources, override program and uniform values are copied.
+	 * The program itself is shared again when the clone is initialized.
+	 *
+	 * @param[out] target Clone of this buffer
+	 */
+	void clone_to(program_buffer &target) const;
+
 public:
 	/**
 	 * @brief      Initialize a new ShaderProgram buffer
@@ -87,10 +217,23 @@ public:
 	/**
 	 * @brief      Get a reference to the program represented by this buffer
 	 *
+	 * The program may be shared with other buffers which have the same
+	 * sources. Use program_buffer#set_uniform to set uniform values specific
+	 * to this buffer. The buffer must have been initialized.
+	 *
 	 * @return     OpenGL program for this buffer.
 	 */
 	inline const gl::program &program() const
-	{ return program_; }
+	{ return program_->program; }
+
+	/**
+	 * @brief      Get the program pipeline for this buffer
+	 *
+	 * @return     Pointer to the program pipeline, or null if the program
+	 *             template does not build separable programs
+	 */
+	inline const gl::program_pipeline *pipeline() const
+	{ return pipeline_.get(); }
 
 	/**
 	 * @brief      Get a reference to the input array for this buffer
@@ -184,13 +327,104 @@ public:
 	 */
 	std::optional<std::vector<buffer_output>> get_buffer_outputs() const override;
 
+	/**
+	 * @brief Start recompiling the program for this buffer from its current sources
+	 *
+	 * The current program is kept in use until the new one is ready and
+	 * program_buffer#commit_reload is called. Errors while specifying the
+	 * sources are logged, and the current program is kept.
+	 *
+	 * @param context Rendering context to use for shared objects
+	 */
+	void reload(const render_context &context);
+
+	/**
+	 * @brief Replace the current program with the reloaded one if it is ready
+	 *
+	 * This should be called between frames. If the driver supports
+	 * GL_KHR_parallel_shader_compile, this does not wait for the compilation to
+	 * complete. Otherwise, the reloaded program is linked by the first call
+	 * and committed by the next one, so the synchronous link does not happen
+	 * on the same frame as the compilation (see compiler::deferred_program#ready).
+	 * If the reloaded program failed to compile or link, the error is logged
+	 * and the current program is kept.
+	 *
+	 * Note that the outputs of the buffer are only updated by re-initializing
+	 * the swap chain.
+	 *
+	 * @param context Rendering context to use for shared objects
+	 *
+	 * @return true if the program has been replaced, false otherwise
+	 */
+	bool commit_reload(const render_context &context);
+
+	/**
+	 * @brief Check if a reloaded program is waiting to be committed
+	 *
+	 * @return true if program_buffer#reload has been called since the last
+	 *         successful or failed program_buffer#commit_reload
+	 */
+	inline bool reload_pending() const
+	{ return static_cast<bool>(reload_program_); }
+
 	/**
 	 * @brief Get the program interface for this buffer
 	 *
 	 * @return Reference to the interface object for this buffer
 	 */
 	inline const program_interface &interface() const
-	{ return *program_interface_; }
+	{ return *program_->interface; }
+
+	/**
+	 * @brief Check if the program of this buffer is shared with other buffers
+	 *
+	 * @return true if other buffers use the same program, false otherwise
+	 */
+	inline bool program_shared() const
+	{ return program_.use_count() > 1; }
+
+	/**
+	 * @brief Set the value of a uniform for this buffer
+	 *
+	 * The value is set on the program immediately, and recorded so it can be
+	 * uploaded again before rendering this buffer when the program is shared
+	 * with other buffers. The buffer must have been initialized.
+	 *
+	 * @param identifier Name or location of the uniform
+	 * @param value      Value of the uniform
+	 *
+	 * @return true if the uniform is active in the program, false otherwise
+	 */
+	template<typename TIndex, typename T>
+	bool set_uniform(const TIndex &identifier, const T &value)
+	{
+		return set_uniform_state<uniform_value<T>>(identifier, value);
+	}
+
+	/**
+	 * @brief Set the value of an array uniform for this buffer
+	 *
+	 * See program_buffer#set_uniform. The values are copied.
+	 *
+	 * @param identifier Name or location of the uniform
+	 * @param count      Number of values
+	 * @param values     Pointer to the values
+	 *
+	 * @return true if the uniform is active in the program, false otherwise
+	 */
+	template<typename TIndex, typename T>
+	bool set_uniform(const TIndex &identifier, size_t count, const T *values)
+	{
+		return set_uniform_state<uniform_array_value<T>>(identifier, count, values);
+	}
+
+	/**
+	 * @brief Replace inputs reading from members of a cloned chain with inputs
+	 *        reading from the clones of these members
+	 *
+	 * @param clones Clones of the members of the original chain
+	 */
+	void remap_members(const members::member_map_t &clones) override;
 };
 }
 }
@@ -31,6 +31,13 @@ public:
 	 * @param[in]  id       Identifier for this buffer
 	 */
 	toy_buffer(const std::string &id);
+
+	/**
+	 * @brief      Create a copy of this buffer
+	 *
+	 * @return     New buffer with the same configuration as this one
+	 */
+	std::shared_ptr<basic_buffer> clone() const override;
 };
 }
 }
@@ -3,6 +3,7 @@
 
 #include "shadertoy/pre.hpp"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -12,6 +13,26 @@ namespace shadertoy
 namespace compiler
 {
 
+/// Named GLSL source. The first element is the name of the source, the second element is the GLSL source contents.
+typedef std::pair<std::string, std::string> named_source;
+
+/// Immutable named source, shared by the template parts and programs which use it
+typedef std::shared_ptr<const named_source> shared_source;
+
+/// List of shared named sources
+typedef std::vector<shared_source> source_list;
+
+/**
+ * @brief Create a new shared named source
+ *
+ * @param name     Name of the source
+ * @param contents GLSL source contents
+ *
+ * @return Shared source object
+ */
+inline shared_source make_source(std::string name, std::string contents)
+{ return std::make_shared<const named_source>(std::move(name), std::move(contents)); }
+
 /**
  * @brief Base class representing a part of a shader_template
  */
@@ -57,13 +78,14 @@ public:
 	/**
 	 * @brief Obtain this template part's sources
 	 *
-	 * @return Sources for this template part. The first element of each pair is the name of the source part,
+	 * @return Sources for this template part. The first element of each source is the name of the source part,
 	 * and the second element is the GLSL source contents. The first element
-	 * may be the name of the basic_part instance.
+	 * may be the name of the basic_part instance. Sources are immutable and
+	 * shared, so copying the returned list does not copy the source contents.
 	 *
 	 * @throws template_error If this template's source is not defined
 	 */
-	virtual std::vector<std::pair<std::string, std::string>> sources() const = 0;
+	virtual source_list sources() const = 0;
 
 	/**
 	 * @brief Clones this part for use in a new shader template
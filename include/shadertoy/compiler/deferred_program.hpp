@@ -0,0 +1,126 @@
+#ifndef _SHADERTOY_COMPILER_DEFERRED_PROGRAM_HPP_
+#define _SHADERTOY_COMPILER_DEFERRED_PROGRAM_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/compiler/basic_part.hpp"
+
+#include "shadertoy/gl/program.hpp"
+#include "shadertoy/gl/shader.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace shadertoy
+{
+namespace compiler
+{
+
+/**
+ * @brief Represents a program whose compilation and linking have been
+ * submitted to the driver, but whose status has not been checked yet.
+ *
+ * Drivers with background compiler threads can compile multiple programs
+ * concurrently as long as the application does not query their status. A
+ * swap_chain first submits the programs of all its members, and only then
+ * waits for each of them using deferred_program#get.
+ *
+ * Pre-compiled shaders attached to this program are referenced and must
+ * remain valid until deferred_program#get has been called.
+ */
+class shadertoy_EXPORT deferred_program
+{
+	/// Program being linked
+	gl::program program_;
+
+	/// Shaders compiled for this program, with the sources they were compiled from
+	std::vector<std::pair<gl::shader, source_list>> shaders_;
+
+	/// Pre-compiled shaders attached to this program
+	std::vector<const gl::shader *> precompiled_shaders_;
+
+	/// true if the driver supports GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile
+	bool parallel_compile_;
+
+	/// true if linking was requested, but postponed to the next call to ready
+	bool link_pending_;
+
+	/// Detach all shaders from the program
+	void detach_shaders() const;
+
+public:
+	/**
+	 * @brief Initialize a new deferred_program with no attached shaders
+	 *
+	 * @param separable true to link the program as a separable program
+	 */
+	deferred_program(bool separable = false);
+
+	/**
+	 * @brief Submit a shader for compilation, and attach it to this program
+	 *
+	 * @param type    Type of the shader
+	 * @param sources Named sources of the shader, used for error reporting
+	 */
+	void submit_shader(GLenum type, source_list sources);
+
+	/**
+	 * @brief Load a SPIR-V shader module, and attach it to this program
+	 *
+	 * @param type      Type of the shader
+	 * @param module    SPIR-V module, as returned by spirv_compiler#compile
+	 * @param constants Values of the specialization constants of the module
+	 */
+	void submit_module(GLenum type, const std::vector<uint32_t> &module,
+					   const std::map<GLuint, GLuint> &constants);
+
+	/**
+	 * @brief Attach a pre-compiled shader to this program
+	 *
+	 * @param shader Compiled shader object
+	 */
+	void attach_shader(const gl::shader &shader);
+
+	/**
+	 * @brief Submit the program for linking
+	 *
+	 * Without parallel shader compilation, linking is postponed to the next
+	 * call to deferred_program#ready or deferred_program#get.
+	 */
+	void link();
+
+	/**
+	 * @brief Check if the compilation and link results are available
+	 *
+	 * This uses GL_KHR_parallel_shader_compile (or its ARB equivalent) when
+	 * supported, which is looked up once when the program is created.
+	 *
+	 * Otherwise, the driver compiles and links synchronously, so the work is
+	 * spread over calls: the first call after deferred_program#link links the
+	 * program and returns false, and the following calls return true. Polling
+	 * once per frame thus blocks a frame for the compilation, and another one
+	 * for the link, instead of a single frame for both.
+	 *
+	 * @return true if deferred_program#get will not block
+	 */
+	bool ready();
+
+	/**
+	 * @brief Wait for the compilation and link results
+	 *
+	 * This method may only be called once.
+	 *
+	 * @return Linked program
+	 *
+	 * @throws gl::shader_compilation_error A shader failed to compile
+	 * @throws gl::program_link_error       The program failed to link
+	 */
+	gl::program get();
+};
+}
+}
+
+#endif /* _SHADERTOY_COMPILER_DEFERRED_PROGRAM_HPP_ */
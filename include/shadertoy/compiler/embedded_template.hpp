@@ -0,0 +1,54 @@
+#ifndef _SHADERTOY_COMPILER_EMBEDDED_TEMPLATE_HPP_
+#define _SHADERTOY_COMPILER_EMBEDDED_TEMPLATE_HPP_
+
+#include <cstddef>
+
+namespace shadertoy
+{
+namespace compiler
+{
+
+/**
+ * @brief Template part split at build time
+ *
+ * Instances of this type are generated by the `shadertoy_add_templates` CMake
+ * function, and are not meant to be written by hand.
+ */
+struct embedded_part
+{
+	/// Name of the part, or nullptr for anonymous source parts
+	const char *name;
+
+	/// Offset of the part source in the template data
+	size_t offset;
+
+	/// Length of the part source in the template data
+	size_t length;
+
+	/// true if this part has sources, false if it is a placeholder
+	bool specified;
+};
+
+/**
+ * @brief Shader template embedded in a program, split into parts at build time
+ *
+ * See shader_template#from_embedded.
+ */
+struct embedded_template
+{
+	/// Contents of the template file
+	const char *data;
+
+	/// Size of the template file, in bytes
+	size_t size;
+
+	/// Parts of the template, in order
+	const embedded_part *parts;
+
+	/// Number of parts in the template
+	size_t part_count;
+};
+}
+}
+
+#endif /* _SHADERTOY_COMPILER_EMBEDDED_TEMPLATE_HPP_ */
@@ -18,6 +18,12 @@ class shadertoy_EXPORT file_part : public cloneable_part<file_part>
 	/// Source file for this template
 	std::string source_file_;
 
+	/// Cache to read the source file from
+	std::shared_ptr<source_cache> cache_;
+
+	/// Cache created by this part when it has no cache, shared with its clones
+	mutable std::shared_ptr<source_cache> local_cache_;
+
 public:
 	/**
 	 * @brief Initialize a new unspecified file_part
@@ -44,11 +50,39 @@ public:
 	/**
 	 * @brief Obtain this template part's sources
 	 *
+	 * Include directives in the source file are resolved (see source_cache).
+	 * If this part has no cache, it creates one on the first call, so later
+	 * calls only read the source file and its includes again if they changed.
+	 *
 	 * @return Sources for this template part
 	 *
-	 * @throws template_error If this template's source is not defined
+	 * @throws template_error If this template's source is not defined, or it could not be read
+	 */
+	source_list sources() const override;
+
+	/**
+	 * @brief Obtain the source file for this template part
+	 *
+	 * @return Path to the source file, or an empty string if this part is not specified
+	 */
+	inline const std::string &source_file() const
+	{ return source_file_; }
+
+	/**
+	 * @brief Obtain the cache used to read the source file
+	 *
+	 * @return Pointer to the source cache, or null if this part uses its own cache
+	 */
+	inline const std::shared_ptr<source_cache> &cache() const
+	{ return cache_; }
+
+	/**
+	 * @brief Set the cache used to read the source file
+	 *
+	 * @param new_cache Pointer to the source cache, or null to use a cache owned by this part
 	 */
-	std::vector<std::pair<std::string, std::string>> sources() const override;
+	inline void cache(std::shared_ptr<source_cache> new_cache)
+	{ cache_ = std::move(new_cache); }
 };
 }
 }
@@ -47,7 +47,7 @@ public:
 	 *
 	 * @throws template_error If this template's source is not defined
 	 */
-	std::vector<std::pair<std::string, std::string>> sources() const override;
+	source_list sources() const override;
 };
 }
 }
@@ -4,11 +4,15 @@
 #include "shadertoy/pre.hpp"
 
 #include "shadertoy/compiler/define_part.hpp"
+#include "shadertoy/compiler/deferred_program.hpp"
 #include "shadertoy/compiler/shader_template.hpp"
 
 #include "shadertoy/gl/shader.hpp"
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <vector>
 
 namespace shadertoy
 {
@@ -24,6 +28,11 @@ namespace compiler
  */
 class shadertoy_EXPORT program_template
 {
+public:
+	/// Named sources for each shader type of a program
+	typedef std::map<GLenum, source_list> sources_map;
+
+private:
 	/**
 	 * @brief List of shader templates for this program template.
 	 *
@@ -39,6 +48,65 @@ class shadertoy_EXPORT program_template
 	 */
 	std::map<GLenum, gl::shader> compiled_shaders_;
 
+	/**
+	 * @brief Sources of the compiled shaders in the cache
+	 */
+	sources_map compiled_sources_;
+
+	/**
+	 * @brief true if derived programs are built as separable programs
+	 */
+	bool separable_;
+
+	/**
+	 * @brief Separable single-stage programs built from the compiled shaders,
+	 * used when separable_ is true
+	 */
+	std::map<GLenum, gl::program> stage_programs_;
+
+	/**
+	 * @brief true if unreachable code is removed before compiling shaders
+	 */
+	bool prune_sources_;
+
+	/**
+	 * @brief true if shaders are compiled to SPIR-V modules
+	 */
+	bool spirv_;
+
+	/**
+	 * @brief Values of the specialization constants of SPIR-V shaders
+	 */
+	std::map<GLuint, GLuint> specialization_constants_;
+
+	/**
+	 * @brief Cache for compiled SPIR-V modules
+	 */
+	std::shared_ptr<program_cache> module_cache_;
+
+	/**
+	 * @brief Shared library shader, compiled once and linked into every derived
+	 * program using its shader type
+	 */
+	struct library_shader
+	{
+		/// Compiled shader object
+		gl::shader shader;
+
+		/// Sources the shader was compiled from
+		source_list sources;
+
+		/// Declarations of the library, included in the shaders linked with it
+		std::string declarations;
+	};
+
+	/**
+	 * @brief List of shared libraries, for each shader type and by name
+	 */
+	std::map<GLenum, std::map<std::string, library_shader>> libraries_;
+
+	void link_stage_program(GLenum type);
+
 	/**
 	 * @brief List of input objects to bind when creating new programs
 	 */
@@ -49,9 +117,20 @@ class shadertoy_EXPORT program_template
 	 */
 	std::map<std::string, std::shared_ptr<preprocessor_defines>> shader_defines_;
 
-	shader_template specify_template_parts(const shader_template &source_template) const;
+	std::vector<std::unique_ptr<basic_part>> resolve_part(GLenum type, const std::string &part_name, bool with_libraries) const;
+
+	shader_template specify_template_parts(GLenum type, const shader_template &source_template) const;
+
+	shader_template specify_template_parts(GLenum type, std::vector<std::unique_ptr<basic_part>> parts, const shader_template &source_template) const;
 
-	shader_template specify_template_parts(std::vector<std::unique_ptr<basic_part>> parts, const shader_template &source_template) const;
+	source_list compiled_stage_sources(const source_list &sources) const;
+
+	std::vector<uint32_t> stage_module(GLenum type, const source_list &sources) const;
+
+	void load_shader(gl::shader &so, GLenum type, const source_list &sources) const;
+
+	/// Check if the shared libraries of a stage are attached to a program, given if the stage is compiled for it, or if its pre-compiled shader is attached to it
+	bool links_libraries(bool compiled, bool precompiled) const;
 
 public:
 	/**
@@ -103,6 +182,58 @@ public:
 	 */
 	void compile(GLenum type);
 
+	/**
+	 * @brief Compiles a shared library shader in the cache of this program_template
+	 *
+	 * The library is compiled once from the template of the given type, and
+	 * linked into every program derived from this template which uses this
+	 * shader type. This avoids recompiling code shared by many programs, such
+	 * as the Common tab of a Shadertoy, for every one of them.
+	 *
+	 * The library is compiled from the shader template of type \p type,
+	 * specified with \p parts. The `glsl:main` part of the template is removed,
+	 * and parts that remain unspecified are left empty.
+	 *
+	 * The functions of the library are made visible to derived shaders through
+	 * the `*:libraries` part (or `<name>:libraries` for a single library),
+	 * which is replaced with the sources of \p parts with function bodies
+	 * removed. Libraries cannot reference each other.
+	 *
+	 * Compiling a library with the same type and name as an existing library
+	 * replaces it. Programs which are already linked are not affected.
+	 *
+	 * @param type  Type of the shader the library is linked with
+	 * @param name  Name of the library
+	 * @param parts Parts specifying the library sources
+	 *
+	 * @throws template_error               The shader template of type \p type was not found
+	 * @throws gl::shader_compilation_error The library failed to compile
+	 */
+	void compile_library(GLenum type, const std::string &name, std::vector<std::unique_ptr<basic_part>> parts);
+
+	/**
+	 * @brief Remove a shared library from this program_template
+	 *
+	 * @param type Type of the shader the library is linked with
+	 * @param name Name of the library
+	 *
+	 * @return true if the library was removed, false if no such library was found
+	 */
+	bool erase_library(GLenum type, const std::string &name);
+
+	/**
+	 * @brief Get all the sources linked into a program built from the given sources
+	 *
+	 * This includes the sources of the shared libraries of this template, and
+	 * should be used to identify the resulting program, e.g. in a program_cache.
+	 *
+	 * @param sources Named sources for each shader type, as returned by
+	 *                program_template#specify_sources
+	 *
+	 * @return Named sources for each shader type, including shared libraries
+	 */
+	sources_map link_sources(const sources_map &sources) const;
+
 	/**
 	 * @brief Compile this program_template into a GL program.
 	 *
@@ -117,6 +248,60 @@ public:
 	 */
 	gl::program compile(std::map<GLenum, std::vector<std::unique_ptr<basic_part>>> parts, std::map<GLenum, std::string> *compiled_sources = nullptr) const;
 
+	/**
+	 * @brief Get the fully specified sources of the program this template would compile.
+	 *
+	 * @param parts Map of specifications for each shader template. This is
+	 *              used to specify missing parts in all templates. Pre-compiled
+	 *              shaders return the sources they were compiled from.
+	 *
+	 * @return Named sources for each shader type of the program
+	 */
+	sources_map specify_sources(std::map<GLenum, std::vector<std::unique_ptr<basic_part>>> parts) const;
+
+	/**
+	 * @brief Get the code compiled for fully specified sources
+	 *
+	 * This is the code compile_sources and submit_sources return in their
+	 * \p compiled_sources map: the sources of pre-compiled shader types are
+	 * skipped, and the others are pruned if prune_sources is enabled.
+	 *
+	 * @param sources Named sources for each shader type, as returned by
+	 *                program_template#specify_sources.
+	 *
+	 * @return Compiled code for each shader type
+	 */
+	std::map<GLenum, std::string> compiled_code(const sources_map &sources) const;
+
+	/**
+	 * @brief Compile fully specified sources into a GL program.
+	 *
+	 * @param sources Named sources for each shader type, as returned by
+	 *                program_template#specify_sources. Shader types which are
+	 *                pre-compiled use the cached shader object instead.
+	 *
+	 * @param[out] compiled_source Optional. Return value for the compiled sources of the program.
+	 *
+	 * @return Compiled program
+	 */
+	gl::program compile_sources(const sources_map &sources, std::map<GLenum, std::string> *compiled_sources = nullptr) const;
+
+	/**
+	 * @brief Submit fully specified sources for compilation without waiting for the result.
+	 *
+	 * The returned deferred_program references the pre-compiled shaders of
+	 * this template, which must remain alive until deferred_program#get is called.
+	 *
+	 * @param sources Named sources for each shader type, as returned by
+	 *                program_template#specify_sources. Shader types which are
+	 *                pre-compiled use the cached shader object instead.
+	 *
+	 * @param[out] compiled_source Optional. Return value for the compiled sources of the program.
+	 *
+	 * @return Program being compiled
+	 */
+	deferred_program submit_sources(const sources_map &sources, std::map<GLenum, std::string> *compiled_sources = nullptr) const;
+
 	/**
 	 * @brief Compile the given fully specified templates into a GL program.
 	 *
@@ -129,6 +314,128 @@ public:
 	 */
 	gl::program compile(const std::map<GLenum, shader_template> &templates, std::map<GLenum, std::string> *compiled_sources = nullptr) const;
 
+	/**
+	 * @brief Check if derived programs are built as separable programs
+	 *
+	 * @return true if separable programs are built, false otherwise
+	 */
+	inline bool separable() const
+	{ return separable_; }
+
+	/**
+	 * @brief Set if derived programs should be built as separable programs
+	 *
+	 * In separable mode, pre-compiled shaders are linked once into their own
+	 * separable program (see program_template#stage_programs) instead of being
+	 * linked into every derived program. Derived programs only contain the
+	 * remaining stages, and must be combined with the stage programs using a
+	 * gl::program_pipeline. buffers::program_buffer does this automatically.
+	 *
+	 * @param new_separable true to build separable programs, false otherwise
+	 */
+	void separable(bool new_separable);
+
+	/**
+	 * @brief Get the separable programs built from the pre-compiled shaders
+	 *
+	 * This is empty unless program_template#separable is true.
+	 *
+	 * @return Reference to the map of shader types to their separable program
+	 */
+	inline const std::map<GLenum, gl::program> &stage_programs() const
+	{ return stage_programs_; }
+
+	/**
+	 * @brief Check if unreachable code is removed before compiling shaders
+	 *
+	 * @return true if sources are pruned, false otherwise
+	 */
+	inline bool prune_sources() const
+	{ return prune_sources_; }
+
+	/**
+	 * @brief Set if unreachable code should be removed before compiling shaders
+	 *
+	 * When enabled, functions and global constants which are not reachable
+	 * from the entry point of a shader are removed from its fully specified
+	 * sources before they are submitted to the driver (see
+	 * compiler::source_pruner). Shared libraries are never pruned. This only
+	 * applies to shaders compiled after this call.
+	 *
+	 * @param new_prune_sources true to prune sources, false otherwise
+	 */
+	inline void prune_sources(bool new_prune_sources)
+	{ prune_sources_ = new_prune_sources; }
+
+	/**
+	 * @brief Check if shaders are compiled to SPIR-V modules
+	 *
+	 * @return true if SPIR-V modules are used, false if GLSL sources are
+	 *         given to the driver
+	 */
+	inline bool spirv() const
+	{ return spirv_; }
+
+	/**
+	 * @brief Set if shaders should be compiled to SPIR-V modules
+	 *
+	 * When enabled, fully specified sources are compiled and optimized by
+	 * spirv_compiler, and loaded into shader objects using glShaderBinary and
+	 * glSpecializeShader instead of glShaderSource. Since GLSL and SPIR-V
+	 * shaders cannot be linked together, shared libraries are linked into the
+	 * SPIR-V module of every shader using them, and pre-compiled shaders are
+	 * recompiled when this setting changes.
+	 *
+	 * If SPIR-V is not supported (see spirv_compiler#supported), or if the
+	 * driver does not reflect the uniform names of SPIR-V programs (see
+	 * spirv_compiler#reflects_names), a warning is logged and GLSL sources
+	 * keep being used.
+	 *
+	 * @param new_spirv true to use SPIR-V modules, false otherwise
+	 */
+	void spirv(bool new_spirv);
+
+	/**
+	 * @brief Get the values of the specialization constants of SPIR-V shaders
+	 *
+	 * Keys are the `constant_id` of the constants, values are their bit
+	 * pattern (e.g. use a bit cast for `float` constants). Specializing does
+	 * not recompile the SPIR-V modules, so this is cheaper than changing
+	 * preprocessor definitions. Changes apply to programs compiled afterwards,
+	 * and are ignored unless program_template#spirv is true.
+	 *
+	 * @return Reference to the specialization constant values
+	 */
+	inline std::map<GLuint, GLuint> &specialization_constants()
+	{ return specialization_constants_; }
+
+	/**
+	 * @brief Get the values of the specialization constants of SPIR-V shaders
+	 *
+	 * @return Reference to the specialization constant values
+	 */
+	inline const std::map<GLuint, GLuint> &specialization_constants() const
+	{ return specialization_constants_; }
+
+	/**
+	 * @brief Get the cache used for compiled SPIR-V modules
+	 *
+	 * @return Pointer to the program_cache instance, or null if modules are always compiled
+	 */
+	inline const std::shared_ptr<program_cache> &module_cache() const
+	{ return module_cache_; }
+
+	/**
+	 * @brief Set the cache used for compiled SPIR-V modules
+	 *
+	 * SPIR-V modules do not depend on the driver, so this cache directory can
+	 * be populated ahead of time and shipped with an application.
+	 *
+	 * @param new_cache Pointer to the program_cache instance, or null to disable caching
+	 */
+	inline void module_cache(std::shared_ptr<program_cache> new_cache)
+	{ module_cache_ = std::move(new_cache); }
+
 	/**
 	 * @brief Get the list of supported shader inputs
 	 *
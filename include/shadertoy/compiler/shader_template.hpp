@@ -4,8 +4,10 @@
 #include "shadertoy/pre.hpp"
 
 #include "shadertoy/compiler/basic_part.hpp"
+#include "shadertoy/compiler/embedded_template.hpp"
 
 #include <deque>
+#include <string_view>
 
 namespace shadertoy
 {
@@ -43,6 +45,8 @@ class shadertoy_EXPORT shader_template
 
 	void check_unique(const std::unique_ptr<basic_part> &part);
 
+	static shader_template parse_source(std::string_view source, const std::string &name_prefix);
+
 public:
 	/**
 	 * @brief Initialize a new empty shader_template
@@ -82,7 +86,7 @@ public:
 	 *
 	 * @throws template_error When some parts are undefined
 	 */
-	std::vector<std::pair<std::string, std::string>> sources() const;
+	source_list sources() const;
 
 	/**
 	 * @brief Find a template part by its name
@@ -227,6 +231,19 @@ public:
 	 * @throws template_error When the template syntax is invalid
 	 */
 	static shader_template parse_file(const std::string &filename);
+
+	/**
+	 * @brief Builds a shader_template from parts split at build time
+	 *
+	 * This does not parse the template source, see the `shadertoy_add_templates`
+	 * CMake function for generating embedded templates.
+	 *
+	 * @param source Embedded template
+	 * @param name   Name to use for anonymous template parts
+	 *
+	 * @return Template made of the parts of \p source
+	 */
+	static shader_template from_embedded(const embedded_template &source, const std::string &name);
 };
 }
 }
@@ -0,0 +1,48 @@
+#ifndef _SHADERTOY_COMPILER_SOURCE_PRUNER_HPP_
+#define _SHADERTOY_COMPILER_SOURCE_PRUNER_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/compiler/basic_part.hpp"
+
+namespace shadertoy
+{
+namespace compiler
+{
+
+/**
+ * @brief GLSL pre-pass removing code which is not reachable from the entry point
+ *
+ * The sources of a shader are tokenized and split into global declarations.
+ * Function definitions and global constants (`const` declarations) which are
+ * not reachable from `main` or `mainImage` are removed, so the driver front
+ * end does not have to parse and type-check them.
+ *
+ * The analysis is conservative: identifiers used in preprocessor directives or
+ * in other global declarations (uniforms, structs, etc.) are considered used,
+ * declarations spanning preprocessor directives are never removed, and
+ * overloads of a function are kept or removed together.
+ *
+ * Removed code is replaced with its line breaks, so every source keeps its
+ * line count and shader_compiler still maps errors to the original part.
+ */
+class shadertoy_EXPORT source_pruner
+{
+public:
+	/**
+	 * @brief Remove unreachable functions and constants from the sources of a shader
+	 *
+	 * Sources without a `main` function definition, such as shared libraries,
+	 * are returned unchanged.
+	 *
+	 * @param sources Sources of the shader, in compilation order
+	 *
+	 * @return Pruned sources. Sources which were not modified are shared with
+	 *         \p sources.
+	 */
+	static source_list prune(const source_list &sources);
+};
+}
+}
+
+#endif /* _SHADERTOY_COMPILER_SOURCE_PRUNER_HPP_ */
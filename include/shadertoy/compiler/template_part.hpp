@@ -15,8 +15,8 @@ namespace compiler
  */
 class shadertoy_EXPORT template_part : public cloneable_part<template_part>
 {
-	/// Sources for this template part, with their names
-	std::vector<std::pair<std::string, std::string>> sources_;
+	/// Sources for this template part, with their names. Cloning a part only copies the references to its sources.
+	source_list sources_;
 
 	/// true if this template part is specified
 	bool has_sources_;
@@ -45,6 +45,14 @@ public:
 	 */
 	template_part(const std::string &name, std::vector<std::pair<std::string, std::string>> sources);
 
+	/**
+	 * @brief Initialize a new specified template_part
+	 *
+	 * @param name    Name of this template part
+	 * @param sources Shared sources for this template part
+	 */
+	template_part(const std::string &name, source_list sources);
+
 	/**
 	 * @brief Initialize a new specified template_part
 	 *
@@ -83,7 +91,7 @@ public:
 	 *
 	 * @throws template_error If this template's source is not defined
 	 */
-	std::vector<std::pair<std::string, std::string>> sources() const override;
+	source_list sources() const override;
 };
 }
 }
@@ -217,6 +217,17 @@ class shadertoy_EXPORT draw_state
 	 */
 	inline void enable(GLenum cap, bool enabled = true) { enables_[enable_idx(cap)] = enabled; }
 
+	/**
+	 * Check if a given OpenGL feature is enabled in this state
+	 *
+	 * @param cap OpenGL capability to check
+	 *
+	 * @return true if the feature will be enabled when applying this state
+	 *
+	 * @throw shadertoy::shadertoy_error The given capability is not a known feature of OpenGL
+	 */
+	inline bool enabled(GLenum cap) const { return enables_[enable_idx(cap)]; }
+
 	/**
 	 * @brief Get the current clear color for this buffer
 	 *
@@ -9,6 +9,7 @@
 #include "shadertoy/gl/buffer.hpp"
 #include "shadertoy/gl/framebuffer.hpp"
 #include "shadertoy/gl/program.hpp"
+#include "shadertoy/gl/program_pipeline.hpp"
 #include "shadertoy/gl/query.hpp"
 #include "shadertoy/gl/renderbuffer.hpp"
 #include "shadertoy/gl/sampler.hpp"
@@ -63,6 +63,40 @@ namespace gl
 		 * @throws null_buffer_error
 		 */
 		void data(GLsizei size, const void *data, GLenum usage) const;
+
+		/**
+		 * @brief glNamedBufferStorage
+		 * @param size  size of the immutable storage of the buffer
+		 * @param data  pointer to the initial data of the buffer, or null
+		 * @param flags GL storage flags for this buffer
+		 *
+		 * @throws opengl_error
+		 * @throws null_buffer_error
+		 */
+		void storage(GLsizeiptr size, const void *data, GLbitfield flags) const;
+
+		/**
+		 * @brief glMapNamedBufferRange
+		 * @param offset offset of the range to map
+		 * @param length length of the range to map
+		 * @param access GL access flags for the mapping
+		 *
+		 * @return Pointer to the mapped range
+		 *
+		 * @throws opengl_error
+		 * @throws null_buffer_error
+		 */
+		void *map_range(GLintptr offset, GLsizeiptr length, GLbitfield access) const;
+
+		/**
+		 * @brief glUnmapNamedBuffer
+		 *
+		 * @return GL_FALSE if the buffer contents were corrupted while mapped
+		 *
+		 * @throws opengl_error
+		 * @throws null_buffer_error
+		 */
+		GLboolean unmap() const;
 	};
 }
 }
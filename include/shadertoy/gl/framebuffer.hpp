@@ -75,6 +75,29 @@ namespace gl
 		 * @param renderbuffer       Renderbuffer
 		 */
 		void framebuffer_renderbuffer(GLenum attachment, GLenum renderbuffertarget, const renderbuffer &renderbuffer) const;
+
+		/**
+		 * @brief glBlitNamedFramebuffer
+		 *
+		 * Copies a block of pixels from this framebuffer to the given draw framebuffer.
+		 *
+		 * @param draw_framebuffer Name of the destination framebuffer (0 for the default framebuffer)
+		 * @param src_x0           Source rectangle left bound
+		 * @param src_y0           Source rectangle bottom bound
+		 * @param src_x1           Source rectangle right bound
+		 * @param src_y1           Source rectangle top bound
+		 * @param dst_x0           Destination rectangle left bound
+		 * @param dst_y0           Destination rectangle bottom bound
+		 * @param dst_x1           Destination rectangle right bound
+		 * @param dst_y1           Destination rectangle top bound
+		 * @param mask             Buffers to copy
+		 * @param filter           Interpolation to apply if the image is stretched
+		 *
+		 * @throws opengl_error
+		 */
+		void blit(GLuint draw_framebuffer, GLint src_x0, GLint src_y0, GLint src_x1, GLint src_y1,
+				  GLint dst_x0, GLint dst_y0, GLint dst_x1, GLint dst_y1, GLbitfield mask,
+				  GLenum filter) const;
 	};
 
 	template<>
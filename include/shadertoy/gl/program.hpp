@@ -509,6 +509,37 @@ namespace gl
 		 */
 		void link() const;
 
+		/**
+		 * @brief glProgramParameteri
+		 *
+		 * @param pname Parameter name to set
+		 * @param value Value of the parameter
+		 *
+		 * @throws opengl_error
+		 * @throws null_program_error
+		 */
+		void parameter(GLenum pname, GLint value) const;
+
+		/**
+		 * @brief glLinkProgram
+		 *
+		 * Submits the program for linking without querying its status. The
+		 * status must be checked using program#check_link.
+		 *
+		 * @throws opengl_error
+		 */
+		void link_deferred() const;
+
+		/**
+		 * @brief Check the link status of this program
+		 *
+		 * This waits for the linking to complete.
+		 *
+		 * @throws opengl_error
+		 * @throws ProgramLinkError
+		 */
+		void check_link() const;
+
 		/**
 		 * @brief glUseProgram
 		 *
@@ -599,6 +630,22 @@ namespace gl
 		 */
 		void get_binary(GLsizei bufsize, GLsizei *length, GLenum *binaryFormat, void *binary) const;
 
+		/**
+		 * @brief glProgramBinary
+		 *
+		 * Loads a program binary into this program. The link status must be
+		 * checked by the caller, since drivers may reject binaries they
+		 * previously produced.
+		 *
+		 * @param binaryFormat Program binary format
+		 * @param binary       Program binary
+		 * @param length       Program binary length
+		 *
+		 * @throws opengl_error
+		 * @throws null_program_error
+		 */
+		void binary(GLenum binaryFormat, const void *binary, GLsizei length) const;
+
 		/**
 		 * @brief glGetProgramInterfaceiv
 		 *
@@ -0,0 +1,161 @@
+#ifndef _SHADERTOY_GL_PROGRAM_PIPELINE_HPP_
+#define _SHADERTOY_GL_PROGRAM_PIPELINE_HPP_
+
+#include "shadertoy/gl/resource.hpp"
+
+namespace shadertoy
+{
+namespace gl
+{
+	/**
+	 * @brief Error thrown when an attempt is made to dereference a null program pipeline.
+	 */
+	class shadertoy_EXPORT null_program_pipeline_error : public shadertoy::shadertoy_error
+	{
+	public:
+		/**
+		 * @brief Initialize a new instance of the null_program_pipeline_error class.
+		 */
+		explicit null_program_pipeline_error();
+	};
+
+	/**
+	 * @brief Error thrown when the validation step of a program pipeline fails.
+	 */
+	class shadertoy_EXPORT program_pipeline_validate_error : public shadertoy::shadertoy_error
+	{
+	public:
+		/**
+		 * @brief Initialize a new instance of the program_pipeline_validate_error class.
+		 *
+		 * @param  pipelineId OpenGL resource id of the failed pipeline
+		 * @param  log        Contents of the validate step log
+		 */
+		explicit program_pipeline_validate_error(GLuint pipelineId, std::string log);
+
+		/**
+		 * @brief Get the pipeline id of the failed validation step.
+		 *
+		 * @return Id of the pipeline that failed the validation step.
+		 */
+		GLuint pipeline_id() const
+		{ return pipeline_id_; }
+
+		/**
+		 * @brief Get the log of the validation step.
+		 *
+		 * @return Contents of the pipeline validation log.
+		 */
+		const std::string &log() const
+		{ return log_; }
+
+	private:
+		/// Pipeline id
+		const GLuint pipeline_id_;
+
+		/// Pipeline validation log
+		const std::string log_;
+	};
+
+	/**
+	 * @brief Represents an OpenGL program pipeline object.
+	 *
+	 * Program pipelines combine separable programs (see GL_PROGRAM_SEPARABLE)
+	 * for the different shader stages without linking them together.
+	 */
+	class shadertoy_EXPORT program_pipeline : public resource<
+		program_pipeline,
+		multi_allocator<&glCreateProgramPipelines, &glDeleteProgramPipelines>,
+		null_program_pipeline_error>
+	{
+	public:
+		program_pipeline() : resource() {}
+		program_pipeline(resource_type &&other) : resource(std::forward<resource_type &&>(other)) {}
+		resource_type &operator=(resource_type &&other) { return assign_operator(std::forward<resource_type &&>(other)); }
+
+		/**
+		 * @brief Get the stage bit corresponding to a shader type
+		 *
+		 * @param shader_type Type of the shader (i.e. GL_VERTEX_SHADER)
+		 *
+		 * @return Stage bit for glUseProgramStages (i.e. GL_VERTEX_SHADER_BIT)
+		 *
+		 * @throws shadertoy_error The shader type is not known
+		 */
+		static GLbitfield stage_bit(GLenum shader_type);
+
+		/**
+		 * @brief glBindProgramPipeline
+		 *
+		 * Note that the pipeline is only used for rendering if no program
+		 * is currently in use (see program#use).
+		 *
+		 * @throws opengl_error
+		 * @throws null_program_pipeline_error
+		 */
+		void bind() const;
+
+		/**
+		 * @brief glBindProgramPipeline
+		 *
+		 * Unbinds the current program pipeline.
+		 *
+		 * @throws opengl_error
+		 */
+		void unbind() const;
+
+		/**
+		 * @brief glUseProgramStages
+		 *
+		 * @param stages  Stages of \p program to use in this pipeline
+		 * @param program Separable program to use
+		 *
+		 * @throws opengl_error
+		 * @throws null_program_pipeline_error
+		 * @throws null_program_error
+		 */
+		void use_program_stages(GLbitfield stages, const program &program) const;
+
+		/**
+		 * @brief glActiveShaderProgram
+		 *
+		 * @param program Program to use for glUniform calls
+		 *
+		 * @throws opengl_error
+		 * @throws null_program_pipeline_error
+		 * @throws null_program_error
+		 */
+		void active_shader_program(const program &program) const;
+
+		/**
+		 * @brief glValidateProgramPipeline
+		 *
+		 * @throws opengl_error
+		 * @throws program_pipeline_validate_error
+		 */
+		void validate() const;
+
+		/**
+		 * @brief glGetProgramPipelineiv
+		 *
+		 * @param pname  Parameter name
+		 * @param params Parameters
+		 *
+		 * @throws opengl_error
+		 * @throws null_program_pipeline_error
+		 */
+		void get(GLenum pname, GLint *params) const;
+
+		/**
+		 * @brief glGetProgramPipelineInfoLog
+		 *
+		 * @return Contents of the information log
+		 *
+		 * @throws opengl_error
+		 */
+		std::string log() const;
+	};
+}
+}
+
+#endif /* _SHADERTOY_GL_PROGRAM_PIPELINE_HPP_ */
@@ -123,6 +123,44 @@ namespace gl
 		 */
 		void source(const std::vector<std::string> &string) const;
 
+		/**
+		 * @brief glShaderSource
+		 *
+		 * @param string List of null-terminated sources to add to the shader
+		 *
+		 * @throws opengl_error
+		 * @throws null_shader_error
+		 */
+		void source(const std::vector<const char *> &string) const;
+
+		/**
+		 * @brief glShaderBinary
+		 *
+		 * @param binary_format Format of the binary, e.g. GL_SHADER_BINARY_FORMAT_SPIR_V
+		 * @param binary        Pointer to the binary data
+		 * @param length        Length of the binary data, in bytes
+		 *
+		 * @throws opengl_error
+		 * @throws null_shader_error
+		 */
+		void binary(GLenum binary_format, const void *binary, GLsizei length) const;
+
+		/**
+		 * @brief glSpecializeShader
+		 *
+		 * Specializes a SPIR-V shader loaded with shader#binary. The result
+		 * must be checked using shader#check_compile.
+		 *
+		 * @param entry_point Name of the entry point of the shader module
+		 * @param count       Number of specialization constants
+		 * @param indices     Identifiers of the specialization constants
+		 * @param values      Values of the specialization constants
+		 *
+		 * @throws opengl_error
+		 * @throws null_shader_error
+		 */
+		void specialize(const char *entry_point, GLuint count, const GLuint *indices, const GLuint *values) const;
+
 		/**
 		 * @brief glCompileShader
 		 *
@@ -132,6 +170,29 @@ namespace gl
 		 */
 		void compile() const;
 
+		/**
+		 * @brief glCompileShader
+		 *
+		 * Submits the shader for compilation without querying its status, so
+		 * drivers with background compiler threads do not have to wait for
+		 * completion. The status must be checked using shader#check_compile.
+		 *
+		 * @throws opengl_error
+		 * @throws null_shader_error
+		 */
+		void compile_deferred() const;
+
+		/**
+		 * @brief Check the compilation status of this shader
+		 *
+		 * This waits for the compilation to complete.
+		 *
+		 * @throws opengl_error
+		 * @throws ShaderCompilationError
+		 * @throws null_shader_error
+		 */
+		void check_compile() const;
+
 		/**
 		 * @brief glGetShaderInfoLog
 		 *
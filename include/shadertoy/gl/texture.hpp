@@ -162,6 +162,55 @@ namespace gl
 		void image_2d(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
 					  GLint border, GLenum format, GLenum type, const GLvoid *data) const;
 
+		/**
+		 * @brief glTextureSubImage2D
+		 *
+		 * @param level   Level
+		 * @param xoffset X offset
+		 * @param yoffset Y offset
+		 * @param width   Width
+		 * @param height  Height
+		 * @param format  Format
+		 * @param type    Type
+		 * @param data    Data, or offset in the bound GL_PIXEL_UNPACK_BUFFER
+		 *
+		 * @throws opengl_error
+		 * @throws null_texture_error
+		 */
+		void sub_image_2d(GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+						  GLenum format, GLenum type, const GLvoid *data) const;
+
+		/**
+		 * @brief glTextureStorage2D
+		 *
+		 * @param levels         Number of levels
+		 * @param internalFormat Internal format
+		 * @param width          Width
+		 * @param height         Height
+		 *
+		 * @throws opengl_error
+		 * @throws null_texture_error
+		 */
+		void storage_2d(GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height) const;
+
+		/**
+		 * @brief glCompressedTextureSubImage2D
+		 *
+		 * @param level     Level
+		 * @param xoffset   X offset
+		 * @param yoffset   Y offset
+		 * @param width     Width
+		 * @param height    Height
+		 * @param format    Compressed format
+		 * @param imageSize Size of the compressed data
+		 * @param data      Data, or offset in the bound GL_PIXEL_UNPACK_BUFFER
+		 *
+		 * @throws opengl_error
+		 * @throws null_texture_error
+		 */
+		void compressed_sub_image_2d(GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+									 GLenum format, GLsizei imageSize, const GLvoid *data) const;
+
 		/**
 		 * @brief glGenerateTextureMipmap
 		 *
@@ -3,6 +3,8 @@
 
 #include "shadertoy/pre.hpp"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace shadertoy
@@ -23,6 +25,20 @@ class shadertoy_EXPORT basic_input
 	/// true if this input has been loaded
 	bool loaded_;
 
+	/// Budget this input is accounted in, see texture_budget#track
+	std::weak_ptr<texture_budget> budget_;
+
+	/// Frame number of the budget when this input was last used
+	uint64_t last_use_frame_;
+
+	/// Texture returned by the last use of this input
+	gl::texture *last_texture_;
+
+	/// Size in bytes of last_texture_, only measured when tracked by a budget
+	size_t texture_bytes_;
+
+	friend class shadertoy::texture_budget;
+
 protected:
 	/**
 	 * @brief Load this input's contents.
@@ -80,7 +96,9 @@ public:
 	/**
 	 * @brief Use this input for a rendering pass.
 	 *
-	 * If the input has not yet been loaded, it will be loaded.
+	 * If the input has not yet been loaded, it will be loaded. If the input
+	 * is tracked by a texture_budget, this records the current frame of the
+	 * budget as the last use of this input.
 	 *
 	 * @return Pointer to the texture object for this input. The pointer is
 	 * guaranteed to be valid as long as the basic_input instance exists and is
@@ -89,6 +107,32 @@ public:
 	 */
 	gl::texture *use();
 
+	/**
+	 * @brief Check if this input has been loaded
+	 *
+	 * @return true if this input has been loaded, false otherwise
+	 */
+	inline bool loaded() const { return loaded_; }
+
+	/**
+	 * @brief Get the frame this input was last used at
+	 *
+	 * @return Frame number of the texture_budget tracking this input, when it
+	 *         was last used
+	 */
+	inline uint64_t last_use_frame() const { return last_use_frame_; }
+
+	/**
+	 * @brief Obtain the texture returned by the last use of this input
+	 *
+	 * Unlike basic_input#use, this neither loads the input nor updates its
+	 * contents.
+	 *
+	 * @return Pointer to the texture object, or null if the input has not
+	 *         been used since it was loaded
+	 */
+	inline gl::texture *current_texture() const { return last_texture_; }
+
 	/**
 	 * @brief Obtain the sampler object for this input
 	 *
@@ -0,0 +1,46 @@
+#ifndef _SHADERTOY_INPUTS_DECODED_IMAGE_HPP_
+#define _SHADERTOY_INPUTS_DECODED_IMAGE_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include <array>
+#include <vector>
+
+namespace shadertoy
+{
+namespace inputs
+{
+
+/**
+ * @brief Image decoded in client memory, ready to be uploaded to a texture
+ *
+ * Decoders produce this without using the OpenGL context, so decoding can
+ * happen on worker threads (see file_input#decode_pool).
+ */
+struct decoded_image
+{
+	/// Width of the image, in pixels
+	GLsizei width;
+
+	/// Height of the image, in pixels
+	GLsizei height;
+
+	/// Internal format of the texture to create
+	GLint internal_format;
+
+	/// Format of the pixel data
+	GLenum format;
+
+	/// Type of the pixel data
+	GLenum type;
+
+	/// Texture swizzle, for internal formats with less channels than the image
+	std::array<GLint, 4> swizzle{ { GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA } };
+
+	/// Pixel data, with tightly packed rows
+	std::vector<char> pixels;
+};
+}
+}
+
+#endif /* _SHADERTOY_INPUTS_DECODED_IMAGE_HPP_ */
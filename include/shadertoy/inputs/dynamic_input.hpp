@@ -0,0 +1,208 @@
+#ifndef _SHADERTOY_INPUTS_DYNAMIC_INPUT_HPP_
+#define _SHADERTOY_INPUTS_DYNAMIC_INPUT_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/inputs/basic_input.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace shadertoy
+{
+namespace inputs
+{
+
+/**
+ * @brief Represents an input whose contents are written by the application
+ *
+ * Frames are written by a producer, on any thread, directly into a ring of
+ * persistently mapped pixel unpack buffers: dynamic_input#map_next returns the
+ * memory of a free buffer, and dynamic_input#commit publishes it. The next
+ * time the input is used, the latest committed frame is copied from its
+ * buffer to the texture of the input, and a fence marks the buffer as free
+ * once the copy completes. This avoids both the copy of the pixels by the
+ * driver and the implicit synchronization of glTexSubImage2D with client
+ * memory.
+ *
+ * Frames are tightly packed rows of the given format and type, starting with
+ * the bottom row. When a frame is committed before the previous one is
+ * uploaded, the previous one is dropped.
+ *
+ * Only one frame may be mapped at a time. The input must be loaded (see
+ * basic_input#load), on the rendering thread, before frames can be mapped.
+ */
+class shadertoy_EXPORT dynamic_input : public basic_input
+{
+	/// State of a buffer of the ring
+	enum class slot_state
+	{
+		/// Available to the producer
+		free,
+		/// Mapped by the producer
+		writing,
+		/// Committed, waiting to be uploaded
+		ready,
+		/// Being copied to the texture
+		uploading,
+	};
+
+	/// Buffer of the ring
+	struct slot
+	{
+		/// Current state, protected by mutex_
+		slot_state state;
+
+		/// Fence signaled when the copy completes, only used on the rendering thread
+		GLsync fence;
+	};
+
+	/// Size of the frames
+	rsize size_;
+
+	/// Internal format of the texture
+	GLenum internal_format_;
+
+	/// Format of the frames
+	GLenum format_;
+
+	/// Type of the frames
+	GLenum type_;
+
+	/// Number of buffers in the ring
+	size_t buffer_count_;
+
+	/// Size in bytes of a frame
+	size_t frame_bytes_;
+
+	/// Offset between buffers in the ring
+	size_t buffer_stride_;
+
+	/// Texture holding the latest uploaded frame
+	std::unique_ptr<gl::texture> texture_;
+
+	/// Storage of the ring
+	std::unique_ptr<gl::buffer> ring_;
+
+	/// Persistent mapping of ring_
+	char *mapped_;
+
+	/// Buffers of the ring
+	std::vector<slot> slots_;
+
+	/// Mutex protecting the slot states
+	std::mutex mutex_;
+
+	/// Index of the buffer mapped by the producer, or buffer_count_
+	size_t writing_;
+
+	/// Number of uploaded frames
+	std::atomic<size_t> uploaded_frames_;
+
+	/// Number of frames replaced before being uploaded
+	std::atomic<size_t> dropped_frames_;
+
+	/// Release the buffers whose copy completed, on the rendering thread
+	void poll_fences(bool wait);
+
+protected:
+	/**
+	 * @brief Load the input's contents.
+	 *
+	 * This allocates the texture and maps the buffer ring.
+	 */
+	void load_input() override;
+
+	/**
+	 * @brief Reset the input's contents.
+	 *
+	 * This waits for pending copies and unmaps the buffer ring. No frame may
+	 * be mapped when the input is reset.
+	 */
+	void reset_input() override;
+
+	/**
+	 * @brief Obtain this input's texture object.
+	 *
+	 * This copies the latest committed frame to the texture.
+	 *
+	 * @return Pointer to the texture object for this input
+	 */
+	gl::texture *use_input() override;
+
+public:
+	/**
+	 * @brief Initialize a new instance of the dynamic_input class
+	 *
+	 * @param size            Size of the frames
+	 * @param internal_format Internal format of the texture
+	 * @param format          Format of the frames
+	 * @param type            Type of the frames
+	 * @param buffer_count    Number of buffers in the ring, at least 2
+	 */
+	dynamic_input(rsize size, GLenum internal_format = GL_RGBA8, GLenum format = GL_RGBA,
+				  GLenum type = GL_UNSIGNED_BYTE, size_t buffer_count = 3);
+
+	/**
+	 * @brief Wait for pending copies and release the buffer ring
+	 */
+	~dynamic_input() override;
+
+	dynamic_input(const dynamic_input &) = delete;
+	dynamic_input &operator=(const dynamic_input &) = delete;
+
+	/**
+	 * @brief Map the next free buffer of the ring
+	 *
+	 * This may be called on any thread, and does not block. The frame is
+	 * written to the returned memory, then published using
+	 * dynamic_input#commit.
+	 *
+	 * @return Pointer to dynamic_input#frame_bytes bytes of GPU-visible
+	 *         memory, or null if the input is not loaded or all the buffers
+	 *         are in use
+	 */
+	void *map_next();
+
+	/**
+	 * @brief Publish the frame written to the buffer returned by dynamic_input#map_next
+	 *
+	 * This may be called on any thread. The frame is uploaded the next time
+	 * the input is used.
+	 */
+	void commit();
+
+	/**
+	 * @brief Obtain the size of the frames
+	 *
+	 * @return Size of the frames
+	 */
+	inline const rsize &size() const { return size_; }
+
+	/**
+	 * @brief Obtain the size in bytes of a frame
+	 *
+	 * @return Size in bytes of the memory returned by dynamic_input#map_next
+	 */
+	inline size_t frame_bytes() const { return frame_bytes_; }
+
+	/**
+	 * @brief Obtain the number of frames uploaded to the texture
+	 *
+	 * @return Number of uploaded frames
+	 */
+	inline size_t uploaded_frames() const { return uploaded_frames_; }
+
+	/**
+	 * @brief Obtain the number of frames which were not uploaded
+	 *
+	 * @return Number of committed frames replaced by a newer frame before
+	 *         being uploaded
+	 */
+	inline size_t dropped_frames() const { return dropped_frames_; }
+};
+}
+}
+
+#endif /* _SHADERTOY_INPUTS_DYNAMIC_INPUT_HPP_ */
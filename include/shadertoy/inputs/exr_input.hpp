@@ -13,9 +13,18 @@ namespace inputs
 /**
  * @brief Represents an input that is loaded from a file
  *        using the OpenEXR library.
+ *
+ * Only the channels present in the selected layer are read: R, G, B and A,
+ * Y and A, or up to four arbitrary channels in name order. The texture uses
+ * 32-bit floats if any of them is stored as float (or unsigned int), half
+ * floats otherwise. Scanline blocks and tiles are decoded on the OpenEXR
+ * thread pool.
  */
 class shadertoy_EXPORT exr_input : public file_input
 {
+	/// Name of the layer to load, or empty for the default layer
+	std::string layer_;
+
 protected:
 	/**
 	 * @brief Load the image from filename
@@ -28,6 +37,13 @@ protected:
 	std::unique_ptr<gl::texture> load_file(const std::string &filename, bool vflip) override;
 
 public:
+	/**
+	 * @brief Get the function decoding images for this input type
+	 *
+	 * @return Decoder function, or null if support for this input type is disabled
+	 */
+	decoder_type decoder() const override;
+
 	/**
 	 * @brief Initialize a new instance of the exr_input class
 	 *
@@ -41,8 +57,9 @@ public:
 	 * with a default filename
 	 *
 	 * @param filename Filename to load the image from
+	 * @param layer    Name of the layer to load, or empty for the default layer
 	 */
-	explicit exr_input(const std::string &filename);
+	explicit exr_input(const std::string &filename, std::string layer = std::string());
 
 	/**
 	 * @brief Get a value indicating if this input type is supported
@@ -50,6 +67,26 @@ public:
 	 * @return true if it is supported, false otherwise
 	 */
 	static bool supported();
+
+	/**
+	 * @brief Obtain the name of the layer to load
+	 *
+	 * @return Name of the layer, or an empty string for the default layer
+	 */
+	inline const std::string &layer() const { return layer_; }
+
+	/**
+	 * @brief Set the name of the layer to load
+	 *
+	 * Channels of the layer are named `<layer>.<channel>` in the file, for
+	 * example `diffuse.R` or `depth.Z`.
+	 *
+	 * Note that this method does not invalidate the input contents,
+	 * so reset should be called to trigger a reload step.
+	 *
+	 * @param new_layer Name of the layer, or an empty string for the default layer
+	 */
+	inline void layer(const std::string &new_layer) { layer_ = new_layer; }
 };
 }
 }
@@ -3,8 +3,14 @@
 
 #include "shadertoy/pre.hpp"
 
+#include "shadertoy/inputs/decoded_image.hpp"
 #include "shadertoy/inputs/image_input.hpp"
 
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
 namespace shadertoy
 {
 namespace inputs
@@ -21,7 +27,53 @@ class shadertoy_EXPORT file_input : public image_input
 	/// true if the image should be flipped vertically
 	bool vflip_;
 
+	/// Pool to decode images on, or null to load them on the rendering thread
+	std::shared_ptr<utils::thread_pool> decode_pool_;
+
+	/// Image being decoded on the decode pool
+	std::future<decoded_image> pending_image_;
+
+	/// Internal format override, or 0 to use the format chosen by the decoder
+	GLint internal_format_;
+
 protected:
+	/**
+	 * @brief Upload a decoded image to a new texture
+	 *
+	 * The pixel data is staged in a pixel unpack buffer, so the driver can
+	 * transfer it without stalling the rendering thread.
+	 *
+	 * The texture uses file_input#internal_format if it is set, otherwise the
+	 * internal format chosen by the decoder.
+	 *
+	 * @param image Decoded image
+	 *
+	 * @return Texture holding the first level of the image
+	 */
+	std::unique_ptr<gl::texture> upload_image(const decoded_image &image) const;
+
+	/**
+	 * @brief Account for an uploaded texture in file_input#uploaded_bytes and file_input#saved_bytes
+	 *
+	 * This is called by file_input#upload_image. Input types uploading their
+	 * textures directly should call it for the first level of their image.
+	 *
+	 * @param bytes           Size in bytes of the first level of the texture
+	 * @param width           Width of the image
+	 * @param height          Height of the image
+	 * @param internal_format Internal format of the texture
+	 */
+	static void record_upload(size_t bytes, GLsizei width, GLsizei height, GLint internal_format);
+
+	/**
+	 * @brief Complete the decoding of the image on the decode pool
+	 *
+	 * @param[out] texture Texture holding the decoded image
+	 *
+	 * @return true if the image is still being decoded
+	 */
+	bool poll_image(std::unique_ptr<gl::texture> &texture) override;
+
 	/**
 	 * @brief Load the image from filename
 	 *
@@ -55,6 +107,26 @@ protected:
 	explicit file_input(std::string filename);
 
 	public:
+	/// Function decoding an image file in client memory
+	typedef std::function<decoded_image(const std::string &filename, bool vflip)> decoder_type;
+
+	/**
+	 * @brief Get the function decoding images for this input type
+	 *
+	 * Decoders are called on worker threads, and must not use the OpenGL
+	 * context nor this input: the options they need should be captured by
+	 * value. They report errors by throwing exceptions.
+	 *
+	 * This can be used to decode images without creating textures, for
+	 * example by inputs loading several files of various types.
+	 *
+	 * The default implementation returns null.
+	 *
+	 * @return Decoder function, or null if images can only be loaded on the
+	 *         rendering thread using file_input#load_file
+	 */
+	virtual decoder_type decoder() const;
+
 	/**
 	 * @brief Obtain the filename this input will be loaded from.
 	 *
@@ -88,6 +160,69 @@ protected:
 	 * @param new_vflip New value of the vflip tag
 	 */
 	void vflip(bool new_vflip) { vflip_ = new_vflip; }
+
+	/**
+	 * @brief Obtain the pool images are decoded on
+	 *
+	 * @return Pointer to the decode pool, or null if images are loaded on the rendering thread
+	 */
+	inline const std::shared_ptr<utils::thread_pool> &decode_pool() const { return decode_pool_; }
+
+	/**
+	 * @brief Set the pool images are decoded on
+	 *
+	 * When set, and if the input type provides a decoder (see
+	 * file_input#decoder), loading this input only queues the decoding on
+	 * \p new_pool. The decoded image is uploaded the first time the input is
+	 * used after decoding completed, and a placeholder is used until then.
+	 * Input types without a decoder are still loaded on the rendering thread.
+	 *
+	 * @param new_pool Pointer to the decode pool, or null to load images on the rendering thread
+	 */
+	inline void decode_pool(std::shared_ptr<utils::thread_pool> new_pool) { decode_pool_ = std::move(new_pool); }
+
+	/**
+	 * @brief Obtain the internal format override
+	 *
+	 * @return Internal format of the texture, or 0 if the format is chosen by
+	 *         the decoder
+	 */
+	inline GLint internal_format() const { return internal_format_; }
+
+	/**
+	 * @brief Set the internal format override
+	 *
+	 * Decoders choose the most compact internal format matching the decoded
+	 * data, such as GL_R8 for grayscale JPEG images or GL_R16F for luminance
+	 * EXR images. This allows forcing another format, for example
+	 * GL_SRGB8_ALPHA8 for color images which should be sampled in linear space.
+	 *
+	 * Note that this method does not invalidate the input contents,
+	 * so reset should be called to trigger a reload step.
+	 *
+	 * @param new_internal_format Internal format of the texture, or 0 to let
+	 *                            the decoder choose the format
+	 */
+	inline void internal_format(GLint new_internal_format) { internal_format_ = new_internal_format; }
+
+	/**
+	 * @brief Get the total size of the textures uploaded by file inputs
+	 *
+	 * @return Size in bytes of the first level of all the textures uploaded
+	 *         by file inputs since the program started
+	 */
+	static size_t uploaded_bytes();
+
+	/**
+	 * @brief Get the memory saved by compact internal formats
+	 *
+	 * This compares the textures uploaded by file inputs to GL_RGBA32F
+	 * textures of the same size, which was the format used for all JPEG inputs.
+	 *
+	 * @return Size in bytes saved over all the textures uploaded by file inputs
+	 *         since the program started
+	 */
+	static size_t saved_bytes();
 };
 }
 }
@@ -0,0 +1,69 @@
+#ifndef _SHADERTOY_INPUTS_HDR_INPUT_HPP_
+#define _SHADERTOY_INPUTS_HDR_INPUT_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/inputs/file_input.hpp"
+
+namespace shadertoy
+{
+namespace inputs
+{
+
+/**
+ * @brief Represents an input that is loaded from a Radiance HDR (RGBE)
+ *        file.
+ *
+ * The decoder is built into the library. Run-length encoded and flat
+ * scanlines are supported, in the standard orientations (-Y or +Y, then +X).
+ * Pixels are converted from RGBE to half floats on the decoding thread, and
+ * uploaded to a GL_RGB16F texture.
+ */
+class shadertoy_EXPORT hdr_input : public file_input
+{
+protected:
+	/**
+	 * @brief Load the image from filename
+	 *
+	 * @param filename Filename to load the image from
+	 * @param vflip    true if the image should be flipped vertically while loading
+	 *
+	 * @return OpenGL texture representing the image
+	 */
+	std::unique_ptr<gl::texture> load_file(const std::string &filename, bool vflip) override;
+
+public:
+	/**
+	 * @brief Get the function decoding images for this input type
+	 *
+	 * @return Decoder function
+	 */
+	decoder_type decoder() const override;
+
+	/**
+	 * @brief Initialize a new instance of the hdr_input class
+	 *
+	 * This instance will have no filename setup, therefore it will not load
+	 * any texture.
+	 */
+	hdr_input();
+
+	/**
+	 * @brief Initialize a new instance of the hdr_input class
+	 * with a default filename
+	 *
+	 * @param filename Filename to load the image from
+	 */
+	explicit hdr_input(const std::string &filename);
+
+	/**
+	 * @brief Get a value indicating if this input type is supported
+	 *
+	 * @return true if it is supported, false otherwise
+	 */
+	static bool supported();
+};
+}
+}
+
+#endif /* _SHADERTOY_INPUTS_HDR_INPUT_HPP_ */
@@ -19,14 +19,39 @@ class shadertoy_EXPORT image_input : public basic_input
 	/// Texture object to hold the image data
 	std::unique_ptr<gl::texture> image_texture_;
 
+	/// true while the image is being loaded asynchronously
+	bool pending_;
+
+	/// Texture used in place of the image while it is pending
+	std::unique_ptr<gl::texture> placeholder_;
+
 protected:
 	/**
 	 * @brief Implemented by derived classes to provide the image decoding logic
 	 *
+	 * Derived classes which load images asynchronously return a null texture,
+	 * and provide the result through image_input#poll_image.
+	 *
 	 * @return OpenGL texture representing the image
 	 */
 	virtual std::unique_ptr<gl::texture> load_image() = 0;
 
+	/**
+	 * @brief Implemented by derived classes to complete asynchronous loads
+	 *
+	 * When load_image returns a null texture, this method is called every time
+	 * the input is used, until it returns false. In the meantime, the input is
+	 * rendered as a single transparent black pixel.
+	 *
+	 * The default implementation returns false.
+	 *
+	 * @param[out] texture Loaded texture, set when the load completes. It is
+	 *                     left null if the load failed.
+	 *
+	 * @return true if the image is still loading, false otherwise
+	 */
+	virtual bool poll_image(std::unique_ptr<gl::texture> &texture);
+
 	/**
 	 * @brief Load the input's contents.
 	 *
@@ -51,6 +76,15 @@ protected:
 	 * @brief Initialize a new instance of the image_input class.
 	 */
 	image_input();
+
+public:
+	/**
+	 * @brief Check if the image of this input is still being loaded
+	 *
+	 * @return true if the input is rendered using a placeholder texture
+	 */
+	inline bool pending() const
+	{ return pending_; }
 };
 }
 }
@@ -16,6 +16,9 @@ namespace inputs
  */
 class shadertoy_EXPORT jpeg_input : public file_input
 {
+	/// Minimum size of the largest side of the decoded image, or 0 to decode at full size
+	GLsizei max_dimension_;
+
 protected:
 	/**
 	 * @brief Load the image from filename
@@ -28,6 +31,13 @@ protected:
 	std::unique_ptr<gl::texture> load_file(const std::string &filename, bool vflip) override;
 
 public:
+	/**
+	 * @brief Get the function decoding images for this input type
+	 *
+	 * @return Decoder function, or null if support for this input type is disabled
+	 */
+	decoder_type decoder() const override;
+
 	/**
 	 * @brief Initialize a new instance of the jpeg_input class
 	 *
@@ -50,6 +60,30 @@ public:
 	 * @return true if it is supported, false otherwise
 	 */
 	static bool supported();
+
+	/**
+	 * @brief Obtain the target size of the decoded image
+	 *
+	 * @return Minimum size of the largest side of the decoded image, or 0 if
+	 *         images are decoded at full size
+	 */
+	inline GLsizei max_dimension() const { return max_dimension_; }
+
+	/**
+	 * @brief Set the target size of the decoded image
+	 *
+	 * Images are decoded at 1/2, 1/4 or 1/8 of their size by libjpeg when the
+	 * largest side of the result is still at least \p new_max_dimension
+	 * pixels. This is much faster than decoding at full size when the texture
+	 * is only sampled at a fraction of its size.
+	 *
+	 * Note that this method does not invalidate the input contents,
+	 * so reset should be called to trigger a reload step.
+	 *
+	 * @param new_max_dimension Minimum size of the largest side of the decoded
+	 *                          image, or 0 to decode at full size
+	 */
+	inline void max_dimension(GLsizei new_max_dimension) { max_dimension_ = new_max_dimension; }
 };
 }
 }
@@ -0,0 +1,70 @@
+#ifndef _SHADERTOY_INPUTS_KTX_INPUT_HPP_
+#define _SHADERTOY_INPUTS_KTX_INPUT_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/inputs/file_input.hpp"
+
+namespace shadertoy
+{
+namespace inputs
+{
+
+/**
+ * @brief Represents an input that is loaded from a KTX2 or DDS texture
+ *        container.
+ *
+ * The file is memory-mapped and every mip level it stores is uploaded as is,
+ * without decoding. Block-compressed formats (BC1-BC7, ETC2/EAC) are uploaded
+ * using glCompressedTextureSubImage2D, and common uncompressed 8-bit, 16-bit
+ * float and 32-bit float formats are also supported. Only 2D textures are
+ * supported: cube maps, arrays, volume textures and supercompressed KTX2
+ * files are rejected.
+ *
+ * Since compressed blocks cannot be flipped without decoding them, images are
+ * uploaded in the orientation they are stored in and the vflip flag is
+ * ignored, as is file_input#internal_format. Mipmaps are only generated for
+ * uncompressed images which do not store them, including KTX2 files with a
+ * level count of 0.
+ */
+class shadertoy_EXPORT ktx_input : public file_input
+{
+protected:
+	/**
+	 * @brief Load the image from filename
+	 *
+	 * @param filename Filename to load the image from
+	 * @param vflip    Ignored, containers are uploaded in their stored orientation
+	 *
+	 * @return OpenGL texture representing the image
+	 */
+	std::unique_ptr<gl::texture> load_file(const std::string &filename, bool vflip) override;
+
+public:
+	/**
+	 * @brief Initialize a new instance of the ktx_input class
+	 *
+	 * This instance will have no filename setup, therefore it will not load
+	 * any texture.
+	 */
+	ktx_input();
+
+	/**
+	 * @brief Initialize a new instance of the ktx_input class
+	 * with a default filename
+	 *
+	 * @param filename Filename to load the image from
+	 */
+	explicit ktx_input(const std::string &filename);
+
+	/**
+	 * @brief Get a value indicating if this input type is supported
+	 *
+	 * @return true if it is supported, false otherwise
+	 */
+	static bool supported();
+};
+}
+}
+
+#endif /* _SHADERTOY_INPUTS_KTX_INPUT_HPP_ */
@@ -0,0 +1,68 @@
+#ifndef _SHADERTOY_INPUTS_QOI_INPUT_HPP_
+#define _SHADERTOY_INPUTS_QOI_INPUT_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/inputs/file_input.hpp"
+
+namespace shadertoy
+{
+namespace inputs
+{
+
+/**
+ * @brief Represents an input that is loaded from a QOI ("Quite OK Image")
+ *        file.
+ *
+ * The decoder is built into the library and has no dependency. Pixels are
+ * decoded in a single pass straight into the upload buffer, writing rows in
+ * reverse order when the image is flipped.
+ */
+class shadertoy_EXPORT qoi_input : public file_input
+{
+protected:
+	/**
+	 * @brief Load the image from filename
+	 *
+	 * @param filename Filename to load the image from
+	 * @param vflip    true if the image should be flipped vertically while loading
+	 *
+	 * @return OpenGL texture representing the image
+	 */
+	std::unique_ptr<gl::texture> load_file(const std::string &filename, bool vflip) override;
+
+public:
+	/**
+	 * @brief Get the function decoding images for this input type
+	 *
+	 * @return Decoder function
+	 */
+	decoder_type decoder() const override;
+
+	/**
+	 * @brief Initialize a new instance of the qoi_input class
+	 *
+	 * This instance will have no filename setup, therefore it will not load
+	 * any texture.
+	 */
+	qoi_input();
+
+	/**
+	 * @brief Initialize a new instance of the qoi_input class
+	 * with a default filename
+	 *
+	 * @param filename Filename to load the image from
+	 */
+	explicit qoi_input(const std::string &filename);
+
+	/**
+	 * @brief Get a value indicating if this input type is supported
+	 *
+	 * @return true if it is supported, false otherwise
+	 */
+	static bool supported();
+};
+}
+}
+
+#endif /* _SHADERTOY_INPUTS_QOI_INPUT_HPP_ */
@@ -0,0 +1,316 @@
+#ifndef _SHADERTOY_INPUTS_SEQUENCE_INPUT_HPP_
+#define _SHADERTOY_INPUTS_SEQUENCE_INPUT_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/inputs/basic_input.hpp"
+#include "shadertoy/inputs/decoded_image.hpp"
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace shadertoy
+{
+namespace inputs
+{
+
+/**
+ * @brief Represents an input playing a sequence of image files
+ *
+ * The sequence is given either as a printf-style pattern with a single
+ * integer conversion (e.g. `frames/%04d.jpg`, numbered from 0 or 1), or as a
+ * directory whose image files are played in name order. Frames are decoded
+ * using the decoders of the corresponding file inputs (JPEG, EXR, QOI, HDR,
+ * and SOIL for the other formats).
+ *
+ * Upcoming frames are decoded ahead on the decode pool, into a bounded ring
+ * of sequence_input#ring_size frames. Frames are then uploaded to a single
+ * texture, which is only re-allocated if the frame size or format changes.
+ * When the frame to display is not decoded yet, the previous frame is kept
+ * and the frame is counted in sequence_input#dropped_frames, so rendering
+ * never waits for decoding except for the very first frame.
+ *
+ * The displayed frame is selected from the time set by sequence_input#time,
+ * which is usually the value of iTime, and sequence_input#frame_rate. It can
+ * also be selected explicitly using sequence_input#frame.
+ */
+class shadertoy_EXPORT sequence_input : public basic_input
+{
+	/// Frame of the sequence
+	struct frame_file
+	{
+		/// Filename of the frame
+		std::string filename;
+
+		/// Function decoding the frame
+		std::function<decoded_image(const std::string &filename, bool vflip)> decode;
+	};
+
+	/// Frame being decoded ahead
+	struct frame_slot
+	{
+		/// Index of the frame in the sequence
+		size_t index;
+
+		/// Decoded image
+		std::future<decoded_image> image;
+	};
+
+	/// Pattern or directory of the frames
+	std::string pattern_;
+
+	/// true if the frames should be flipped vertically
+	bool vflip_;
+
+	/// Number of frames per second
+	double frame_rate_;
+
+	/// true if the sequence restarts after its last frame
+	bool loop_;
+
+	/// Number of frames decoded ahead
+	size_t ring_size_;
+
+	/// Current time, in seconds
+	double time_;
+
+	/// Explicit frame index
+	size_t frame_;
+
+	/// true if the frame is selected from time_, false to use frame_
+	bool use_time_;
+
+	/// Pool to decode frames on
+	std::shared_ptr<utils::thread_pool> decode_pool_;
+
+	/// Frames of the sequence, listed when the input is loaded
+	std::vector<frame_file> frames_;
+
+	/// Frames being decoded, in playback order
+	std::deque<frame_slot> ring_;
+
+	/// Texture holding the current frame
+	std::unique_ptr<gl::texture> texture_;
+
+	/// Staging buffer for frame uploads
+	std::unique_ptr<gl::buffer> staging_;
+
+	/// Index of the frame in texture_
+	size_t current_frame_;
+
+	/// Number of frames which were not decoded in time
+	size_t dropped_frames_;
+
+	/// List the frames of the sequence
+	std::vector<frame_file> list_frames() const;
+
+	/// Get the index of the frame following index, or the frame count at the end of the sequence
+	size_t next_frame(size_t index) const;
+
+	/// Queue frames for decoding until the ring is full, starting at first if it is empty
+	void fill_ring(size_t first);
+
+	/// Upload a decoded frame to texture_
+	void upload_frame(const decoded_image &image);
+
+protected:
+	/**
+	 * @brief Load the input's contents.
+	 *
+	 * This lists the frames of the sequence and starts decoding the first
+	 * ones.
+	 */
+	void load_input() override;
+
+	/**
+	 * @brief Reset the input's contents.
+	 */
+	void reset_input() override;
+
+	/**
+	 * @brief Obtain this input's texture object.
+	 *
+	 * This uploads the selected frame if it has been decoded, and queues the
+	 * decoding of the following frames.
+	 *
+	 * @return Pointer to the texture object for this input
+	 */
+	gl::texture *use_input() override;
+
+public:
+	/**
+	 * @brief Initialize a new instance of the sequence_input class
+	 *
+	 * This instance will have no pattern setup, therefore it will not load
+	 * any texture.
+	 */
+	sequence_input();
+
+	/**
+	 * @brief Initialize a new instance of the sequence_input class
+	 *
+	 * @param pattern    printf-style pattern or directory of the frames
+	 * @param frame_rate Number of frames per second
+	 */
+	explicit sequence_input(std::string pattern, double frame_rate = 30.0);
+
+	/**
+	 * @brief Obtain the pattern or directory of the frames
+	 *
+	 * @return Pattern or directory of the frames
+	 */
+	inline const std::string &pattern() const { return pattern_; }
+
+	/**
+	 * @brief Set the pattern or directory of the frames
+	 *
+	 * Note that this method does not invalidate the input contents,
+	 * so reset should be called to trigger a reload step.
+	 *
+	 * @param new_pattern New pattern or directory of the frames
+	 */
+	inline void pattern(const std::string &new_pattern) { pattern_ = new_pattern; }
+
+	/**
+	 * @brief Obtain the vflip flag status
+	 *
+	 * @return true if the frames are flipped on loading
+	 */
+	inline bool vflip() const { return vflip_; }
+
+	/**
+	 * @brief Set the vflip flag
+	 *
+	 * Note that this method does not invalidate the input contents,
+	 * so reset should be called to trigger a reload step.
+	 *
+	 * @param new_vflip New value of the vflip tag
+	 */
+	inline void vflip(bool new_vflip) { vflip_ = new_vflip; }
+
+	/**
+	 * @brief Obtain the frame rate of the sequence
+	 *
+	 * @return Number of frames per second
+	 */
+	inline double frame_rate() const { return frame_rate_; }
+
+	/**
+	 * @brief Set the frame rate of the sequence
+	 *
+	 * @param new_frame_rate Number of frames per second
+	 */
+	inline void frame_rate(double new_frame_rate) { frame_rate_ = new_frame_rate; }
+
+	/**
+	 * @brief Obtain the loop flag status
+	 *
+	 * @return true if the sequence restarts after its last frame
+	 */
+	inline bool loop() const { return loop_; }
+
+	/**
+	 * @brief Set the loop flag
+	 *
+	 * When not looping, the last frame is displayed once the sequence ends.
+	 *
+	 * @param new_loop New value of the loop flag
+	 */
+	inline void loop(bool new_loop) { loop_ = new_loop; }
+
+	/**
+	 * @brief Obtain the number of frames decoded ahead
+	 *
+	 * @return Number of frames decoded ahead
+	 */
+	inline size_t ring_size() const { return ring_size_; }
+
+	/**
+	 * @brief Set the number of frames decoded ahead
+	 *
+	 * This bounds the memory used by decoded frames, and should be large
+	 * enough to absorb variations of the decoding time.
+	 *
+	 * @param new_ring_size Number of frames decoded ahead, at least 1
+	 */
+	void ring_size(size_t new_ring_size);
+
+	/**
+	 * @brief Obtain the current time
+	 *
+	 * @return Current time, in seconds
+	 */
+	inline double time() const { return time_; }
+
+	/**
+	 * @brief Set the current time, and select the frame from the time
+	 *
+	 * @param new_time Current time in seconds, usually the value of iTime
+	 */
+	void time(double new_time);
+
+	/**
+	 * @brief Obtain the index of the frame to display
+	 *
+	 * @return Index of the frame to display, from the time or set by
+	 *         sequence_input#frame(size_t)
+	 */
+	size_t frame() const;
+
+	/**
+	 * @brief Select the frame to display
+	 *
+	 * The frame is selected from the time again when calling
+	 * sequence_input#time(double).
+	 *
+	 * @param new_frame Index of the frame to display
+	 */
+	void frame(size_t new_frame);
+
+	/**
+	 * @brief Obtain the number of frames of the sequence
+	 *
+	 * @return Number of frames, or 0 if the input is not loaded
+	 */
+	inline size_t frame_count() const { return frames_.size(); }
+
+	/**
+	 * @brief Obtain the index of the frame in the texture
+	 *
+	 * @return Index of the frame which is currently displayed
+	 */
+	inline size_t current_frame() const { return current_frame_; }
+
+	/**
+	 * @brief Obtain the number of frames which were not decoded in time
+	 *
+	 * @return Number of times the previous frame was displayed because the
+	 *         selected frame was still being decoded
+	 */
+	inline size_t dropped_frames() const { return dropped_frames_; }
+
+	/**
+	 * @brief Obtain the pool frames are decoded on
+	 *
+	 * @return Pointer to the decode pool
+	 */
+	inline const std::shared_ptr<utils::thread_pool> &decode_pool() const { return decode_pool_; }
+
+	/**
+	 * @brief Set the pool frames are decoded on
+	 *
+	 * If no pool is set when the input is loaded, a pool with a worker thread
+	 * per frame of the ring is created for this input.
+	 *
+	 * @param new_pool Pointer to the decode pool
+	 */
+	inline void decode_pool(std::shared_ptr<utils::thread_pool> new_pool) { decode_pool_ = std::move(new_pool); }
+};
+}
+}
+
+#endif /* _SHADERTOY_INPUTS_SEQUENCE_INPUT_HPP_ */
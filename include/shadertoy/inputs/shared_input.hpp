@@ -0,0 +1,63 @@
+#ifndef _SHADERTOY_INPUTS_SHARED_INPUT_HPP_
+#define _SHADERTOY_INPUTS_SHARED_INPUT_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/inputs/basic_input.hpp"
+
+namespace shadertoy
+{
+namespace inputs
+{
+
+/**
+ * @brief Represents an input sharing the texture of another input
+ *
+ * The texture is loaded and owned by the source input, which is shared by all
+ * the shared_input instances created from it (see utils::texture_cache). Each
+ * instance has its own sampler, so filtering and wrapping can still be
+ * configured per use.
+ *
+ * Resetting a shared_input does not reset its source, since other inputs may
+ * be using it. Use shared_input#source to reload the shared texture.
+ */
+class shadertoy_EXPORT shared_input : public basic_input
+{
+	/// Input owning the shared texture
+	std::shared_ptr<basic_input> source_;
+
+protected:
+	/**
+	 * @brief Load the source input
+	 */
+	void load_input() override;
+
+	/// unused
+	void reset_input() override;
+
+	/**
+	 * @brief Obtain the texture of the source input
+	 *
+	 * @return Pointer to the texture object of the source input
+	 */
+	gl::texture *use_input() override;
+
+public:
+	/**
+	 * @brief Initialize a new instance of the shared_input class
+	 *
+	 * @param source Input owning the shared texture
+	 */
+	explicit shared_input(std::shared_ptr<basic_input> source);
+
+	/**
+	 * @brief Obtain the input owning the shared texture
+	 *
+	 * @return Pointer to the source input
+	 */
+	inline const std::shared_ptr<basic_input> &source() const { return source_; }
+};
+}
+}
+
+#endif /* _SHADERTOY_INPUTS_SHARED_INPUT_HPP_ */
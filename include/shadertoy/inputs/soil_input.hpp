@@ -28,6 +28,13 @@ protected:
 	std::unique_ptr<gl::texture> load_file(const std::string &filename, bool vflip) override;
 
 public:
+	/**
+	 * @brief Get the function decoding images for this input type
+	 *
+	 * @return Decoder function, or null if support for this input type is disabled
+	 */
+	decoder_type decoder() const override;
+
 	/**
 	 * @brief Initialize a new instance of the soil_input class
 	 *
@@ -5,6 +5,8 @@
 
 #include "shadertoy/output_name.hpp"
 
+#include <chrono>
+#include <map>
 #include <memory>
 #include <tuple>
 #include <vector>
@@ -22,6 +24,13 @@ namespace members
  */
 typedef std::tuple<output_name_info_t, gl::texture *> member_output_t;
 
+/**
+ * @brief Clones of swap_chain members, by original member
+ *
+ * @see shadertoy::swap_chain::clone
+ */
+typedef std::map<const basic_member *, std::shared_ptr<basic_member>> member_map_t;
+
 /**
  * @brief Base class for swap_chain members
  */
@@ -46,6 +55,18 @@ protected:
 	 */
 	virtual void init_member(const swap_chain &chain, const render_context &context) = 0;
 
+	/**
+	 * @brief May be implemented by derived classes to start long-running
+	 * initialization work, such as submitting programs for compilation,
+	 * before any member of the swap chain is initialized.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * @param chain   Current swap_chain
+	 * @param context Context to use for initialization
+	 */
+	virtual void prepare_member(const swap_chain &chain, const render_context &context);
+
 	/**
 	 * @brief Must be implemented by derived classes to perform
 	 * texture allocation on size changes
@@ -55,6 +76,18 @@ protected:
 	 */
 	virtual void allocate_member(const swap_chain &chain, const render_context &context) = 0;
 
+	/**
+	 * @brief May be implemented by derived classes to render this member once
+	 * into a scratch target, with the same state, inputs and formats as the
+	 * render step. The result of this render is discarded.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * @param chain   Current swap_chain
+	 * @param context Context to use for rendering
+	 */
+	virtual void warm_up_member(const swap_chain &chain, const render_context &context);
+
 public:
 	/**
 	 * @brief Render this member
@@ -72,6 +105,17 @@ public:
 	 */
 	void init(const swap_chain &chain, const render_context &context);
 
+	/**
+	 * @brief Prepare this member for initialization
+	 *
+	 * swap_chain#init prepares all of its members before initializing them,
+	 * so that work started in this step can proceed concurrently.
+	 *
+	 * @param chain   Current swap_chain being initialized
+	 * @param context Context to use for initialization
+	 */
+	void prepare(const swap_chain &chain, const render_context &context);
+
 	/**
 	 * @brief Allocate the textures for this member
 	 *
@@ -80,6 +124,22 @@ public:
 	 */
 	void allocate(const swap_chain &chain, const render_context &context);
 
+	/**
+	 * @brief Warm up the rendering pipeline of this member
+	 *
+	 * Many drivers finish compiling programs for a given state at the first
+	 * draw call using them. Warming up a member after its textures have been
+	 * allocated moves this cost out of the first rendered frame. This does
+	 * not wait for the GPU to complete the warm-up render, see
+	 * render_context#warm_up.
+	 *
+	 * @param chain   Current swap_chain
+	 * @param context Context to use for rendering
+	 *
+	 * @return Time taken to issue the warm-up render of this member
+	 */
+	std::chrono::nanoseconds warm_up(const swap_chain &chain, const render_context &context);
+
 	/**
 	 * @brief Obtain the output of this member
 	 *
@@ -104,6 +164,33 @@ public:
 	 * @see shadertoy::output_name_t
 	 */
 	virtual int find_output(const output_name_t &name) const;
+
+	/**
+	 * @brief Create a copy of this member, used by swap_chain#clone
+	 *
+	 * The copy has the same configuration as this member, but its own render
+	 * targets. References to other members are updated by
+	 * basic_member#remap_members.
+	 *
+	 * The default implementation throws, derived classes which can be cloned
+	 * should override this method.
+	 *
+	 * @return New member with the same configuration as this one
+	 *
+	 * @throws shadertoy_error This member cannot be cloned
+	 */
+	virtual std::shared_ptr<basic_member> clone() const;
+
+	/**
+	 * @brief Update the references of this member to members of the original chain
+	 *
+	 * This is called on the members returned by basic_member#clone once all
+	 * the members of the chain have been cloned. The default implementation
+	 * does nothing.
+	 *
+	 * @param clones Clones of the members of the original chain
+	 */
+	virtual void remap_members(const member_map_t &clones);
 };
 }
 }
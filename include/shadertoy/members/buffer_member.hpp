@@ -38,8 +38,11 @@ class shadertoy_EXPORT buffer_member : public basic_member
 	/// OpenGL drawing state
 	draw_state state_;
 
-	/// Rendering size for IO resource
-	rsize_ref render_size_;
+	/// Rendering size for IO resource, shared with the clones of this member
+	std::shared_ptr<const size_ref_interface<unsigned int>> render_size_;
+
+	/// Reference to the rendering size, given to the output allocator
+	rsize_ref render_size_ref_;
 
 	/// Default internal format for IO resource
 	GLint internal_format_;
@@ -64,6 +67,14 @@ class shadertoy_EXPORT buffer_member : public basic_member
 	 */
 	void init_member(const swap_chain &chain, const render_context &context) override;
 
+	/**
+	 * @brief Prepare the associated buffer for initialization
+	 *
+	 * @param chain   Current swap_chain
+	 * @param context Context to use for initialization
+	 */
+	void prepare_member(const swap_chain &chain, const render_context &context) override;
+
 	/**
 	 * @brief Allocate the associated buffer's textures
 	 *
@@ -72,6 +83,18 @@ class shadertoy_EXPORT buffer_member : public basic_member
 	 */
 	void allocate_member(const swap_chain &chain, const render_context &context) override;
 
+	/**
+	 * @brief Render the associated buffer to single-pixel targets with the
+	 * formats of its outputs
+	 *
+	 * The depth buffer and render targets of the buffer are restored to the
+	 * outputs of this member afterwards.
+	 *
+	 * @param chain   Current swap_chain
+	 * @param context Context to use for rendering
+	 */
+	void warm_up_member(const swap_chain &chain, const render_context &context) override;
+
 public:
 	/**
 	 * @brief Initialize a new buffer swap chain member
@@ -150,6 +173,24 @@ public:
 	 * @see shadertoy::output_name_t
 	 */
 	int find_output(const output_name_t &name) const override;
+
+	/**
+	 * @brief Create a copy of this member with a clone of its buffer
+	 *
+	 * The clone shares the render size object of this member.
+	 *
+	 * @return New member with the same configuration as this one
+	 *
+	 * @throws shadertoy_error The buffer cannot be cloned
+	 */
+	std::shared_ptr<basic_member> clone() const override;
+
+	/**
+	 * @brief Update the inputs of the buffer of this member
+	 *
+	 * @param clones Clones of the members of the original chain
+	 */
+	void remap_members(const member_map_t &clones) override;
 };
 
 /**
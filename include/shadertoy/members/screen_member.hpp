@@ -7,6 +7,8 @@
 
 #include "shadertoy/draw_state.hpp"
 
+#include <map>
+#include <memory>
 #include <optional>
 
 namespace shadertoy
@@ -56,12 +58,72 @@ class shadertoy_EXPORT screen_member : public basic_member
 	/// Viewport Y
 	int viewport_y_;
 
-	/// Size reference for the viewport call
-	rsize_ref viewport_size_;
+	/// Size reference for the viewport call, shared with the clones of this member
+	std::shared_ptr<const size_ref_interface<unsigned int>> viewport_size_;
+
+	/// Reference to the viewport size, returned by viewport_size()
+	rsize_ref viewport_size_ref_;
 
 	/// OpenGL drawing state
 	draw_state state_;
 
+	/// true if the output can be blitted instead of drawn using the screen program
+	bool allow_blit_;
+
+	/// Texture properties deciding if the output can be blitted to the screen
+	struct blit_info
+	{
+		/// Texture the properties were queried for
+		const gl::texture *texture;
+
+		/// Size of the target viewport
+		rsize vp_size;
+
+		/// Width of the texture
+		GLint width;
+
+		/// Height of the texture
+		GLint height;
+
+		/// Filter to use for the blit, or std::nullopt if the shader path must be used
+		std::optional<GLenum> filter;
+
+		/// Read framebuffer with the texture attached, created on the first blit
+		std::unique_ptr<gl::framebuffer> read_fbo;
+	};
+
+	/// Cached blit decisions, by texture name. Double-buffered outputs
+	/// alternate between two textures, which both keep their entry.
+	std::map<GLuint, blit_info> blit_info_;
+
+	/**
+	 * @brief Determine if the given texture can be blitted to the screen
+	 *
+	 * The blit path is only taken when it gives the same result as the screen
+	 * program: no fragment operations enabled in the draw state, a non-integer
+	 * source format, a single-sampled default framebuffer, and either matching
+	 * sizes or a non-mipmapped sampler filter.
+	 *
+	 * The properties queried from OpenGL are cached for each texture, and only
+	 * queried again when the viewport size or screen_member#allow_blit change,
+	 * or when the swap chain is allocated again.
+	 *
+	 * @param texture Texture to render to the screen
+	 * @param vp_size Size of the target viewport
+	 *
+	 * @return Pointer to the blit properties, or null if the shader path must be used
+	 */
+	const blit_info *blit_filter(const gl::texture &texture, const rsize &vp_size);
+
+	/**
+	 * @brief Find the texture to render to the screen
+	 *
+	 * @param chain Swap chain to pull the output from
+	 *
+	 * @return Pointer to the texture, or null if the requested output was not found
+	 */
+	gl::texture *find_texture(const swap_chain &chain);
+
 protected:
 	/**
 	 * @brief Implement rendering the last swap chain output to the screen
@@ -77,6 +139,16 @@ protected:
 	void allocate_member(const swap_chain &chain, const render_context &context) override;
 	/** @endcond */
 
+	/**
+	 * @brief Render the output to a scratch target using the screen program
+	 *
+	 * Nothing is rendered if the output would be blitted to the screen.
+	 *
+	 * @param chain   Current swap_chain
+	 * @param context Context to use for rendering
+	 */
+	void warm_up_member(const swap_chain &chain, const render_context &context) override;
+
 	/**
 	 * @brief Return the associated output or the latest output in the swap chain
 	 *
@@ -154,6 +226,22 @@ protected:
 	 */
 	std::vector<member_output_t> output() override;
 
+	/**
+	 * @brief Create a copy of this member
+	 *
+	 * The clone shares the viewport size object of this member.
+	 *
+	 * @return New member with the same configuration as this one
+	 */
+	std::shared_ptr<basic_member> clone() const override;
+
+	/**
+	 * @brief Render the clone of the member rendered by this member, if it has one
+	 *
+	 * @param clones Clones of the members of the original chain
+	 */
+	void remap_members(const member_map_t &clones) override;
+
 	/**
 	 * @brief  Obtain the output name for this input
 	 *
@@ -171,6 +259,10 @@ protected:
 	/**
 	 * @brief Obtain a reference to the sampler object of this member
 	 *
+	 * The sampler filters decide if the output can be blitted to the screen.
+	 * This decision is cached, so screen_member#allow_blit must be set again
+	 * after changing them.
+	 *
 	 * @return Reference to the OpenGL sampler object used for the rendering
 	 */
 	inline const gl::sampler &sampler() const
@@ -214,7 +306,7 @@ protected:
 	 * @return Reference to the viewport size object
 	 */
 	inline const rsize_ref &viewport_size() const
-	{ return viewport_size_; }
+	{ return viewport_size_ref_; }
 
 	/**
 	 * @brief Set the viewport size object
@@ -222,7 +314,10 @@ protected:
 	 * @param new_viewport_size New viewport size
 	 */
 	inline void viewport_size(rsize_ref &&new_viewport_size)
-	{ viewport_size_ = std::move(new_viewport_size); }
+	{
+		viewport_size_ = std::move(new_viewport_size);
+		viewport_size_ref_ = make_shared_ref(viewport_size_);
+	}
 
 	/**
 	 * @brief Get a reference to the OpenGL state
@@ -239,6 +334,26 @@ protected:
 	 */
 	inline draw_state &state()
 	{ return state_; }
+
+	/**
+	 * @brief Check if this member may blit its output to the screen
+	 *
+	 * The default is true.
+	 *
+	 * @return true if glBlitNamedFramebuffer is used when it gives the same
+	 * result as the screen program, false if the screen program is always used
+	 */
+	inline bool allow_blit() const
+	{ return allow_blit_; }
+
+	/**
+	 * @brief Set if this member may blit its output to the screen
+	 *
+	 * @param new_allow_blit true to use glBlitNamedFramebuffer when possible,
+	 * false to always use the screen program
+	 */
+	inline void allow_blit(bool new_allow_blit)
+	{ allow_blit_ = new_allow_blit; blit_info_.clear(); }
 };
 
 /**
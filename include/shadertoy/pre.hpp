@@ -50,6 +50,10 @@ namespace shadertoy
 		class program_validate_error;
 		class program;
 
+		class null_program_pipeline_error;
+		class program_pipeline_validate_error;
+		class program_pipeline;
+
 		class null_query_error;
 		class query;
 
@@ -78,12 +82,19 @@ namespace shadertoy
 		class basic_input;
 		class buffer_input;
 		class checker_input;
+		struct decoded_image;
+		class dynamic_input;
 		class error_input;
 		class exr_input;
 		class file_input;
+		class hdr_input;
 		class image_input;
 		class jpeg_input;
+		class ktx_input;
 		class noise_input;
+		class qoi_input;
+		class sequence_input;
+		class shared_input;
 		class soil_input;
 	}
 
@@ -98,6 +109,8 @@ namespace shadertoy
 	/// Miscellaneous utilities
 	namespace utils
 	{
+		class texture_cache;
+		class thread_pool;
 	}
 
 	class basic_shader_inputs;
@@ -105,8 +118,14 @@ namespace shadertoy
 
 	class swap_chain;
 
+	class program_cache;
+	class program_registry;
+	struct shared_program;
 	class render_context;
 	class shader_compiler;
+	class spirv_compiler;
+	class source_cache;
+	class texture_budget;
 	class texture_engine;
 }
 
@@ -0,0 +1,204 @@
+#ifndef _SHADERTOY_PROGRAM_CACHE_HPP_
+#define _SHADERTOY_PROGRAM_CACHE_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/compiler/program_template.hpp"
+#include "shadertoy/program_interface.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace shadertoy
+{
+
+/**
+ * @brief On-disk cache of linked program binaries
+ *
+ * Entries are addressed by a hash of the fully specified program sources, the
+ * OpenGL vendor, renderer and version strings and the supported program binary
+ * formats. Each entry stores the program binary along with the uniform, input
+ * and output resource tables of the program, so a cache hit does not need any
+ * compilation or introspection.
+ *
+ * Entries are named after a 64-bit hash of their key, but also store the full
+ * key material, which is compared when loading them: an entry is never used
+ * for another program, even if the hashes collide.
+ *
+ * Entries are checksummed and discarded if they are corrupted or rejected by
+ * the driver. When the total size of the cache directory exceeds the
+ * configured maximum, the least recently used entries are evicted.
+ *
+ * A program_cache can be shared between render_context instances using
+ * render_context#binary_cache.
+ *
+ * The cache also stores the SPIR-V modules compiled by spirv_compiler (see
+ * compiler::program_template#module_cache), in `.spv` entries with the same
+ * header, key material and checksum. Those entries only depend on the shader
+ * sources and the compiler versions, so they are valid across drivers.
+ */
+class shadertoy_EXPORT program_cache
+{
+public:
+	/**
+	 * @brief Key of a program cache entry
+	 */
+	struct entry_key
+	{
+		/// Hash of the key material, naming the entry file
+		uint64_t hash = 0;
+
+		/// Data identifying the program and the driver, stored in the entry
+		std::string material;
+	};
+
+private:
+	/// Directory holding the cache entries
+	std::string directory_;
+
+	/// Maximum total size of the cache entries, in bytes
+	size_t max_size_;
+
+	/**
+	 * @brief Get the path of the cache entry for the given key
+	 *
+	 * @param key       Key of the cache entry
+	 * @param extension Extension of the cache entry file
+	 *
+	 * @return Path to the cache entry file
+	 */
+	std::string entry_path(uint64_t key, const char *extension) const;
+
+public:
+	/**
+	 * @brief Initialize a new program cache
+	 *
+	 * @param directory Directory to store the cache entries in. It is created
+	 *                  if it does not exist.
+	 * @param max_size  Maximum total size of the cache entries, in bytes
+	 */
+	program_cache(const std::string &directory, size_t max_size = 64 * 1024 * 1024);
+
+	/**
+	 * @brief Compute the cache key of a program
+	 *
+	 * This queries the current OpenGL context for the driver details.
+	 *
+	 * @param sources   Fully specified sources of the program, as returned by
+	 *                  compiler::program_template#specify_sources
+	 * @param separable true if the program is a separable program
+	 *
+	 * @return Key for the given program in this cache
+	 */
+	entry_key key(const compiler::program_template::sources_map &sources, bool separable = false) const;
+
+	/**
+	 * @brief Compute the cache key of a program derived from a template
+	 *
+	 * This includes the shared libraries and the build options of \p program_template.
+	 *
+	 * @param program_template Template the program is built from
+	 * @param sources          Fully specified sources of the program, as
+	 *                         returned by compiler::program_template#specify_sources
+	 *
+	 * @return Key for the given program in this cache
+	 */
+	entry_key key(const compiler::program_template &program_template,
+				 const compiler::program_template::sources_map &sources) const;
+
+	/**
+	 * @brief Compute the cache key of a SPIR-V module
+	 *
+	 * Unlike program keys, this does not depend on the current OpenGL context.
+	 *
+	 * @param type     Type of the shader
+	 * @param units    Named sources of each compilation unit of the shader, as
+	 *                 given to spirv_compiler#compile
+	 * @param optimize true if the module is optimized, as given to
+	 *                 spirv_compiler#compile
+	 *
+	 * @return Key for the given module in this cache
+	 */
+	entry_key module_key(GLenum type, const std::vector<compiler::source_list> &units, bool optimize = true) const;
+
+	/**
+	 * @brief Load a SPIR-V module from the cache
+	 *
+	 * @param key Key of the module to load
+	 *
+	 * @return SPIR-V module words, or an empty vector if there is no valid
+	 *         cache entry for \p key
+	 */
+	std::vector<uint32_t> load_module(const entry_key &key) const;
+
+	/**
+	 * @brief Store a SPIR-V module in the cache
+	 *
+	 * Failures to write the cache entry are logged and otherwise ignored.
+	 *
+	 * @param key    Key of the module to store
+	 * @param module SPIR-V module words
+	 */
+	void store_module(const entry_key &key, const std::vector<uint32_t> &module) const;
+
+	/**
+	 * @brief Load a program from the cache
+	 *
+	 * @param key          Key of the program to load
+	 * @param[out] program Program object to load the binary into. It is only
+	 *                     modified if the entry could be loaded.
+	 * @param separable    true if the program is a separable program
+	 *
+	 * @return Program interface of the loaded program, referencing \p program,
+	 *         or null if there is no valid cache entry for \p key
+	 */
+	std::unique_ptr<program_interface> load(const entry_key &key, gl::program &program, bool separable = false) const;
+
+	/**
+	 * @brief Store a linked program in the cache
+	 *
+	 * Failures to write the cache entry are logged and otherwise ignored.
+	 *
+	 * @param key       Key of the program to store
+	 * @param program   Linked program to store
+	 * @param interface Program interface of \p program
+	 */
+	void store(const entry_key &key, const gl::program &program, const program_interface &interface) const;
+
+	/**
+	 * @brief Remove the least recently used entries until the cache fits in its maximum size
+	 */
+	void evict() const;
+
+	/**
+	 * @brief Get the directory of this cache
+	 *
+	 * @return Path to the directory holding the cache entries
+	 */
+	inline const std::string &directory() const
+	{ return directory_; }
+
+	/**
+	 * @brief Get the maximum size of this cache
+	 *
+	 * @return Maximum total size of the cache entries, in bytes
+	 */
+	inline size_t max_size() const
+	{ return max_size_; }
+
+	/**
+	 * @brief Set the maximum size of this cache
+	 *
+	 * The new size is enforced on the next call to program_cache#store or program_cache#evict.
+	 *
+	 * @param new_max_size New maximum total size of the cache entries, in bytes
+	 */
+	inline void max_size(size_t new_max_size)
+	{ max_size_ = new_max_size; }
+};
+
+}
+
+#endif /* _SHADERTOY_PROGRAM_CACHE_HPP_ */
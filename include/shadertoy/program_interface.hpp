@@ -50,6 +50,19 @@ struct program_resource
 	 * @param resource_index    Index of the target resource in the program interface
 	 */
 	program_resource(const gl::program &program, GLenum program_interface, GLuint resource_index);
+
+	/**
+	 * @brief Build a new program resource from known values
+	 *
+	 * @param program_interface Name of the interface this resource belongs to
+	 * @param resource_index    Index of the target resource in the program interface
+	 * @param name              Textual name of the resource
+	 * @param location          Location of the resource
+	 * @param type              OpenGL type of the resource
+	 * @param array_size        Size of the array, 0 if the resource is not an array
+	 */
+	program_resource(GLenum program_interface, GLuint resource_index, std::string name, GLint location,
+					 GLint type, GLint array_size);
 };
 
 /**
@@ -93,6 +106,17 @@ struct uniform_resource : public program_resource
 	 * @param resource_index    Index of the target resource in the program interface
 	 */
 	uniform_resource(const gl::program &program, GLuint resource_index);
+
+	/**
+	 * @brief Build a new uniform resource from known values
+	 *
+	 * @param resource_index Index of the target resource in the program interface
+	 * @param name           Textual name of the resource
+	 * @param location       Location of the resource
+	 * @param type           OpenGL type of the resource
+	 * @param array_size     Size of the array, 0 if the resource is not an array
+	 */
+	uniform_resource(GLuint resource_index, std::string name, GLint location, GLint type, GLint array_size);
 };
 
 /**
@@ -109,6 +133,17 @@ struct input_resource : public program_resource
 	 * @param resource_index    Index of the target resource in the program interface
 	 */
 	input_resource(const gl::program &program, GLuint resource_index);
+
+	/**
+	 * @brief Build a new program input resource from known values
+	 *
+	 * @param resource_index Index of the target resource in the program interface
+	 * @param name           Textual name of the resource
+	 * @param location       Location of the resource
+	 * @param type           OpenGL type of the resource
+	 * @param array_size     Size of the array, 0 if the resource is not an array
+	 */
+	input_resource(GLuint resource_index, std::string name, GLint location, GLint type, GLint array_size);
 };
 
 /**
@@ -125,6 +160,17 @@ struct output_resource : public program_resource
 	 * @param resource_index    Index of the target resource in the program interface
 	 */
 	output_resource(const gl::program &program, GLuint resource_index);
+
+	/**
+	 * @brief Build a new program output resource from known values
+	 *
+	 * @param resource_index Index of the target resource in the program interface
+	 * @param name           Textual name of the resource
+	 * @param location       Location of the resource
+	 * @param type           OpenGL type of the resource
+	 * @param array_size     Size of the array, 0 if the resource is not an array
+	 */
+	output_resource(GLuint resource_index, std::string name, GLint location, GLint type, GLint array_size);
 };
 
 /**
@@ -147,6 +193,17 @@ class resource_interface
 	/// Map for lookup of resources by location
 	std::unordered_map<GLint, size_t> resource_locations_;
 
+	/// Build the lookup maps from the list of resource objects
+	void build_lookup()
+	{
+		for (auto it = resources_.begin(); it != resources_.end(); ++it)
+		{
+			size_t idx = it - resources_.begin();
+			resource_names_.insert(std::make_pair(it->name, idx));
+			resource_locations_.insert(std::make_pair(it->location, idx));
+		}
+	}
+
 public:
 	/**
 	 * @brief Build a new resource_interface object
@@ -167,12 +224,18 @@ public:
 		}
 
 		// Build lookup maps
-		for (auto it = resources_.begin(); it != resources_.end(); ++it)
-		{
-			size_t idx = it - resources_.begin();
-			resource_names_.insert(std::make_pair(it->name, idx));
-			resource_locations_.insert(std::make_pair(it->location, idx));
-		}
+		build_lookup();
+	}
+
+	/**
+	 * @brief Build a new resource_interface object from known resources
+	 *
+	 * @param resources List of resource objects, in resource index order
+	 */
+	resource_interface(std::vector<T> resources)
+	: resources_(std::move(resources))
+	{
+		build_lookup();
 	}
 
 	/**
@@ -274,8 +337,27 @@ class program_interface
 	output_interface outputs_;
 
 public:
+	/**
+	 * @brief Query the interfaces of a linked program
+	 *
+	 * @param program Program to query the resources from
+	 */
 	program_interface(const gl::program &program);
 
+	/**
+	 * @brief Build the interfaces of a program from known resources
+	 *
+	 * This is used when the resource tables have been saved alongside a
+	 * program binary, to skip the introspection queries.
+	 *
+	 * @param program  Program the resources belong to
+	 * @param uniforms Uniform resource interface
+	 * @param inputs   Program input resource interface
+	 * @param outputs  Program output resource interface
+	 */
+	program_interface(const gl::program &program, uniform_interface uniforms, input_interface inputs,
+					  output_interface outputs);
+
 	/**
 	 * @brief Get the program corresponding to this interface
 	 */
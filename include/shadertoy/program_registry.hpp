@@ -0,0 +1,164 @@
+#ifndef _SHADERTOY_PROGRAM_REGISTRY_HPP_
+#define _SHADERTOY_PROGRAM_REGISTRY_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/compiler/deferred_program.hpp"
+#include "shadertoy/compiler/program_template.hpp"
+#include "shadertoy/program_cache.hpp"
+#include "shadertoy/program_interface.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace shadertoy
+{
+
+/**
+ * @brief Program shared between buffers built from identical sources
+ */
+struct shared_program
+{
+	/// Linked program
+	gl::program program;
+
+	/// Interface of the program, or null if it is not linked yet
+	std::unique_ptr<program_interface> interface;
+
+	/// Program being compiled, for the first buffer to initialize to complete
+	std::unique_ptr<compiler::deferred_program> pending;
+
+	/// Key of the program in the program_cache
+	program_cache::entry_key cache_key;
+};
+
+/**
+ * @brief Registry of the programs in use by buffers of a render_context
+ *
+ * Programs are keyed by their fully specified sources, including the shared
+ * libraries of the program template they were built from, and by the options
+ * of the template. The key keeps the sources, which are compared on lookup, so
+ * a hash collision never shares a program between different sources.
+ * buffers::program_buffer instances with the same key share the same program
+ * and interface, for example when
+ * instancing a swap_chain with swap_chain#clone. Per-buffer uniform values are
+ * uploaded before rendering (see buffers::program_buffer#set_uniform).
+ *
+ * The registry does not own the programs: they are reference-counted by the
+ * buffers using them, and released when the last of them is destroyed or
+ * recompiled.
+ */
+class shadertoy_EXPORT program_registry
+{
+public:
+	/**
+	 * @brief Key of a program in the registry
+	 */
+	struct shadertoy_EXPORT entry_key
+	{
+		/// Hash of the key, used to index the registry
+		uint64_t hash = 0;
+
+		/// true if the program is separable
+		bool separable = false;
+
+		/// true if the program is built from SPIR-V modules
+		bool spirv = false;
+
+		/// Specialization constants of SPIR-V programs
+		std::map<GLuint, GLuint> specialization_constants;
+
+		/// Sources linked into the program, including shared libraries
+		compiler::program_template::sources_map sources;
+
+		/**
+		 * @brief Compare the contents of two keys
+		 *
+		 * @param other Key to compare to
+		 *
+		 * @return true if both keys identify the same program
+		 */
+		bool operator==(const entry_key &other) const;
+	};
+
+private:
+	/// Registered program
+	struct entry
+	{
+		/// Key of the program
+		entry_key key;
+
+		/// Program, released when no buffer uses it anymore
+		std::weak_ptr<shared_program> program;
+	};
+
+	/// Registered programs, by key hash
+	std::multimap<uint64_t, entry> programs_;
+
+	/// Number of registered programs above which emplace drops the programs not in use anymore
+	size_t sweep_size_;
+
+	/// Find the entry registered with the given key
+	std::multimap<uint64_t, entry>::iterator find_entry(const entry_key &key);
+
+public:
+	/**
+	 * @brief Initialize a new empty program registry
+	 */
+	program_registry();
+
+	/**
+	 * @brief Compute the registry key of a program
+	 *
+	 * @param program_template Template the program is built from
+	 * @param sources          Fully specified sources of the program, as
+	 *                         returned by compiler::program_template#specify_sources
+	 *
+	 * @return Key for the given program in this registry
+	 */
+	static entry_key key(const compiler::program_template &program_template,
+						const compiler::program_template::sources_map &sources);
+
+	/**
+	 * @brief Find a program in use by another buffer
+	 *
+	 * @param key Key of the program
+	 *
+	 * @return Pointer to the shared program, or null if no buffer is using it
+	 */
+	std::shared_ptr<shared_program> find(const entry_key &key);
+
+	/**
+	 * @brief Register a new program
+	 *
+	 * This replaces any program registered with the same key, buffers using it
+	 * keep their reference.
+	 *
+	 * @param key Key of the program
+	 *
+	 * @return Pointer to the new, empty shared program
+	 */
+	std::shared_ptr<shared_program> emplace(const entry_key &key);
+
+	/**
+	 * @brief Remove a program from this registry
+	 *
+	 * This is used when the program failed to build, so the next buffer using
+	 * the same sources tries again. Buffers using it keep their reference.
+	 *
+	 * @param key Key of the program
+	 */
+	void erase(const entry_key &key);
+
+	/**
+	 * @brief Get the number of programs in use
+	 *
+	 * @return Number of registered programs which are still in use by at least one buffer
+	 */
+	size_t size() const;
+};
+
+}
+
+#endif /* _SHADERTOY_PROGRAM_REGISTRY_HPP_ */
@@ -6,6 +6,10 @@
 #include "shadertoy/compiler/program_template.hpp"
 #include "shadertoy/geometry/screen_quad.hpp"
 
+#include <chrono>
+#include <optional>
+#include <vector>
+
 namespace shadertoy
 {
 
@@ -39,13 +43,16 @@ namespace shadertoy
  * uniform vec4 iMouse;
  * // etc.
  *
+ * #pragma shadertoy part *:libraries
  * #pragma shadertoy part buffer:inputs
  * #pragma shadertoy part buffer:sources
  *
+ * #pragma shadertoy part glsl:main begin
  * void main(void) {
  *     fragColor = vec4(0., 0., 0., 1.);
  *     mainImage(fragColor, vtexCoord.xy * iResolution.xy);
  * }
+ * #pragma shadertoy part end
  * ```
  *
  * The default parts of the buffer template are as follows:
@@ -57,6 +64,13 @@ namespace shadertoy
  * // Example:
  * #define MY_VALUE 10
  * ```
+ *   * `*:libraries`: Declarations of the shared libraries compiled with
+ *   compiler::program_template#compile_library.
+ * ```
+ * // Generated from the library sources, with function bodies removed
+ * // Example:
+ * vec3 palette(float t);
+ * ```
  *   * `buffer:inputs`: Sampler uniforms defined by the buffer being compiled
  * ```
  * // Generated on the fly from the input definitions
@@ -68,6 +82,8 @@ namespace shadertoy
  * // Should define mainImage, as in a Shadertoy
  * void mainImage(out vec4 O, in vec2 U) { O = vec4(1.); }
  * ```
+ *   * `glsl:main`: Fragment shader entry point. It is removed when compiling shared
+ *   libraries.
  *
  * These parts may be overriden in order to fully control how the resulting shaders are built.
  * Note that the `buffer:*` parts are filled in by program_buffer#init_contents() from the
@@ -88,6 +104,24 @@ class shadertoy_EXPORT render_context
 	/// Default error input
 	std::shared_ptr<inputs::error_input> error_input_;
 
+	/// Program binary cache
+	std::shared_ptr<program_cache> binary_cache_;
+
+	/// Source file cache
+	std::shared_ptr<source_cache> source_files_;
+
+	/// Programs shared between identical buffers
+	std::shared_ptr<program_registry> programs_;
+
+	/// Number of background shader compiler threads to request from the driver
+	std::optional<unsigned int> compiler_threads_;
+
+	/// true if swap chains are warmed up when initialized
+	bool warm_up_on_init_;
+
+	/// Texture memory budget of file inputs
+	std::shared_ptr<texture_budget> textures_;
+
 public:
 	/**
 	 * @brief      Create a new render context.
@@ -111,10 +145,30 @@ public:
 	/**
 	 * @brief        Initialize the given swap chain
 	 *
+	 * The swap chain is warmed up after its textures are allocated if
+	 * render_context#warm_up_on_init is true.
+	 *
 	 * @param chain  Swap chain to initialize
 	 */
 	void init(swap_chain &chain) const;
 
+	/**
+	 * @brief        Warm up the rendering pipeline of the given swap chain
+	 *
+	 * Every member is rendered once into a single-pixel scratch target, using
+	 * its actual draw state, inputs and output formats, so the driver finalizes
+	 * the compilation of its programs before the first frame is rendered (see
+	 * members::basic_member#warm_up). This waits once for the GPU, after all
+	 * members have been warmed up. The time taken by each member, measured
+	 * with timestamp queries, is logged.
+	 *
+	 * @param chain  Initialized swap chain to warm up
+	 *
+	 * @return       Warm-up time of each member (time to issue the warm-up,
+	 *               and GPU time to execute it), in the order of swap_chain#members
+	 */
+	std::vector<std::chrono::nanoseconds> warm_up(swap_chain &chain) const;
+
 	/**
 	 * @brief        Reallocate the textures used by the swap chain \p chain
 	 *
@@ -154,6 +208,117 @@ public:
 	 */
 	inline const std::shared_ptr<inputs::error_input> &error_input() const
 	{ return error_input_; }
+
+	/**
+	 * @brief  Get the program binary cache used by this context
+	 *
+	 * @return Pointer to the program_cache instance, or null if programs are always compiled from source
+	 */
+	inline const std::shared_ptr<program_cache> &binary_cache() const
+	{ return binary_cache_; }
+
+	/**
+	 * @brief  Set the program binary cache used by this context
+	 *
+	 * Buffers initialized after this call will load their programs from
+	 * \p new_cache when possible, and store newly compiled programs in it.
+	 *
+	 * @param new_cache Pointer to the program_cache instance, or null to disable caching
+	 */
+	inline void binary_cache(std::shared_ptr<program_cache> new_cache)
+	{ binary_cache_ = std::move(new_cache); }
+
+	/**
+	 * @brief  Get the source file cache used by this context
+	 *
+	 * Source files of buffers::program_buffer instances are read through this
+	 * cache, unless their compiler::file_part already has a cache.
+	 *
+	 * @return Pointer to the source_cache instance
+	 */
+	inline const std::shared_ptr<source_cache> &source_files() const
+	{ return source_files_; }
+
+	/**
+	 * @brief  Set the source file cache used by this context
+	 *
+	 * This can be used to share a source cache between contexts.
+	 *
+	 * @param new_cache Pointer to the source_cache instance, or null to read source files on every compilation
+	 */
+	inline void source_files(std::shared_ptr<source_cache> new_cache)
+	{ source_files_ = std::move(new_cache); }
+
+	/**
+	 * @brief  Get the registry of programs shared between buffers of this context
+	 *
+	 * buffers::program_buffer instances with identical sources use the same
+	 * program from this registry instead of compiling their own.
+	 *
+	 * @return Pointer to the program_registry instance
+	 */
+	inline const std::shared_ptr<program_registry> &programs() const
+	{ return programs_; }
+
+	/**
+	 * @brief  Get the number of background shader compiler threads requested from the driver
+	 *
+	 * @return Number of threads, or std::nullopt to use the driver default
+	 */
+	inline std::optional<unsigned int> compiler_threads() const
+	{ return compiler_threads_; }
+
+	/**
+	 * @brief  Set the number of background shader compiler threads requested from the driver
+	 *
+	 * The hint is applied using GL_KHR_parallel_shader_compile (or its ARB
+	 * equivalent) when initializing a swap chain, if the extension is supported.
+	 *
+	 * @param new_threads Number of threads, or std::nullopt to use the driver default
+	 */
+	inline void compiler_threads(std::optional<unsigned int> new_threads)
+	{ compiler_threads_ = new_threads; }
+
+	/**
+	 * @brief  Check if swap chains are warmed up when initialized
+	 *
+	 * @return true if render_context#init calls render_context#warm_up
+	 */
+	inline bool warm_up_on_init() const
+	{ return warm_up_on_init_; }
+
+	/**
+	 * @brief  Set if swap chains should be warmed up when initialized
+	 *
+	 * @param new_warm_up_on_init true to warm up swap chains in render_context#init
+	 */
+	inline void warm_up_on_init(bool new_warm_up_on_init)
+	{ warm_up_on_init_ = new_warm_up_on_init; }
+
+	/**
+	 * @brief Get the texture memory budget of file inputs
+	 *
+	 * @return Pointer to the texture_budget instance, or null if textures are never evicted
+	 */
+	inline const std::shared_ptr<texture_budget> &textures() const
+	{ return textures_; }
+
+	/**
+	 * @brief Set the texture memory budget of file inputs
+	 *
+	 * File inputs are tracked by the budget when they are used by buffers
+	 * rendered with this context. The application must call
+	 * texture_budget#next_frame once per frame to enforce it.
+	 *
+	 * @param new_textures Pointer to the texture_budget instance, or null to never evict textures
+	 */
+	inline void textures(std::shared_ptr<texture_budget> new_textures)
+	{ textures_ = std::move(new_textures); }
+
+	/**
+	 * @brief  Apply the compiler_threads hint to the current OpenGL context
+	 */
+	void apply_compiler_threads() const;
 };
 
 }
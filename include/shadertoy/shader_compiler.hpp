@@ -3,6 +3,8 @@
 
 #include "shadertoy/pre.hpp"
 
+#include "shadertoy/compiler/basic_part.hpp"
+
 namespace shadertoy
 {
 
@@ -28,7 +30,27 @@ public:
 	 *             GLSL code. The parts will be compiled in the same order as
 	 *             they are added to this vector.
 	 */
-	static void compile(gl::shader &shader, const std::vector<std::pair<std::string, std::string>> &sources);
+	static void compile(gl::shader &shader, const compiler::source_list &sources);
+
+	/**
+	 * @brief      Load the sources in the provided shader object, and submit
+	 *             it for compilation without waiting for the result. The
+	 *             compilation status must be checked with shader_compiler#check.
+	 *
+	 * @param      shader  The shader
+	 * @param      sources Named sources to compile into the shader
+	 */
+	static void submit(gl::shader &shader, const compiler::source_list &sources);
+
+	/**
+	 * @brief      Check the compilation status of a shader submitted with
+	 *             shader_compiler#submit. Any errors will be rewritten as in
+	 *             shader_compiler#compile.
+	 *
+	 * @param      shader  The shader
+	 * @param      sources Named sources the shader was submitted with
+	 */
+	static void check(gl::shader &shader, const compiler::source_list &sources);
 };
 
 }
@@ -143,6 +143,43 @@ std::unique_ptr<size_ref_interface<T>> make_ref(const size_ref_interface<T> &int
 	return std::make_unique<size_ref_interface_ref<T>>(int_ref);
 }
 
+/**
+ * @brief Represents a reference to another size_ref_interface object, which
+ *        is kept alive by this reference
+ *
+ * @tparam T Type of the size object elements
+ */
+template <typename T> class shared_size_ref : public size_ref_interface<T>
+{
+	/// Shared reference interface
+	std::shared_ptr<const size_ref_interface<T>> int_ref_;
+
+public:
+	/**
+	 * @brief Build a new size_ref_interface&lt;T&gt; sharing ownership of another one
+	 *
+	 * @param int_ref Pointer to an interface
+	 */
+	shared_size_ref(std::shared_ptr<const size_ref_interface<T>> int_ref)
+		: int_ref_(std::move(int_ref))
+	{}
+
+	basic_size<T> resolve() const override { return int_ref_->resolve(); }
+};
+
+/**
+ * @brief Constructs a shared reference to a size_ref_interface&lt;T&gt;
+ *
+ * @param int_ref Pointer to a size_ref_interface&lt;T&gt;
+ *
+ * @return Pointer to the constructed shared_size_ref
+ */
+template <typename T>
+std::unique_ptr<size_ref_interface<T>> make_shared_ref(std::shared_ptr<const size_ref_interface<T>> int_ref)
+{
+	return std::make_unique<shared_size_ref<T>>(std::move(int_ref));
+}
+
 /**
  * @brief Represents a size object, wrapped in a size_ref_interface
  *
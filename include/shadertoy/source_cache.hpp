@@ -0,0 +1,156 @@
+#ifndef _SHADERTOY_SOURCE_CACHE_HPP_
+#define _SHADERTOY_SOURCE_CACHE_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/compiler/basic_part.hpp"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace shadertoy
+{
+
+/**
+ * @brief In-memory cache of shader source files
+ *
+ * Files are read once and kept in memory as shared sources, keyed by their
+ * canonical path, modification time (with nanosecond resolution) and size.
+ * Reading a file which has not changed since the last read does not access its
+ * contents again, unless it was modified shortly before being read: as the
+ * timestamp may then not change on the next edit, the contents are compared
+ * to a hash of the cached ones.
+ *
+ * Source files may include other files using the following directive, where
+ * relative paths are resolved from the directory of the including file:
+ * ```
+ * #pragma shadertoy include "common.glsl"
+ * ```
+ *
+ * The directive is replaced with the sources of the included file, so the
+ * resulting source list contains one entry per file chunk. Line numbers in
+ * compilation errors still refer to the lines of the original files. The
+ * include graph is recorded, so callers can find which files depend on a
+ * changed file using source_cache#dependents.
+ *
+ * A source_cache is owned by every render_context (see
+ * render_context#source_files), and used by compiler::file_part instances
+ * specified by buffers::program_buffer.
+ */
+class shadertoy_EXPORT source_cache
+{
+	/// Cached source file
+	struct entry
+	{
+		/// Modification time of the file when it was read, in nanoseconds
+		int64_t mtime;
+
+		/// Size of the file when it was read
+		uintmax_t size;
+
+		/// FNV-1a hash of the contents of the file
+		uint64_t hash;
+
+		/// true if the file was modified too recently to detect changes using its modification time
+		bool racy;
+
+		/// Generation of the cache when this entry was loaded
+		uint64_t generation;
+
+		/// Sources of the file, with includes resolved
+		compiler::source_list sources;
+
+		/// Canonical paths of the files included by this file, with their generation when they were resolved
+		std::vector<std::pair<std::string, uint64_t>> includes;
+	};
+
+	/// Cached files, by canonical path
+	std::map<std::string, entry> entries_;
+
+	/// Number of files loaded since this cache was created
+	uint64_t generation_;
+
+	const entry &load(const std::string &path, std::vector<std::string> &stack);
+
+public:
+	/**
+	 * @brief Initialize a new empty source cache
+	 */
+	source_cache();
+
+	/**
+	 * @brief Get the sources of a file, with includes resolved
+	 *
+	 * @param path Path to the source file
+	 *
+	 * @return Sources of the file. Each source is named after the file it
+	 *         comes from.
+	 *
+	 * @throws compiler::template_error The file or one of its includes could
+	 *                                  not be read, or includes form a cycle
+	 */
+	compiler::source_list sources(const std::string &path);
+
+	/**
+	 * @brief Get the files included by a file, directly or not
+	 *
+	 * This only reports files which have been read through this cache.
+	 *
+	 * @param path Path to the source file
+	 *
+	 * @return Canonical paths of the included files
+	 */
+	std::set<std::string> dependencies(const std::string &path) const;
+
+	/**
+	 * @brief Get the files which include a file, directly or not
+	 *
+	 * This only reports files which have been read through this cache.
+	 *
+	 * @param path Path to the included file
+	 *
+	 * @return Canonical paths of the files including \p path
+	 */
+	std::set<std::string> dependents(const std::string &path) const;
+
+	/**
+	 * @brief Drop the cached contents of a file
+	 *
+	 * The file will be read again the next time it is requested, even if its
+	 * modification time and size did not change.
+	 *
+	 * @param path Path to the source file
+	 */
+	void invalidate(const std::string &path);
+
+	/**
+	 * @brief Drop the contents of all cached files
+	 */
+	void clear();
+
+	/**
+	 * @brief Get the number of files read by this cache
+	 *
+	 * This increases every time a file is (re-)read, and can be used to check
+	 * if the include graph may have changed.
+	 *
+	 * @return Number of files read since this cache was created
+	 */
+	inline uint64_t generation() const
+	{ return generation_; }
+
+	/**
+	 * @brief Get the number of cached files
+	 *
+	 * @return Number of cached files
+	 */
+	inline size_t size() const
+	{ return entries_.size(); }
+};
+
+}
+
+#endif /* _SHADERTOY_SOURCE_CACHE_HPP_ */
@@ -0,0 +1,106 @@
+#ifndef _SHADERTOY_SPIRV_COMPILER_HPP_
+#define _SHADERTOY_SPIRV_COMPILER_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include "shadertoy/compiler/basic_part.hpp"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace shadertoy
+{
+
+/**
+ * @brief      Compiles GLSL sources to SPIR-V modules using glslang, and loads
+ *             them into shader objects using ARB_gl_spirv.
+ *
+ *             Modules are optimized with the SPIR-V optimizer before being
+ *             handed to the driver, which only has to translate the optimized
+ *             module instead of parsing and optimizing the GLSL sources.
+ *             Unlike program binaries, SPIR-V modules do not depend on the
+ *             driver, so they can be stored in a program_cache and reused
+ *             across drivers and machines.
+ *
+ *             Debug names are kept in the modules, since uniforms and inputs
+ *             are looked up by name by the program_interface. Drivers are
+ *             not required to reflect these names (e.g. Mesa does not), see
+ *             spirv_compiler#reflects_names.
+ */
+class shadertoy_EXPORT spirv_compiler
+{
+public:
+	/// Values of specialization constants, by constant_id
+	typedef std::map<GLuint, GLuint> specialization_map;
+
+	/**
+	 * @brief      Get a value indicating if SPIR-V shaders are supported
+	 *
+	 *             This requires libshadertoy to be built with glslang and
+	 *             SPIRV-Tools, and the current context to support OpenGL 4.6
+	 *             or ARB_gl_spirv.
+	 *
+	 * @return     true if it is supported, false otherwise
+	 */
+	static bool supported();
+
+	/**
+	 * @brief      Get a value indicating if the current context reflects the
+	 *             names of the uniforms of SPIR-V programs
+	 *
+	 *             This links a small SPIR-V program and looks up its uniform
+	 *             by name. Uniforms of SPIR-V programs cannot be set by name
+	 *             if it fails, so GLSL sources should be used instead.
+	 *
+	 * @return     true if uniform names are reflected, false otherwise
+	 */
+	static bool reflects_names();
+
+	/**
+	 * @brief      Get the versions of glslang and SPIRV-Tools
+	 *
+	 *             Modules compiled by different versions may differ, so this
+	 *             is part of the key of cached modules.
+	 *
+	 * @return     Version string, empty if SPIR-V support was not built
+	 */
+	static std::string version();
+
+	/**
+	 * @brief      Compile GLSL sources into a SPIR-V module. Any compilation
+	 *             errors will refer to the names of the source parts.
+	 *
+	 * @param      type     Type of the shader to compile
+	 * @param      units    Named sources of each compilation unit of the
+	 *                      shader. The first unit must contain the entry
+	 *                      point, the other ones are linked with it (e.g.
+	 *                      shared libraries).
+	 * @param      optimize true to run the performance passes of the SPIR-V
+	 *                      optimizer on the module
+	 *
+	 * @return     SPIR-V module words
+	 *
+	 * @throws     gl::shader_compilation_error The sources failed to compile or link
+	 * @throws     shadertoy_error              SPIR-V support was not built
+	 */
+	static std::vector<uint32_t> compile(GLenum type, const std::vector<compiler::source_list> &units,
+										 bool optimize = true);
+
+	/**
+	 * @brief      Load a SPIR-V module in the provided shader object, and
+	 *             specialize its `main` entry point. The specialization status
+	 *             must be checked with gl::shader#check_compile.
+	 *
+	 * @param      shader    The shader
+	 * @param      module    SPIR-V module words, as returned by spirv_compiler#compile
+	 * @param      constants Values of the specialization constants. Constants
+	 *                       which are not listed keep their default value.
+	 */
+	static void load(gl::shader &shader, const std::vector<uint32_t> &module, const specialization_map &constants);
+};
+
+}
+
+#endif /* _SHADERTOY_SPIRV_COMPILER_HPP_ */
@@ -203,6 +203,11 @@ public:
 	/**
 	 * @brief Initialize the members of this swap chain
 	 *
+	 * All members are prepared (see basic_member#prepare) before any of them
+	 * is initialized, so program compilation for the whole chain can be
+	 * pipelined by the driver. Errors are still raised by the initialization
+	 * of the member they belong to.
+	 *
 	 * @param context Context used for initialization
 	 */
 	void init(const render_context &context);
@@ -215,19 +220,37 @@ public:
 	void allocate_textures(const render_context &context);
 
 	/**
-	 * @brief Set a uniform value on all buffers in this chain
+	 * @brief Create a new instance of this swap chain
+	 *
+	 * Every member is cloned (see members::basic_member#clone), with its own
+	 * render targets. Inputs and screen members reading from members of this
+	 * chain read from their clones instead. Buffers are initialized from the
+	 * same sources, so their programs are shared with the buffers of this
+	 * chain through the program_registry of the render context.
+	 *
+	 * Members of the clone share the render size objects of the members of
+	 * this chain. The clone must be initialized before being rendered.
+	 *
+	 * @return New swap chain with clones of the members of this chain
 	 *
+	 * @throws shadertoy_error A member cannot be cloned
+	 */
+	swap_chain clone() const;
+
+	/**
+	 * @brief Set a uniform value on all buffers in this chain
 	 *
+	 * Values are recorded by the buffers (see
+	 * buffers::program_buffer#set_uniform), so they are kept even if the
+	 * programs are shared with other chains.
 	 */
 	template<typename TIndex, typename... TValue>
 	void set_uniform(const TIndex &identifier, TValue && ...value) const
 	{
 		for (auto &member : members_) {
-			if (auto buf_member = std::dynamic_pointer_cast<members::buffer_member>(member)) {
-				if (auto buf = std::dynamic_pointer_cast<buffers::program_buffer>(buf_member->buffer())) {
-					if (auto loc = buf->interface().try_get_uniform_location(identifier)) {
-						loc->set_value(value...);
-					}
+			if (auto buf_member = dynamic_cast<members::buffer_member *>(member.get())) {
+				if (auto buf = dynamic_cast<buffers::program_buffer *>(buf_member->buffer().get())) {
+					buf->set_uniform(identifier, value...);
 				}
 			}
 		}
@@ -0,0 +1,139 @@
+#ifndef _SHADERTOY_TEXTURE_BUDGET_HPP_
+#define _SHADERTOY_TEXTURE_BUDGET_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace shadertoy
+{
+
+/**
+ * @brief Device memory budget for the textures of file inputs
+ *
+ * File inputs used by buffers::program_buffer instances rendered with a
+ * render_context that has a texture budget (see render_context#textures) are
+ * tracked by the budget. Every use of an input records the current frame
+ * number and the size of its texture.
+ *
+ * When the tracked textures exceed the budget, texture_budget#next_frame
+ * resets the least recently used inputs until they fit again. Evicted inputs
+ * are loaded again the next time they are used. If the budget has a decode
+ * pool, evicted inputs are reloaded asynchronously on it (see
+ * inputs::file_input#decode_pool).
+ *
+ * Inputs used during the current frame are never evicted, so the budget may
+ * be exceeded if a single frame uses more textures than it allows.
+ */
+class shadertoy_EXPORT texture_budget : public std::enable_shared_from_this<texture_budget>
+{
+	/// Tracked inputs
+	std::vector<std::weak_ptr<inputs::basic_input>> inputs_;
+
+	/// Maximum total size of the tracked textures, in bytes
+	size_t max_size_;
+
+	/// Current frame number
+	uint64_t frame_;
+
+	/// Number of inputs evicted since the budget was created
+	size_t evictions_;
+
+	/// Pool to reload evicted inputs on, or null to reload them synchronously
+	std::shared_ptr<utils::thread_pool> decode_pool_;
+
+public:
+	/**
+	 * @brief Initialize a new texture budget
+	 *
+	 * @param max_size Maximum total size of the tracked textures, in bytes
+	 */
+	explicit texture_budget(size_t max_size);
+
+	/**
+	 * @brief Track an input in this budget
+	 *
+	 * Inputs other than file inputs are ignored. inputs::shared_input
+	 * instances are tracked through their source input. Tracking an input
+	 * which is already tracked is a no-op.
+	 *
+	 * @param input Input to track
+	 */
+	void track(const std::shared_ptr<inputs::basic_input> &input);
+
+	/**
+	 * @brief Start a new frame, and evict textures to fit in the budget
+	 *
+	 * This should be called once per frame by the application, after all the
+	 * swap chains have been rendered.
+	 *
+	 * @return Number of bytes evicted
+	 */
+	size_t next_frame();
+
+	/**
+	 * @brief Get the total size of the tracked textures
+	 *
+	 * @return Size in bytes of the textures of the tracked inputs
+	 */
+	size_t resident_bytes() const;
+
+	/**
+	 * @brief Get the number of tracked inputs
+	 *
+	 * @return Number of tracked inputs
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief Get the current frame number
+	 *
+	 * @return Number of calls to texture_budget#next_frame
+	 */
+	inline uint64_t frame() const { return frame_; }
+
+	/**
+	 * @brief Get the number of evicted inputs
+	 *
+	 * @return Number of inputs evicted since the budget was created
+	 */
+	inline size_t evictions() const { return evictions_; }
+
+	/**
+	 * @brief Get the maximum total size of the tracked textures
+	 *
+	 * @return Budget in bytes
+	 */
+	inline size_t max_size() const { return max_size_; }
+
+	/**
+	 * @brief Set the maximum total size of the tracked textures
+	 *
+	 * The new budget is enforced by the next call to texture_budget#next_frame.
+	 *
+	 * @param new_max_size Budget in bytes
+	 */
+	inline void max_size(size_t new_max_size) { max_size_ = new_max_size; }
+
+	/**
+	 * @brief Get the pool evicted inputs are reloaded on
+	 *
+	 * @return Pointer to the decode pool, or null if evicted inputs are reloaded synchronously
+	 */
+	inline const std::shared_ptr<utils::thread_pool> &decode_pool() const { return decode_pool_; }
+
+	/**
+	 * @brief Set the pool evicted inputs are reloaded on
+	 *
+	 * @param new_pool Pointer to the decode pool, or null to keep the decode
+	 *                 pool of evicted inputs unchanged
+	 */
+	inline void decode_pool(std::shared_ptr<utils::thread_pool> new_pool) { decode_pool_ = std::move(new_pool); }
+};
+
+}
+
+#endif /* _SHADERTOY_TEXTURE_BUDGET_HPP_ */
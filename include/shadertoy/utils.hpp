@@ -5,4 +5,10 @@
 
 #include "shadertoy/utils/input_loader.hpp"
 
+#include "shadertoy/utils/shader_reloader.hpp"
+
+#include "shadertoy/utils/texture_cache.hpp"
+
+#include "shadertoy/utils/thread_pool.hpp"
+
 #endif /* _SHADERTOY_UTILS_HPP_ */
@@ -60,6 +60,54 @@ public:
 	exr_input_factory();
 };
 
+class ktx_input_factory : public input_factory
+{
+	const std::string type_name_;
+
+public:
+	inline int priority() const override { return 60; }
+
+	bool supported(const std::map<std::string, std::string> &spec) const override;
+
+	std::unique_ptr<inputs::basic_input> create(const std::map<std::string, std::string> &spec) const override;
+
+	inline const std::string &type_name() const override { return type_name_; }
+
+	ktx_input_factory();
+};
+
+class qoi_input_factory : public input_factory
+{
+	const std::string type_name_;
+
+public:
+	inline int priority() const override { return 50; }
+
+	bool supported(const std::map<std::string, std::string> &spec) const override;
+
+	std::unique_ptr<inputs::basic_input> create(const std::map<std::string, std::string> &spec) const override;
+
+	inline const std::string &type_name() const override { return type_name_; }
+
+	qoi_input_factory();
+};
+
+class hdr_input_factory : public input_factory
+{
+	const std::string type_name_;
+
+public:
+	inline int priority() const override { return 50; }
+
+	bool supported(const std::map<std::string, std::string> &spec) const override;
+
+	std::unique_ptr<inputs::basic_input> create(const std::map<std::string, std::string> &spec) const override;
+
+	inline const std::string &type_name() const override { return type_name_; }
+
+	hdr_input_factory();
+};
+
 class noise_input_factory : public input_factory
 {
 	const std::string type_name_;
@@ -92,6 +140,22 @@ public:
 	checker_input_factory();
 };
 
+class sequence_input_factory : public input_factory
+{
+	const std::string type_name_;
+
+public:
+	inline int priority() const override { return 50; }
+
+	inline bool supported(const std::map<std::string, std::string> &spec) const override { return true; }
+
+	std::unique_ptr<inputs::basic_input> create(const std::map<std::string, std::string> &spec) const override;
+
+	inline const std::string &type_name() const override { return type_name_; }
+
+	sequence_input_factory();
+};
+
 /** @endcond */
 }
 }
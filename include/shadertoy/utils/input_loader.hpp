@@ -21,6 +21,12 @@ class shadertoy_EXPORT input_loader
 {
 	std::set<std::unique_ptr<input_factory>, input_factory_ptr_comparator> factories_;
 
+	/// Pool for decoding file inputs, or null to decode them synchronously
+	std::shared_ptr<thread_pool> decode_pool_;
+
+	/// Cache for sharing image inputs, or null to create a new input every time
+	std::shared_ptr<texture_cache> cache_;
+
 public:
 	/**
 	 * @brief Create an input loader that supports builtin types
@@ -49,11 +55,19 @@ public:
 	 *
 	 * The file URI scheme is dispatched to the corresponding loader depending
 	 * on the file name extension, and supported loaders that have been built
-	 * into the library.
+	 * into the library. KTX2 and DDS containers are loaded by
+	 * inputs::ktx_input, which uploads their stored mipmaps as is.
+	 * JPEG images accept a max_size parameter, see
+	 * inputs::jpeg_input#max_dimension. EXR images accept a layer parameter,
+	 * see inputs::exr_input#layer.
 	 *
 	 * The noise URI scheme creates an inputs::noise_input with the given
 	 * parameters.
 	 *
+	 * If a cache is set (see input_loader#cache), image inputs are returned
+	 * as inputs::shared_input instances sharing the texture of identical
+	 * inputs. Procedural inputs such as noise are always created.
+	 *
 	 * @param input            URI that represents the input to be created
 	 * @param throw_on_failure true if the method should throw an exception
 	 *                         instead of returning a null input
@@ -61,6 +75,41 @@ public:
 	 * @return Created input, or null of no input factory was found
 	 */
 	std::unique_ptr<inputs::basic_input> create(const std::string &input, bool throw_on_failure = true) const;
+
+	/**
+	 * @brief Get the pool used for decoding file inputs
+	 *
+	 * @return Pointer to the decoding pool, or null if file inputs are decoded
+	 *         synchronously
+	 */
+	inline const std::shared_ptr<thread_pool> &decode_pool() const { return decode_pool_; }
+
+	/**
+	 * @brief Set the pool used for decoding file inputs
+	 *
+	 * File inputs created by this loader after this call decode their images
+	 * on \p new_pool, see inputs::file_input#decode_pool. Their texture is a
+	 * placeholder until decoding completes. This is disabled by default.
+	 *
+	 * @param new_pool Decoding pool, or null to decode file inputs synchronously
+	 */
+	inline void decode_pool(std::shared_ptr<thread_pool> new_pool) { decode_pool_ = std::move(new_pool); }
+
+	/**
+	 * @brief Get the cache used for sharing image inputs
+	 *
+	 * @return Pointer to the texture cache, or null if inputs are not shared
+	 */
+	inline const std::shared_ptr<texture_cache> &cache() const { return cache_; }
+
+	/**
+	 * @brief Set the cache used for sharing image inputs
+	 *
+	 * The same cache may be used by several loaders. This is disabled by default.
+	 *
+	 * @param new_cache Texture cache, or null to create a new input every time
+	 */
+	inline void cache(std::shared_ptr<texture_cache> new_cache) { cache_ = std::move(new_cache); }
 };
 }
 }
@@ -6,6 +6,8 @@
 #include "shadertoy/spdlog/spdlog.h"
 #include "shadertoy/spdlog/fmt/ostr.h"
 
+#include <mutex>
+
 namespace shadertoy
 {
 namespace utils
@@ -14,12 +16,14 @@ namespace utils
 /// Logging utility class for shadertoy
 class shadertoy_EXPORT log
 {
-	static bool initialized_;
+	static std::once_flag initialized_;
 
 public:
 	/**
 	 * @brief Get the default logger instance for libshadertoy
 	 *
+	 * The logger is thread-safe, as inputs may be decoded on worker threads.
+	 *
 	 * @return Pointer to the logger instance for libshadertoy
 	 */
 	static std::shared_ptr<spdlog::logger> shadertoy();
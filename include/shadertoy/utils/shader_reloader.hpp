@@ -0,0 +1,111 @@
+#ifndef _SHADERTOY_UTILS_SHADER_RELOADER_HPP_
+#define _SHADERTOY_UTILS_SHADER_RELOADER_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace shadertoy
+{
+namespace utils
+{
+
+/**
+ * @brief Watches the source files of program buffers and reloads their
+ * programs when the files change
+ *
+ * Changes are detected using inotify, which is only available on Linux. On
+ * other platforms, shader_reloader#supported returns false and
+ * shader_reloader#update does nothing.
+ *
+ * Reloaded programs are compiled without blocking the rendering loop (see
+ * buffers::program_buffer#reload), and the buffers keep rendering with their
+ * current program until the new one is ready. Programs that fail to compile
+ * are discarded, and the error is logged.
+ *
+ * Files included by the watched files (see source_cache) are watched too,
+ * once they have been read through the source cache of the rendering context.
+ *
+ * All methods must be called from the thread owning the OpenGL context.
+ */
+class shadertoy_EXPORT shader_reloader
+{
+	/// inotify instance, -1 if not supported
+	int fd_;
+
+	/// Watched directories, by watch descriptor
+	std::map<int, std::string> directories_;
+
+	/// Watched buffers, by source file path
+	std::multimap<std::string, std::weak_ptr<buffers::program_buffer>> buffers_;
+
+	/// Buffers with a reload in progress
+	std::vector<std::weak_ptr<buffers::program_buffer>> reloading_;
+
+	/// Generation of the source cache when included files were last watched
+	uint64_t source_generation_;
+
+	/// Watch a directory for file changes
+	void watch_directory(const std::string &directory);
+
+public:
+	/**
+	 * @brief Initialize a new shader_reloader
+	 */
+	shader_reloader();
+
+	~shader_reloader();
+
+	shader_reloader(const shader_reloader &) = delete;
+	shader_reloader &operator=(const shader_reloader &) = delete;
+
+	/**
+	 * @brief Check if file watching is supported on this platform
+	 *
+	 * @return true if file watching is supported, false otherwise
+	 */
+	static bool supported();
+
+	/**
+	 * @brief Reload the program of \p buffer when its source file changes
+	 *
+	 * @param buffer Buffer to watch. Its source must be a compiler::file_part.
+	 *
+	 * @throws shadertoy_error The buffer source is not a file, or the file could not be watched
+	 */
+	void watch(const std::shared_ptr<buffers::program_buffer> &buffer);
+
+	/**
+	 * @brief Reload the program of \p buffer when \p path changes
+	 *
+	 * This can be used for files which are not the buffer source, such as
+	 * files used by the program template.
+	 *
+	 * @param buffer Buffer to watch
+	 * @param path   Path to the file to watch
+	 *
+	 * @throws shadertoy_error The file could not be watched
+	 */
+	void watch(const std::shared_ptr<buffers::program_buffer> &buffer, const std::string &path);
+
+	/**
+	 * @brief Process file change events, and swap in the reloaded programs
+	 * that are ready
+	 *
+	 * This should be called once per frame, before rendering. It does not
+	 * block on file events.
+	 *
+	 * @param context Rendering context to compile the programs with
+	 *
+	 * @return Number of buffers whose program has been replaced
+	 */
+	size_t update(const render_context &context);
+};
+}
+}
+
+#endif /* _SHADERTOY_UTILS_SHADER_RELOADER_HPP_ */
@@ -0,0 +1,127 @@
+#ifndef _SHADERTOY_UTILS_TEXTURE_CACHE_HPP_
+#define _SHADERTOY_UTILS_TEXTURE_CACHE_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace shadertoy
+{
+namespace utils
+{
+
+/**
+ * @brief Cache of the inputs created by an input_loader, to share their textures
+ *
+ * Inputs are keyed by their canonical URI (see texture_cache#key), so the same
+ * image used by several buffers is only decoded and uploaded once. Users of a
+ * cached input get an inputs::shared_input, which has its own sampler state.
+ *
+ * The cache does not own the inputs: they are reference-counted by the
+ * shared_input instances using them, and released with the last of them.
+ */
+class shadertoy_EXPORT texture_cache
+{
+	/// Cached inputs, by key
+	std::map<std::string, std::weak_ptr<inputs::basic_input>> inputs_;
+
+	/// Number of lookups which found a cached input
+	size_t hits_;
+
+	/// Number of inputs which were created and added to the cache
+	size_t misses_;
+
+public:
+	/**
+	 * @brief Initialize a new empty texture cache
+	 */
+	texture_cache();
+
+	/**
+	 * @brief Compute the cache key of an input specification
+	 *
+	 * For the file scheme, the path is made canonical so different spellings
+	 * of the same file share the same key. Query parameters (such as vflip or
+	 * format) are part of the key, since they may change the pixel contents.
+	 *
+	 * @param scheme URI scheme of the input
+	 * @param spec   Input specification, as given to input_factory#create
+	 *
+	 * @return Key of the input in this cache
+	 */
+	static std::string key(const std::string &scheme, const std::map<std::string, std::string> &spec);
+
+	/**
+	 * @brief Find a cached input
+	 *
+	 * @param key Key of the input
+	 *
+	 * @return Pointer to the cached input, or null if it is not in use anymore
+	 */
+	std::shared_ptr<inputs::basic_input> find(const std::string &key);
+
+	/**
+	 * @brief Add an input to this cache
+	 *
+	 * This counts as a cache miss, since the input had to be created.
+	 *
+	 * @param key   Key of the input
+	 * @param input Input to share
+	 */
+	void emplace(const std::string &key, const std::shared_ptr<inputs::basic_input> &input);
+
+	/**
+	 * @brief Get the number of cached inputs which are still in use
+	 *
+	 * @return Number of cached inputs
+	 */
+	size_t size() const;
+
+	/**
+	 * @brief Get the number of lookups which found a cached input
+	 *
+	 * @return Number of cache hits
+	 */
+	inline size_t hits() const { return hits_; }
+
+	/**
+	 * @brief Get the number of inputs which were created and cached
+	 *
+	 * @return Number of cache misses
+	 */
+	inline size_t misses() const { return misses_; }
+
+	/**
+	 * @brief Get the ratio of inputs which were shared instead of created
+	 *
+	 * @return Hit rate, between 0 and 1
+	 */
+	double hit_rate() const;
+
+	/**
+	 * @brief Get the device memory used by the cached textures
+	 *
+	 * Only inputs which have already been loaded and used are accounted for,
+	 * and they are not used by this method. This queries the OpenGL context,
+	 * so it must be called on the rendering thread.
+	 *
+	 * @return Size in bytes of the cached textures, including their mipmaps
+	 */
+	size_t resident_bytes() const;
+
+	/**
+	 * @brief Estimate the device memory used by a texture
+	 *
+	 * @param texture Texture to inspect
+	 *
+	 * @return Size in bytes of the levels of \p texture
+	 */
+	static size_t texture_bytes(const gl::texture &texture);
+};
+}
+}
+
+#endif /* _SHADERTOY_UTILS_TEXTURE_CACHE_HPP_ */
@@ -0,0 +1,100 @@
+#ifndef _SHADERTOY_UTILS_THREAD_POOL_HPP_
+#define _SHADERTOY_UTILS_THREAD_POOL_HPP_
+
+#include "shadertoy/pre.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace shadertoy
+{
+namespace utils
+{
+
+/**
+ * @brief Fixed-size pool of worker threads running CPU-bound tasks
+ *
+ * Tasks must not use the OpenGL context, which is only current on the
+ * rendering thread. They are run in submission order.
+ */
+class shadertoy_EXPORT thread_pool
+{
+	/// Worker threads
+	std::vector<std::thread> workers_;
+
+	/// Tasks waiting for a worker
+	std::deque<std::function<void()>> tasks_;
+
+	/// Mutex protecting tasks_ and stopping_
+	std::mutex mutex_;
+
+	/// Signaled when a task is queued or the pool is stopping
+	std::condition_variable condition_;
+
+	/// true if the workers should exit once the queue is empty
+	bool stopping_;
+
+	/// Worker thread loop
+	void run();
+
+public:
+	/**
+	 * @brief Start a new thread pool
+	 *
+	 * @param threads Number of worker threads. If 0, the number of hardware
+	 *                threads is used.
+	 */
+	explicit thread_pool(unsigned int threads = 0);
+
+	/**
+	 * @brief Complete the queued tasks and stop the worker threads
+	 */
+	~thread_pool();
+
+	thread_pool(const thread_pool &) = delete;
+	thread_pool &operator=(const thread_pool &) = delete;
+
+	/**
+	 * @brief Queue a task to run on a worker thread
+	 *
+	 * @param task Task to run
+	 */
+	void enqueue(std::function<void()> task);
+
+	/**
+	 * @brief Queue a task to run on a worker thread
+	 *
+	 * @param task Task to run
+	 *
+	 * @return Future holding the result of \p task, or the exception it threw
+	 */
+	template <typename Callable> auto submit(Callable &&task) -> std::future<std::invoke_result_t<Callable>>
+	{
+		auto packaged(std::make_shared<std::packaged_task<std::invoke_result_t<Callable>()>>(
+		std::forward<Callable>(task)));
+		auto future(packaged->get_future());
+
+		enqueue([packaged]() { (*packaged)(); });
+
+		return future;
+	}
+
+	/**
+	 * @brief Get the number of worker threads
+	 *
+	 * @return Number of worker threads of this pool
+	 */
+	inline size_t size() const
+	{ return workers_.size(); }
+};
+}
+}
+
+#endif /* _SHADERTOY_UTILS_THREAD_POOL_HPP_ */
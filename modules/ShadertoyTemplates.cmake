@@ -0,0 +1,185 @@
+# Embed shader templates in C++ sources, pre-parsed at build time.
+# See shadertoy::compiler::shader_template::from_embedded.
+#
+# Usage in a project:
+#   shadertoy_add_templates(<target> <namespace> <file>...)
+#
+# This generates <target>_templates.hpp in the current binary directory,
+# which declares for every file (with <id> being the file name where dots,
+# spaces and dashes are replaced with underscores):
+#   <namespace>::<id>           Raw contents of the file
+#   <namespace>::<id>_size      Size of the file contents
+#   <namespace>::<id>_template  Pre-parsed template parts of the file
+cmake_policy(VERSION 3.10)
+
+set(_SHADERTOY_TEMPLATES_SCRIPT ${CMAKE_CURRENT_LIST_FILE})
+
+# Set <out_var> to the C identifier for <file>
+function(shadertoy_embed_identifier file out_var)
+	# Get short filename
+	get_filename_component(filename ${file} NAME)
+	# Replace filename spaces & extension separator for C compatibility
+	string(REGEX REPLACE "\\.| |-" "_" filename ${filename})
+	set(${out_var} ${filename} PARENT_SCOPE)
+endfunction()
+
+# Append the contents of <file> to the generated sources as <namespace>::<id>
+# Cf. http://stackoverflow.com/a/27206982
+function(shadertoy_embed_data file output output_h namespace id)
+	# Read hex data from file
+	file(READ ${file} filedata HEX)
+	# Convert hex data for C compatibility
+	string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," filedata ${filedata})
+	# Append data to output file
+	file(APPEND ${output} "const char ${namespace}::${id}[] = {${filedata}};\nconst size_t ${namespace}::${id}_size = sizeof(${namespace}::${id});\n")
+	file(APPEND ${output_h} "extern const char ${id}[];\nextern const size_t ${id}_size;\n")
+endfunction()
+
+# Split <file> into template parts, and append them to the generated sources
+# as <namespace>::<id>_template. This follows the same rules as
+# shadertoy::compiler::shader_template::parse.
+function(shadertoy_embed_template file output output_h namespace id)
+	file(READ ${file} content)
+	string(LENGTH "${content}" size)
+
+	# Whitespace, except line breaks: \t \v \f \r and space
+	string(ASCII 9 11 12 13 32 ws)
+	set(directive "^[${ws}]*#pragma[${ws}]+shadertoy[${ws}]+part[${ws}]+")
+	set(part_name "(\\*|[a-zA-Z_][a-zA-Z0-9_-]*):[a-zA-Z_][a-zA-Z0-9_-]*")
+
+	set(entries "")
+	set(in_part FALSE)
+	set(part_start 0)
+	set(pos 0)
+	set(line_num 1)
+
+	while(pos LESS size)
+		# Extract the current line, without its line break
+		string(SUBSTRING "${content}" ${pos} -1 rest)
+		string(FIND "${rest}" "\n" line_length)
+		if(line_length EQUAL -1)
+			string(LENGTH "${rest}" line_length)
+			math(EXPR next "${pos} + ${line_length}")
+		else()
+			math(EXPR next "${pos} + ${line_length} + 1")
+		endif()
+		string(SUBSTRING "${rest}" 0 ${line_length} line)
+
+		if("${line}" MATCHES "${directive}end[${ws}]*$")
+			if(NOT in_part)
+				message(FATAL_ERROR "${file}:${line_num}: unmatched end")
+			endif()
+
+			math(EXPR length "${pos} - ${part_start}")
+			string(APPEND entries "\t{ \"${template_name}\", ${part_start}, ${length}, true },\n")
+
+			set(in_part FALSE)
+			set(part_start ${next})
+		elseif("${line}" MATCHES "${directive}(${part_name})([${ws}]+begin)?[${ws}]*$")
+			set(name "${CMAKE_MATCH_1}")
+			set(begin "${CMAKE_MATCH_3}")
+
+			if(in_part)
+				if(begin)
+					message(FATAL_ERROR "${file}:${line_num}: unexpected template begin for \"${name}\"")
+				else()
+					message(FATAL_ERROR "${file}:${line_num}: unexpected template slot \"${name}\"")
+				endif()
+			endif()
+
+			# Source before the directive is an anonymous part
+			if(pos GREATER part_start)
+				math(EXPR length "${pos} - ${part_start}")
+				string(APPEND entries "\t{ nullptr, ${part_start}, ${length}, true },\n")
+			endif()
+
+			if(begin)
+				set(in_part TRUE)
+				set(template_name "${name}")
+			else()
+				string(APPEND entries "\t{ \"${name}\", 0, 0, false },\n")
+			endif()
+
+			set(part_start ${next})
+		endif()
+
+		set(pos ${next})
+		math(EXPR line_num "${line_num} + 1")
+	endwhile()
+
+	if(in_part)
+		message(FATAL_ERROR "${file}:${line_num}: unexpected end of file while looking for end part \"${template_name}\"")
+	endif()
+
+	if(size GREATER part_start)
+		math(EXPR length "${size} - ${part_start}")
+		string(APPEND entries "\t{ nullptr, ${part_start}, ${length}, true },\n")
+	endif()
+
+	if(entries)
+		file(APPEND ${output} "static constexpr shadertoy::compiler::embedded_part ${id}_parts[] = {\n${entries}};\n")
+		set(parts "${id}_parts, sizeof(${id}_parts) / sizeof(${id}_parts[0])")
+	else()
+		set(parts "nullptr, 0")
+	endif()
+
+	file(APPEND ${output} "const shadertoy::compiler::embedded_template ${namespace}::${id}_template = { ${namespace}::${id}, ${namespace}::${id}_size, ${parts} };\n")
+	file(APPEND ${output_h} "extern const shadertoy::compiler::embedded_template ${id}_template;\n")
+endfunction()
+
+# Generate <output> and <output_h> embedding <files> in <namespace>
+function(shadertoy_generate_templates output output_h h_id namespace)
+	# Create empty output file
+	file(WRITE ${output} "#include \"${output_h}\"\n\n")
+	file(WRITE ${output_h} "#ifndef ${h_id}\n#define ${h_id}\n\n#include <cstddef>\n\n#include \"shadertoy/compiler/embedded_template.hpp\"\n\nnamespace ${namespace} {\n")
+
+	# Iterate through input files
+	foreach(file ${ARGN})
+		shadertoy_embed_identifier(${file} id)
+		shadertoy_embed_data(${file} ${output} ${output_h} ${namespace} ${id})
+		shadertoy_embed_template(${file} ${output} ${output_h} ${namespace} ${id})
+	endforeach()
+
+	# Complete .h
+	file(APPEND ${output} "\n")
+	file(APPEND ${output_h} "\n}\n#endif /* ${h_id} */\n")
+endfunction()
+
+if(CMAKE_SCRIPT_MODE_FILE)
+	if(SHADERTOY_TEMPLATES_OUTPUT)
+		# Invoked by shadertoy_add_templates
+		string(REPLACE "|" ";" files "${SHADERTOY_TEMPLATES_FILES}")
+		shadertoy_generate_templates(${SHADERTOY_TEMPLATES_OUTPUT} ${SHADERTOY_TEMPLATES_H_OUTPUT}
+									 ${SHADERTOY_TEMPLATES_H_ID} ${SHADERTOY_TEMPLATES_NAMESPACE} ${files})
+	endif()
+else()
+	# Embed pre-parsed templates in <target>
+	function(shadertoy_add_templates target namespace)
+		set(output ${CMAKE_CURRENT_BINARY_DIR}/${target}_templates.cpp)
+		set(output_h ${CMAKE_CURRENT_BINARY_DIR}/${target}_templates.hpp)
+		string(MAKE_C_IDENTIFIER "_${target}_TEMPLATES_HPP_" h_id)
+		string(TOUPPER ${h_id} h_id)
+
+		set(files "")
+		foreach(file ${ARGN})
+			get_filename_component(file ${file} ABSOLUTE)
+			list(APPEND files ${file})
+		endforeach()
+		string(REPLACE ";" "|" files_arg "${files}")
+
+		add_custom_command(
+			OUTPUT ${output} ${output_h}
+			DEPENDS ${files} ${_SHADERTOY_TEMPLATES_SCRIPT}
+			COMMAND ${CMAKE_COMMAND}
+				"-DSHADERTOY_TEMPLATES_FILES=${files_arg}"
+				-DSHADERTOY_TEMPLATES_NAMESPACE=${namespace}
+				-DSHADERTOY_TEMPLATES_OUTPUT=${output}
+				-DSHADERTOY_TEMPLATES_H_OUTPUT=${output_h}
+				-DSHADERTOY_TEMPLATES_H_ID=${h_id}
+				-P ${_SHADERTOY_TEMPLATES_SCRIPT}
+			COMMENT "Embedding shader templates for ${target}")
+
+		target_sources(${target} PRIVATE ${output})
+		target_include_directories(${target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR})
+	endfunction()
+endif()
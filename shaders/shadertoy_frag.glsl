@@ -27,10 +27,13 @@ layout(binding = 3) uniform sampler2D iChannel3;
 uniform vec4 iDate;
 uniform float iSampleRate;
 
+#pragma shadertoy part *:libraries
 #pragma shadertoy part buffer:inputs
 #pragma shadertoy part buffer:sources
 
+#pragma shadertoy part glsl:main begin
 void main(void) {
 	fragColor = vec4(0., 0., 0., 1.);
 	mainImage(fragColor, vtexCoord.xy * iResolution.xy);
 }
+#pragma shadertoy part end
@@ -3,6 +3,7 @@
 #include <utility>
 
 #include "shadertoy/gl.hpp"
+#include "shadertoy/utils/log.hpp"
 
 #include "shadertoy/buffers/basic_buffer.hpp"
 #include "shadertoy/render_context.hpp"
@@ -25,6 +26,16 @@ void basic_buffer::init(const render_context &context, const io_resource &io)
 	init_contents(context, io);
 }
 
+void basic_buffer::prepare(const render_context &context, const io_resource &io)
+{
+	// Start preparing buffer contents
+	prepare_contents(context, io);
+}
+
+void basic_buffer::prepare_contents(const render_context &context, const io_resource &io)
+{
+}
+
 void basic_buffer::allocate_textures(const render_context &context, const io_resource &io)
 {
 	// Allocate content resources
@@ -58,3 +69,12 @@ std::optional<std::vector<buffer_output>> basic_buffer::get_buffer_outputs() con
 {
 	return std::nullopt;
 }
+
+std::shared_ptr<basic_buffer> basic_buffer::clone() const
+{
+	throw shadertoy_error(fmt::format("Buffer {} ({}) cannot be cloned", id_, static_cast<const void *>(this)));
+}
+
+void basic_buffer::remap_members(const members::member_map_t &clones)
+{
+}
@@ -21,6 +21,14 @@ geometry_buffer::geometry_buffer(const std::string &id)
 {
 }
 
+std::shared_ptr<basic_buffer> geometry_buffer::clone() const
+{
+	auto result(std::make_shared<geometry_buffer>(id()));
+	clone_to(*result);
+	result->geometry_ = geometry_;
+	return result;
+}
+
 void geometry_buffer::init_geometry(const render_context &context, const io_resource &io)
 {
 	// We assume the geometry is initialized by the caller
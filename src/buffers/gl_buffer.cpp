@@ -38,6 +38,14 @@ void gl_buffer::allocate_contents(const render_context &context, const io_resour
 				 id(), static_cast<const void *>(this));
 
 	target_rbo_.storage(GL_DEPTH_COMPONENT, size.width, size.height);
+
+	// Attach the color targets, so the framebuffer does not keep referencing
+	// textures from a previous allocation
+	if (io.swap_policy() != member_swap_policy::default_framebuffer)
+	{
+		auto fbo_bind(gl::get_bind_guard(target_fbo_, GL_DRAW_FRAMEBUFFER));
+		attach_framebuffer_outputs(fbo_bind, io);
+	}
 }
 
 void gl_buffer::render_contents(const render_context &context, const io_resource &io,
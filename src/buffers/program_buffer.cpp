@@ -3,10 +3,14 @@
 #include "shadertoy/gl.hpp"
 
 #include "shadertoy/inputs/basic_input.hpp"
+#include "shadertoy/inputs/buffer_input.hpp"
 #include "shadertoy/inputs/error_input.hpp"
 
 #include "shadertoy/buffers/program_buffer.hpp"
+#include "shadertoy/program_cache.hpp"
+#include "shadertoy/program_registry.hpp"
 #include "shadertoy/render_context.hpp"
+#include "shadertoy/texture_budget.hpp"
 
 #include "shadertoy/compiler/file_part.hpp"
 #include "shadertoy/compiler/input_part.hpp"
@@ -23,19 +27,17 @@ using shadertoy::utils::log;
 program_buffer::program_buffer(const std::string &id)
 : gl_buffer(id),
 
-  source_map_(nullptr)
+  source_map_(nullptr), prepared_(false)
 {
 }
 
-void program_buffer::init_contents(const render_context &context, const io_resource &io)
+const compiler::program_template &program_buffer::current_template(const render_context &context) const
 {
-	// Initialize the geometry
-	log::shadertoy()->trace("Loading geometry for {} ({})", id(), static_cast<const void *>(this));
-	init_geometry(context, io);
-
-	// Shader objects
-	log::shadertoy()->trace("Compiling program for {} ({})", id(), static_cast<const void *>(this));
+	return override_program_ ? *override_program_ : context.buffer_template();
+}
 
+compiler::program_template::sources_map program_buffer::specify_sources(const render_context &context) const
+{
 	// Load the fragment shader for this buffer
 	std::vector<std::unique_ptr<compiler::basic_part>> fs_template_parts;
 
@@ -43,37 +45,285 @@ void program_buffer::init_contents(const render_context &context, const io_resou
 	fs_template_parts.emplace_back(std::make_unique<compiler::input_part>("buffer:inputs", inputs_));
 	if (source_)
 	{
-		fs_template_parts.emplace_back(source_->clone());
+		std::unique_ptr<compiler::basic_part> source(source_->clone());
+
+		// Read source files through the context cache
+		auto file = dynamic_cast<compiler::file_part *>(source.get());
+		if (file != nullptr && !file->cache())
+		{
+			file->cache(context.source_files());
+		}
+
+		fs_template_parts.emplace_back(std::move(source));
 	}
 
 	// Compile
 	std::map<GLenum, std::vector<std::unique_ptr<compiler::basic_part>>> parts;
 	parts.emplace(GL_FRAGMENT_SHADER, std::move(fs_template_parts));
 
-	const auto &buffer_template(override_program_ ? *override_program_ : context.buffer_template());
-	program_ = buffer_template.compile(std::move(parts), source_map_);
-
-	// Use the program
-	program_.use();
+	return current_template(context).specify_sources(std::move(parts));
+}
 
+void program_buffer::init_program(const render_context &context)
+{
 	// Discover program interface
-	program_interface_ = std::make_unique<program_interface>(program_);
+	program_->interface = std::make_unique<program_interface>(program_->program);
+
+	if (const auto &cache = context.binary_cache())
+	{
+		cache->store(program_->cache_key, program_->program, *program_->interface);
+	}
+}
+
+void program_buffer::store_source_map(const compiler::program_template &buffer_template,
+									  const compiler::program_template::sources_map &sources) const
+{
+	if (source_map_ == nullptr)
+	{
+		return;
+	}
+
+	// Record the same code as submit_sources does when compiling
+	*source_map_ = buffer_template.compiled_code(sources);
+}
+
+void program_buffer::apply_uniform_state() const
+{
+	for (const auto &pair : uniform_state_)
+	{
+		if (auto resource = program_->interface->uniforms().try_get(pair.first))
+		{
+			pair.second->apply(resource->get_location(program_->program));
+		}
+	}
+}
+
+void program_buffer::init_pipeline(const render_context &context)
+{
+	const auto &buffer_template(current_template(context));
+
+	if (!buffer_template.separable())
+	{
+		pipeline_.reset();
+		return;
+	}
+
+	// Use the buffer program for all its stages, and the shared programs for
+	// the pre-compiled stages
+	pipeline_ = std::make_unique<gl::program_pipeline>();
+	pipeline_->use_program_stages(GL_ALL_SHADER_BITS, program_->program);
+
+	for (const auto &pair : buffer_template.stage_programs())
+	{
+		pipeline_->use_program_stages(gl::program_pipeline::stage_bit(pair.first), pair.second);
+	}
+}
+
+void program_buffer::bind_input_units()
+{
+	// Use the program
+	program_->program.use();
 
 	log::shadertoy()->debug("Program {} ({}) has {} uniform inputs",
 							id(), static_cast<const void *>(this),
-							program_interface_->uniforms().resources().size());
+							program_->interface->uniforms().resources().size());
 
 	// Set input uniform units
 	size_t current_unit = 0;
 	for (auto it = inputs_.begin(); it != inputs_.end(); ++it, ++current_unit)
 	{
-		if (auto resource = program_interface_->uniforms().try_get(it->sampler_name()))
+		if (auto resource = program_->interface->uniforms().try_get(it->sampler_name()))
 		{
-			resource->get_location(program_).set_value(static_cast<GLint>(current_unit));
+			resource->get_location(program_->program).set_value(static_cast<GLint>(current_unit));
 		}
 	}
 }
 
+void program_buffer::prepare_contents(const render_context &context, const io_resource &io)
+{
+	// Shader objects
+	log::shadertoy()->trace("Compiling program for {} ({})", id(), static_cast<const void *>(this));
+
+	auto sources(specify_sources(context));
+	const auto &buffer_template(current_template(context));
+	const auto &registry(context.programs());
+
+	reload_program_.reset();
+	prepared_ = true;
+
+	// Share the program of an identical buffer
+	program_key_ = program_registry::key(buffer_template, sources);
+	program_ = registry->find(program_key_);
+
+	if (program_)
+	{
+		log::shadertoy()->debug("Sharing program {:016x} for {} ({})", program_key_.hash, id(),
+								static_cast<const void *>(this));
+
+		store_source_map(buffer_template, sources);
+		return;
+	}
+
+	program_ = registry->emplace(program_key_);
+
+	if (const auto &cache = context.binary_cache())
+	{
+		// Try to load the program and its interface from the cache
+		bool separable = buffer_template.separable();
+		program_->cache_key = cache->key(buffer_template, sources);
+		program_->interface = cache->load(program_->cache_key, program_->program, separable);
+
+		if (program_->interface)
+		{
+			store_source_map(buffer_template, sources);
+			return;
+		}
+	}
+
+	// Submit the program, its status is checked in init_contents
+	if (source_map_ != nullptr)
+	{
+		source_map_->clear();
+	}
+
+	program_->pending = std::make_unique<compiler::deferred_program>(buffer_template.submit_sources(sources, source_map_));
+}
+
+void program_buffer::init_contents(const render_context &context, const io_resource &io)
+{
+	// Initialize the geometry
+	log::shadertoy()->trace("Loading geometry for {} ({})", id(), static_cast<const void *>(this));
+	init_geometry(context, io);
+
+	// Compile the program if it has not been prepared
+	if (!prepared_)
+	{
+		prepare_contents(context, io);
+	}
+
+	prepared_ = false;
+
+	// The first buffer sharing the program completes its compilation
+	if (program_->pending)
+	{
+		auto pending(std::move(program_->pending));
+
+		try
+		{
+			program_->program = pending->get();
+		}
+		catch (const shadertoy_error &ex)
+		{
+			log::shadertoy()->error("Failed to compile program for {} ({}): {}", id(),
+									static_cast<const void *>(this), ex.what());
+
+			// Let the next buffer using these sources try again
+			context.programs()->erase(program_key_);
+			throw;
+		}
+
+		init_program(context);
+	}
+
+	utils::throw_assert<shadertoy_error>(static_cast<bool>(program_->interface),
+										 "Failed to compile shared program for {} ({})", id(),
+										 static_cast<const void *>(this));
+
+	init_pipeline(context);
+	bind_input_units();
+}
+
+void program_buffer::reload(const render_context &context)
+{
+	log::shadertoy()->debug("Reloading program for {} ({})", id(), static_cast<const void *>(this));
+
+	std::unique_ptr<compiler::deferred_program> program;
+
+	try
+	{
+		auto sources(specify_sources(context));
+		const auto &buffer_template(current_template(context));
+
+		reload_key_ = program_registry::key(buffer_template, sources);
+
+		if (const auto &cache = context.binary_cache())
+		{
+			reload_cache_key_ = cache->key(buffer_template, sources);
+		}
+
+		// The source map holds the sources of the last submitted program
+		if (source_map_ != nullptr)
+		{
+			source_map_->clear();
+		}
+
+		program = std::make_unique<compiler::deferred_program>(buffer_template.submit_sources(sources, source_map_));
+	}
+	catch (const shadertoy_error &ex)
+	{
+		log::shadertoy()->error("Failed to reload program for {} ({}), keeping current program: {}", id(),
+								static_cast<const void *>(this), ex.what());
+		return;
+	}
+
+	// Replaces any reload still in progress
+	reload_program_ = std::move(program);
+}
+
+bool program_buffer::commit_reload(const render_context &context)
+{
+	if (!reload_program_ || !reload_program_->ready())
+	{
+		return false;
+	}
+
+	auto reloaded(std::move(reload_program_));
+	gl::program program;
+
+	try
+	{
+		program = reloaded->get();
+	}
+	catch (const shadertoy_error &ex)
+	{
+		log::shadertoy()->error("Failed to reload program for {} ({}), keeping current program: {}", id(),
+								static_cast<const void *>(this), ex.what());
+		return false;
+	}
+
+	// Swap the program and its interface. Other buffers sharing the previous
+	// program keep using it until they are reloaded too.
+	auto previous_outputs(get_buffer_outputs());
+	const auto &registry(context.programs());
+
+	auto shared(registry->find(reload_key_));
+	if (shared && shared->interface)
+	{
+		// An identical buffer has already been reloaded
+		program_ = std::move(shared);
+	}
+	else
+	{
+		program_ = registry->emplace(reload_key_);
+		program_->program = std::move(program);
+		program_->cache_key = reload_cache_key_;
+		init_program(context);
+		apply_uniform_state();
+	}
+
+	program_key_ = reload_key_;
+	init_pipeline(context);
+	bind_input_units();
+
+	auto outputs(get_buffer_outputs());
+	utils::warn_assert(previous_outputs->size() == outputs->size(),
+					   "Reloaded program for {} ({}) has {} outputs instead of {}, re-initialize the "
+					   "swap chain to update its targets",
+					   id(), static_cast<const void *>(this), outputs->size(), previous_outputs->size());
+
+	return true;
+}
+
 void program_buffer::render_gl_contents(const render_context &context, const io_resource &io)
 {
 	// Compute the rendering size from the current viewport
@@ -82,7 +332,23 @@ void program_buffer::render_gl_contents(const render_context &context, const io_
 	rsize size(viewport[2], viewport[3]);
 
 	// Setup program and its uniforms
-	program_.use();
+	if (pipeline_)
+	{
+		// The current program takes precedence over the bound pipeline
+		gl_call(glUseProgram, 0);
+		pipeline_->bind();
+	}
+	else
+	{
+		program_->program.use();
+	}
+
+	// Restore the uniform values of this buffer, which may have been changed
+	// by other buffers sharing the program
+	if (program_shared())
+	{
+		apply_uniform_state();
+	}
 
 	// Set iChannelResolution details
 	std::array<glm::vec3, SHADERTOY_ICHANNEL_COUNT> resolutions;
@@ -97,14 +363,19 @@ void program_buffer::render_gl_contents(const render_context &context, const io_
 		// Set the sampler uniform value
 		if (!it->sampler_name().empty())
 		{
-			if (auto sampler_uniform = program_interface_->try_get_uniform_location(it->sampler_name()))
+			if (auto sampler_uniform = program_->interface->try_get_uniform_location(it->sampler_name()))
 			{
 				sampler_uniform->set_value(static_cast<int>(current_unit));
 			}
 		}
 
-		// Bind the texture to the unit
-		if (input)
+		if (input && context.textures())
+		{
+			context.textures()->track(input);
+		}
+
+		// Bind the texture to the unit, inputs without texture use the error input
+		if (input && input->use())
 		{
 			auto texture(input->bind(current_unit));
 
@@ -123,19 +394,19 @@ void program_buffer::render_gl_contents(const render_context &context, const io_
 		}
 	}
 
-	if (auto channel_resolutions_resource = program_interface_->uniforms().try_get("iChannelResolution"))
+	if (auto channel_resolutions_resource = program_->interface->uniforms().try_get("iChannelResolution"))
 	{
-		channel_resolutions_resource->get_location(program_).set_value(resolutions.size(), resolutions.data());
+		channel_resolutions_resource->get_location(program_->program).set_value(resolutions.size(), resolutions.data());
 	}
 
 	// Set the current buffer resolution
-	if (auto resolution_resource = program_interface_->uniforms().try_get("iResolution"))
+	if (auto resolution_resource = program_->interface->uniforms().try_get("iResolution"))
 	{
-		resolution_resource->get_location(program_).set_value(glm::vec3(size.width, size.height, 1.f));
+		resolution_resource->get_location(program_->program).set_value(glm::vec3(size.width, size.height, 1.f));
 	}
 
 	// Try to set iTimeDelta
-	if (auto time_delta_resource = program_interface_->uniforms().try_get("iTimeDelta"))
+	if (auto time_delta_resource = program_->interface->uniforms().try_get("iTimeDelta"))
 	{
 		GLint available = 0;
 		time_delta_query().get_object_iv(GL_QUERY_RESULT_AVAILABLE, &available);
@@ -144,7 +415,7 @@ void program_buffer::render_gl_contents(const render_context &context, const io_
 			// Result available, set uniform value
 			GLuint64 timeDelta;
 			time_delta_query().get_object_ui64v(GL_QUERY_RESULT, &timeDelta);
-			time_delta_resource->get_location(program_).set_value(timeDelta / 1e9f);
+			time_delta_resource->get_location(program_->program).set_value(timeDelta / 1e9f);
 		}
 	}
 
@@ -165,9 +436,9 @@ void program_buffer::source_file(const std::string &new_file)
 std::optional<std::vector<buffer_output>> program_buffer::get_buffer_outputs() const
 {
 	std::vector<buffer_output> outputs;
-	outputs.reserve(program_interface_->outputs().resources().size());
+	outputs.reserve(program_->interface->outputs().resources().size());
 
-	for (const auto &output : program_interface_->outputs().resources())
+	for (const auto &output : program_->interface->outputs().resources())
 	{
 		log::shadertoy()->debug("Discovered program output #{} layout(location = {}) {:#x} {}",
 								outputs.size(), output.location, output.type, output.name);
@@ -177,3 +448,43 @@ std::optional<std::vector<buffer_output>> program_buffer::get_buffer_outputs() c
 
 	return outputs;
 }
+
+void program_buffer::clone_to(program_buffer &target) const
+{
+	target.inputs_ = inputs_;
+	target.override_program_ = override_program_;
+	target.source_ = source_ ? std::unique_ptr<compiler::basic_part>(source_->clone()) : nullptr;
+	target.uniform_state_.clear();
+	for (const auto &pair : uniform_state_)
+	{
+		target.uniform_state_.emplace(pair.first, pair.second->clone());
+	}
+}
+
+void program_buffer::remap_members(const members::member_map_t &clones)
+{
+	for (auto &input : inputs_)
+	{
+		auto buffer = std::dynamic_pointer_cast<inputs::buffer_input>(input.input());
+		if (!buffer)
+			continue;
+
+		auto member(buffer->member().lock());
+		auto it = member ? clones.find(member.get()) : clones.end();
+		if (it == clones.end())
+			continue;
+
+		// Read from the cloned member, with the same sampler state
+		auto remapped(std::make_shared<inputs::buffer_input>(it->second, buffer->output_name()));
+
+		for (GLenum pname : { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S,
+							  GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R })
+		{
+			GLint value;
+			buffer->sampler().get_parameter(pname, &value);
+			remapped->sampler().parameter(pname, value);
+		}
+
+		input.input(remapped);
+	}
+}
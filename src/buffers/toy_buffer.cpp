@@ -18,6 +18,13 @@ toy_buffer::toy_buffer(const std::string &id)
 {
 }
 
+std::shared_ptr<basic_buffer> toy_buffer::clone() const
+{
+	auto result(std::make_shared<toy_buffer>(id()));
+	clone_to(*result);
+	return result;
+}
+
 void toy_buffer::init_geometry(const render_context &context, const io_resource &io)
 {
 	// Just access the quad geometry so it is loaded now instead of during rendering
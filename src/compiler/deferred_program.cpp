@@ -0,0 +1,129 @@
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+
+#include "shadertoy/compiler/deferred_program.hpp"
+
+#include "shadertoy/shader_compiler.hpp"
+#include "shadertoy/spirv_compiler.hpp"
+
+using namespace shadertoy;
+using namespace shadertoy::compiler;
+
+void deferred_program::detach_shaders() const
+{
+	for (const auto &pair : shaders_)
+	{
+		program_.detach_shader(pair.first);
+	}
+
+	for (const auto *shader : precompiled_shaders_)
+	{
+		program_.detach_shader(*shader);
+	}
+}
+
+deferred_program::deferred_program(bool separable)
+: parallel_compile_(epoxy_has_gl_extension("GL_KHR_parallel_shader_compile") ||
+					epoxy_has_gl_extension("GL_ARB_parallel_shader_compile")),
+  link_pending_(false)
+{
+	if (separable)
+	{
+		program_.parameter(GL_PROGRAM_SEPARABLE, GL_TRUE);
+	}
+}
+
+void deferred_program::submit_shader(GLenum type, source_list sources)
+{
+	gl::shader so(type);
+	shader_compiler::submit(so, sources);
+
+	program_.attach_shader(so);
+	shaders_.emplace_back(std::move(so), std::move(sources));
+}
+
+void deferred_program::submit_module(GLenum type, const std::vector<uint32_t> &module,
+									 const std::map<GLuint, GLuint> &constants)
+{
+	gl::shader so(type);
+	spirv_compiler::load(so, module, constants);
+
+	// Errors from SPIR-V modules are reported during specialization, which
+	// does not refer to any source part
+	program_.attach_shader(so);
+	shaders_.emplace_back(std::move(so), source_list());
+}
+
+void deferred_program::attach_shader(const gl::shader &shader)
+{
+	program_.attach_shader(shader);
+	precompiled_shaders_.push_back(&shader);
+}
+
+void deferred_program::link()
+{
+	if (parallel_compile_)
+	{
+		program_.link_deferred();
+		return;
+	}
+
+	// Without background compilation, linking blocks: it is done by the next
+	// call to ready, so compiling and linking happen on different frames
+	link_pending_ = true;
+}
+
+bool deferred_program::ready()
+{
+	if (!parallel_compile_)
+	{
+		if (link_pending_)
+		{
+			link_pending_ = false;
+			program_.link_deferred();
+			return false;
+		}
+
+		return true;
+	}
+
+	// GL_COMPLETION_STATUS_KHR and GL_COMPLETION_STATUS_ARB share the same value
+	GLint status = GL_FALSE;
+	program_.get(GL_COMPLETION_STATUS_KHR, &status);
+
+	return status == GL_TRUE;
+}
+
+gl::program deferred_program::get()
+{
+	if (link_pending_)
+	{
+		link_pending_ = false;
+		program_.link_deferred();
+	}
+
+	try
+	{
+		// Check compilation results first, so errors are reported with the
+		// source part names rather than as a link failure
+		for (auto &pair : shaders_)
+		{
+			shader_compiler::check(pair.first, pair.second);
+		}
+
+		program_.check_link();
+	}
+	catch (...)
+	{
+		detach_shaders();
+		throw;
+	}
+
+	detach_shaders();
+
+	shaders_.clear();
+	precompiled_shaders_.clear();
+
+	return std::move(program_);
+}
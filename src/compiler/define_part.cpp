@@ -48,7 +48,7 @@ define_part::operator bool() const
 	return true;
 }
 
-std::vector<std::pair<std::string, std::string>> define_part::sources() const
+source_list define_part::sources() const
 {
-	return { std::make_pair(name(), definitions_->source()) };
+	return { make_source(name(), definitions_->source()) };
 }
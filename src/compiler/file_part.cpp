@@ -5,7 +5,7 @@
 
 #include "shadertoy/utils/assert.hpp"
 
-#include "read_contents.hpp"
+#include "shadertoy/source_cache.hpp"
 
 using namespace shadertoy::compiler;
 using namespace shadertoy::utils;
@@ -22,13 +22,19 @@ file_part::operator bool() const
 	return !source_file_.empty();
 }
 
-std::vector<std::pair<std::string, std::string>> file_part::sources() const
+source_list file_part::sources() const
 {
-	std::vector<std::pair<std::string, std::string>> result;
 	throw_assert<template_error>(!source_file_.empty(), "Template part {} is not specified", name());
 
-	log::shadertoy()->trace("Reading {}", source_file_);
-	result.emplace_back(source_file_, read_contents(source_file_));
-	return result;
-}
+	if (cache_)
+	{
+		return cache_->sources(source_file_);
+	}
+
+	if (!local_cache_)
+	{
+		local_cache_ = std::make_shared<source_cache>();
+	}
 
+	return local_cache_->sources(source_file_);
+}
@@ -16,7 +16,7 @@ input_part::operator bool() const
 	return true;
 }
 
-std::vector<std::pair<std::string, std::string>> input_part::sources() const
+source_list input_part::sources() const
 {
 	std::stringstream ss;
 
@@ -25,5 +25,5 @@ std::vector<std::pair<std::string, std::string>> input_part::sources() const
 		ss << input.definition_string() << std::endl;
 	}
 
-	return { std::make_pair(name(), ss.str()) };
+	return { make_source(name(), ss.str()) };
 }
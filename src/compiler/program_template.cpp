@@ -1,13 +1,17 @@
 #include <epoxy/gl.h>
+#include <cctype>
 #include <sstream>
 
 #include "shadertoy/gl.hpp"
 
 #include "shadertoy/compiler/program_template.hpp"
+#include "shadertoy/compiler/source_pruner.hpp"
 #include "shadertoy/compiler/template_error.hpp"
 #include "shadertoy/compiler/template_part.hpp"
 
+#include "shadertoy/program_cache.hpp"
 #include "shadertoy/shader_compiler.hpp"
+#include "shadertoy/spirv_compiler.hpp"
 
 #include "shadertoy/utils/assert.hpp"
 
@@ -16,54 +20,416 @@ using namespace shadertoy::compiler;
 using shadertoy::utils::throw_assert;
 using shadertoy::utils::log;
 
-shader_template program_template::specify_template_parts(const shader_template &source_template) const
+namespace
 {
-	std::vector<std::unique_ptr<basic_part>> parts;
-	return specify_template_parts(std::move(parts), source_template);
-}
 
-shader_template program_template::specify_template_parts(std::vector<std::unique_ptr<basic_part>> parts, const shader_template &source_template) const
+/**
+ * @brief Get the declarations of a GLSL source, by replacing the bodies of its
+ * functions with a semicolon
+ *
+ * Comments are removed, preprocessor directives and other declarations are
+ * kept as-is, except for the initializers of non-const global variables:
+ * those variables are defined by the library, and only declared by the
+ * shaders linked with it. Line breaks are preserved so line numbers match the
+ * source.
+ */
+std::string strip_function_bodies(const std::string &source)
 {
-	return source_template.specify_parts(
-	std::move(parts), [&](const std::string &part_name) -> std::vector<std::unique_ptr<compiler::basic_part>> {
-		auto sep = part_name.find(':');
-		std::vector<std::unique_ptr<compiler::basic_part>> result;
+	std::string result;
+	result.reserve(source.size());
+
+	int depth = 0;
+	// Depth at which the function body being skipped started, or 0
+	int skip_depth = 0;
+	bool line_start = true;
+	// Parentheses and brackets open at global scope, e.g. in layout qualifiers
+	int parens = 0;
+	// Start of the current global declaration in result
+	size_t statement_start = 0;
+	// Nesting level of the initializer being skipped, or -1
+	int initializer_depth = -1;
+
+	auto emit = [&](char c) {
+		if (skip_depth == 0 || c == '\n')
+			result.push_back(c);
+	};
+
+	auto last_token = [&result]() {
+		auto pos = result.find_last_not_of(" \t\r\n");
+		return pos == std::string::npos ? '\0' : result[pos];
+	};
+
+	auto is_const_statement = [&]() {
+		auto is_ident = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+
+		for (auto pos = result.find("const", statement_start); pos != std::string::npos;
+			 pos = result.find("const", pos + 1))
+		{
+			if ((pos == statement_start || !is_ident(result[pos - 1])) &&
+				(pos + 5 == result.size() || !is_ident(result[pos + 5])))
+				return true;
+		}
 
-		if (sep != std::string::npos)
+		return false;
+	};
+
+	for (size_t i = 0; i < source.size(); ++i)
+	{
+		char c = source[i];
+		char next = i + 1 < source.size() ? source[i + 1] : '\0';
+
+		if (c == '/' && next == '/')
 		{
-			std::string type_name(part_name.begin() + sep + 1, part_name.end());
-			std::string subpart_name(part_name.begin(), part_name.begin() + sep);
+			// Line comment
+			while (i + 1 < source.size() && source[i + 1] != '\n')
+				++i;
+			continue;
+		}
 
-			if (type_name == "defines")
+		if (c == '/' && next == '*')
+		{
+			// Block comment, only keep line breaks
+			for (i += 2; i < source.size() && !(source[i] == '*' && i + 1 < source.size() && source[i + 1] == '/'); ++i)
 			{
-				if (subpart_name == "*")
+				if (source[i] == '\n')
+					result.push_back('\n');
+			}
+
+			++i;
+			continue;
+		}
+
+		if (line_start && c == '#')
+		{
+			// Preprocessor directive, including line continuations
+			for (; i < source.size() && !(source[i] == '\n' && source[i - 1] != '\\'); ++i)
+				emit(source[i]);
+
+			if (i < source.size())
+				emit('\n');
+
+			if (depth == 0)
+				statement_start = result.size();
+
+			continue;
+		}
+
+		if (c == '\n')
+			line_start = true;
+		else if (c != ' ' && c != '\t' && c != '\r')
+			line_start = false;
+
+		if (initializer_depth >= 0)
+		{
+			// Skip the initializer up to the next declarator or the end of the declaration
+			if (c == '(' || c == '[' || c == '{')
+				++initializer_depth;
+			else if (c == ')' || c == ']' || c == '}')
+				--initializer_depth;
+
+			if (initializer_depth > 0 || (c != ',' && c != ';'))
+			{
+				if (c == '\n')
+					result.push_back(c);
+				continue;
+			}
+
+			initializer_depth = -1;
+		}
+
+		if (depth == 0)
+		{
+			if (c == '(' || c == '[')
+				++parens;
+			else if (c == ')' || c == ']')
+				--parens;
+			else if (c == '=' && parens == 0 && !is_const_statement())
+			{
+				// Initializer of a global variable, which is only defined by the library
+				initializer_depth = 0;
+				continue;
+			}
+		}
+
+		if (c == '{')
+		{
+			++depth;
+
+			// A block following a parameter list at global scope is a function body
+			if (depth == 1 && last_token() == ')')
+			{
+				result.push_back(';');
+				skip_depth = depth;
+				continue;
+			}
+		}
+		else if (c == '}')
+		{
+			if (depth == skip_depth)
+			{
+				--depth;
+				skip_depth = 0;
+				statement_start = result.size();
+				continue;
+			}
+
+			--depth;
+		}
+
+		emit(c);
+
+		if (depth == 0 && c == ';')
+			statement_start = result.size();
+	}
+
+	return result;
+}
+}
+
+std::vector<std::unique_ptr<basic_part>> program_template::resolve_part(GLenum type, const std::string &part_name, bool with_libraries) const
+{
+	auto sep = part_name.find(':');
+	std::vector<std::unique_ptr<compiler::basic_part>> result;
+
+	if (sep != std::string::npos)
+	{
+		std::string type_name(part_name.begin() + sep + 1, part_name.end());
+		std::string subpart_name(part_name.begin(), part_name.begin() + sep);
+
+		if (type_name == "defines")
+		{
+			if (subpart_name == "*")
+			{
+				std::transform(shader_defines_.begin(), shader_defines_.end(),
+							   std::back_inserter(result), [](const auto &pair) {
+								   return std::make_unique<compiler::define_part>(pair.first,
+																				  pair.second);
+							   });
+			}
+			else
+			{
+				auto it(shader_defines_.find(subpart_name));
+				if (it != shader_defines_.end())
 				{
-					std::transform(shader_defines_.begin(), shader_defines_.end(),
-								   std::back_inserter(result), [](const auto &pair) {
-									   return std::make_unique<compiler::define_part>(pair.first,
-																					  pair.second);
-								   });
+					result.emplace_back(std::make_unique<compiler::define_part>(part_name, it->second));
 				}
-				else
+			}
+		}
+		else if (type_name == "libraries")
+		{
+			source_list declarations;
+
+			auto lit(libraries_.find(type));
+			if (with_libraries && lit != libraries_.end())
+			{
+				for (const auto &pair : lit->second)
 				{
-					auto it(shader_defines_.find(subpart_name));
-					if (it != shader_defines_.end())
+					if (subpart_name == "*" || subpart_name == pair.first)
 					{
-						result.emplace_back(std::make_unique<compiler::define_part>(part_name, it->second));
+						declarations.emplace_back(make_source("library:" + pair.first, pair.second.declarations));
 					}
 				}
 			}
+
+			// Always specify this part, so templates can be used without libraries
+			result.emplace_back(std::make_unique<compiler::template_part>(part_name, std::move(declarations)));
 		}
+	}
 
-		return result;
+	return result;
+}
+
+shader_template program_template::specify_template_parts(GLenum type, const shader_template &source_template) const
+{
+	std::vector<std::unique_ptr<basic_part>> parts;
+	return specify_template_parts(type, std::move(parts), source_template);
+}
+
+shader_template program_template::specify_template_parts(GLenum type, std::vector<std::unique_ptr<basic_part>> parts, const shader_template &source_template) const
+{
+	return source_template.specify_parts(
+	std::move(parts), [&](const std::string &part_name) -> std::vector<std::unique_ptr<compiler::basic_part>> {
+		return resolve_part(type, part_name, true);
 	});
 }
 
-program_template::program_template() = default;
+source_list program_template::compiled_stage_sources(const source_list &sources) const
+{
+	if (prune_sources_)
+	{
+		return source_pruner::prune(sources);
+	}
+
+	return sources;
+}
+
+std::vector<uint32_t> program_template::stage_module(GLenum type, const source_list &sources) const
+{
+	// Shared libraries are linked into the module
+	std::vector<source_list> units{ sources };
+
+	auto lit(libraries_.find(type));
+	if (lit != libraries_.end())
+	{
+		for (const auto &pair : lit->second)
+		{
+			units.push_back(pair.second.sources);
+		}
+	}
+
+	program_cache::entry_key key;
+	if (module_cache_)
+	{
+		key = module_cache_->module_key(type, units);
+
+		auto module(module_cache_->load_module(key));
+		if (!module.empty())
+		{
+			return module;
+		}
+	}
+
+	auto module(spirv_compiler::compile(type, units));
+
+	if (module_cache_)
+	{
+		module_cache_->store_module(key, module);
+	}
+
+	return module;
+}
+
+bool program_template::links_libraries(bool compiled, bool precompiled) const
+{
+	// SPIR-V modules already contain the shared libraries
+	return !spirv_ && (compiled || precompiled);
+}
+
+void program_template::load_shader(gl::shader &so, GLenum type, const source_list &sources) const
+{
+	if (spirv_)
+	{
+		spirv_compiler::load(so, stage_module(type, sources), specialization_constants_);
+		so.check_compile();
+	}
+	else
+	{
+		shader_compiler::compile(so, sources);
+	}
+}
+
+void program_template::link_stage_program(GLenum type)
+{
+	const auto &so(compiled_shaders_.at(type));
+
+	gl::program program;
+	program.parameter(GL_PROGRAM_SEPARABLE, GL_TRUE);
+	program.attach_shader(so);
+
+	// SPIR-V modules already contain the shared libraries
+	auto lit(spirv_ ? libraries_.end() : libraries_.find(type));
+	if (lit != libraries_.end())
+	{
+		for (const auto &pair : lit->second)
+		{
+			program.attach_shader(pair.second.shader);
+		}
+	}
+
+	auto detach_shaders = [&]() {
+		program.detach_shader(so);
+
+		if (lit != libraries_.end())
+		{
+			for (const auto &pair : lit->second)
+			{
+				program.detach_shader(pair.second.shader);
+			}
+		}
+	};
+
+	try
+	{
+		program.link();
+	}
+	catch (const shadertoy::gl::program_link_error &ex)
+	{
+		detach_shaders();
+		throw;
+	}
+
+	detach_shaders();
+
+	stage_programs_.erase(type);
+	stage_programs_.emplace(type, std::move(program));
+}
+
+program_template::program_template()
+: separable_(false), prune_sources_(false), spirv_(false)
+{
+}
 
 program_template::program_template(std::map<GLenum, shader_template> shader_templates)
-: shader_templates_(std::move(shader_templates))
+: shader_templates_(std::move(shader_templates)), separable_(false), prune_sources_(false), spirv_(false)
+{
+}
+
+void program_template::spirv(bool new_spirv)
+{
+	if (new_spirv && !spirv_compiler::supported())
+	{
+		log::shadertoy()->warn("SPIR-V shaders are not supported, using GLSL sources for {}",
+							   static_cast<const void *>(this));
+		new_spirv = false;
+	}
+	else if (new_spirv && !spirv_compiler::reflects_names())
+	{
+		// Uniforms would silently keep their default values
+		log::shadertoy()->warn("The driver does not reflect uniform names of SPIR-V programs, using GLSL "
+							   "sources for {}",
+							   static_cast<const void *>(this));
+		new_spirv = false;
+	}
+
+	if (new_spirv == spirv_)
+	{
+		return;
+	}
+
+	spirv_ = new_spirv;
+
+	// GLSL and SPIR-V shaders cannot be linked together
+	std::vector<GLenum> compiled_types;
+	for (const auto &pair : compiled_shaders_)
+	{
+		compiled_types.push_back(pair.first);
+	}
+
+	for (auto type : compiled_types)
+	{
+		compile(type);
+	}
+}
+
+void program_template::separable(bool new_separable)
 {
+	separable_ = new_separable;
+
+	if (separable_)
+	{
+		// Link the shaders which have already been compiled
+		for (const auto &pair : compiled_shaders_)
+		{
+			if (stage_programs_.find(pair.first) == stage_programs_.end())
+			{
+				link_stage_program(pair.first);
+			}
+		}
+	}
+	else
+	{
+		stage_programs_.clear();
+	}
 }
 
 bool program_template::emplace(GLenum type, shader_template &&shader_template)
@@ -82,44 +448,169 @@ void program_template::compile(GLenum type)
 	gl::shader so(type);
 
 	// Get sources
-	auto sources(specify_template_parts(it->second).sources());
+	auto sources(compiled_stage_sources(specify_template_parts(type, it->second).sources()));
 	
 	if (log::shadertoy()->level() <= spdlog::level::trace)
 	{
 		std::stringstream ss;
-		for (auto &pair : sources)
+		for (auto &source : sources)
 		{
-			ss << pair.second;
+			ss << source->second;
 		}
 		log::shadertoy()->trace("Compiled following code for {}:\n{}", static_cast<const void *>(this), ss.str());
 	}
 
 	// Compile shader
-	shader_compiler::compile(so, sources);
+	load_shader(so, type, sources);
 
 	// Compilation succeeded, add to cache
 	compiled_shaders_.erase(type);
 	compiled_shaders_.emplace(type, std::move(so));
+
+	compiled_sources_.erase(type);
+	compiled_sources_.emplace(type, std::move(sources));
+
+	if (separable_)
+	{
+		link_stage_program(type);
+	}
+}
+
+void program_template::compile_library(GLenum type, const std::string &name, std::vector<std::unique_ptr<basic_part>> parts)
+{
+	auto it = shader_templates_.find(type);
+
+	throw_assert<template_error>(it != shader_templates_.end(), "Shader type {} not found in program_template {}",
+								 type, static_cast<const void *>(this));
+
+	// The library declarations are derived from the parts specifying it
+	std::stringstream declarations;
+	for (const auto &part : parts)
+	{
+		for (const auto &source : part->sources())
+		{
+			declarations << strip_function_bodies(source->second);
+		}
+	}
+
+	// Specify the template, leaving the remaining parts empty
+	auto library_template(it->second.specify_parts(
+	std::move(parts), [&](const std::string &part_name) -> std::vector<std::unique_ptr<compiler::basic_part>> {
+		auto result(resolve_part(type, part_name, false));
+
+		if (result.empty())
+		{
+			result.emplace_back(std::make_unique<compiler::template_part>(
+			part_name, source_list()));
+		}
+
+		return result;
+	}));
+
+	// The entry point is provided by the shaders linked with the library
+	library_template.erase("glsl:main");
+
+	// Get sources
+	auto sources(library_template.sources());
+
+	if (log::shadertoy()->level() <= spdlog::level::trace)
+	{
+		std::stringstream ss;
+		for (auto &source : sources)
+		{
+			ss << source->second;
+		}
+		log::shadertoy()->trace("Compiled following code for library {} of {}:\n{}", name,
+								static_cast<const void *>(this), ss.str());
+	}
+
+	// Compile shader
+	gl::shader so(type);
+	shader_compiler::compile(so, sources);
+
+	// Compilation succeeded, add to cache
+	auto &libraries(libraries_[type]);
+	libraries.erase(name);
+	libraries.emplace(name, library_shader{ std::move(so), std::move(sources), declarations.str() });
+
+	// Update the pre-compiled shader using this library
+	if (compiled_shaders_.find(type) != compiled_shaders_.end())
+	{
+		if (spirv_)
+		{
+			compile(type);
+		}
+		else if (separable_)
+		{
+			link_stage_program(type);
+		}
+	}
+}
+
+bool program_template::erase_library(GLenum type, const std::string &name)
+{
+	auto it = libraries_.find(type);
+	if (it == libraries_.end() || it->second.erase(name) == 0)
+	{
+		return false;
+	}
+
+	if (it->second.empty())
+	{
+		libraries_.erase(it);
+	}
+
+	if (compiled_shaders_.find(type) != compiled_shaders_.end())
+	{
+		if (spirv_)
+		{
+			compile(type);
+		}
+		else if (separable_)
+		{
+			link_stage_program(type);
+		}
+	}
+
+	return true;
+}
+
+program_template::sources_map program_template::link_sources(const sources_map &sources) const
+{
+	sources_map result(sources);
+
+	for (const auto &lpair : libraries_)
+	{
+		auto &stage_sources(result[lpair.first]);
+
+		for (const auto &pair : lpair.second)
+		{
+			stage_sources.insert(stage_sources.end(), pair.second.sources.begin(), pair.second.sources.end());
+		}
+	}
+
+	return result;
 }
 
 gl::program program_template::compile(std::map<GLenum, std::vector<std::unique_ptr<basic_part>>> parts, std::map<GLenum, std::string> *compiled_sources) const
 {
-	gl::program program;
+	return compile_sources(specify_sources(std::move(parts)), compiled_sources);
+}
 
-	std::vector<gl::shader> attached_shaders;
+program_template::sources_map program_template::specify_sources(std::map<GLenum, std::vector<std::unique_ptr<basic_part>>> parts) const
+{
+	sources_map result;
 
-	// Compile and attach fully specified shaders
 	for (const auto &pair : shader_templates_)
 	{
-		// Do not try to recompile precompiled shaders
-		if (compiled_shaders_.find(pair.first) != compiled_shaders_.end())
+		// Pre-compiled shaders cannot be overwritten
+		auto cit = compiled_sources_.find(pair.first);
+		if (cit != compiled_sources_.end())
 		{
+			result.emplace(pair.first, cit->second);
 			continue;
 		}
 
-		// Compile sources
-		std::vector<std::pair<std::string, std::string>> sources;
-
 		// Add parts given as argument
 		auto &specified_template = pair.second;
 		auto it = parts.find(pair.first);
@@ -127,19 +618,66 @@ gl::program program_template::compile(std::map<GLenum, std::vector<std::unique_p
 		// Get sources
 		if (it != parts.end())
 		{
-			sources = specify_template_parts(std::move(it->second), specified_template).sources();
+			result.emplace(pair.first, specify_template_parts(pair.first, std::move(it->second), specified_template).sources());
 		}
 		else
 		{
-			sources = specified_template.sources();
+			result.emplace(pair.first, specified_template.sources());
 		}
+	}
+
+	return result;
+}
+
+std::map<GLenum, std::string> program_template::compiled_code(const sources_map &sources) const
+{
+	std::map<GLenum, std::string> result;
+
+	for (const auto &pair : sources)
+	{
+		if (compiled_shaders_.find(pair.first) != compiled_shaders_.end())
+		{
+			continue;
+		}
+
+		std::string code;
+		for (const auto &source : compiled_stage_sources(pair.second))
+		{
+			code += source->second;
+		}
+
+		result.emplace(pair.first, std::move(code));
+	}
+
+	return result;
+}
+
+gl::program program_template::compile_sources(const sources_map &sources, std::map<GLenum, std::string> *compiled_sources) const
+{
+	return submit_sources(sources, compiled_sources).get();
+}
+
+deferred_program program_template::submit_sources(const sources_map &sources, std::map<GLenum, std::string> *compiled_sources) const
+{
+	deferred_program program(separable_);
+
+	// Compile and attach fully specified shaders
+	for (const auto &pair : sources)
+	{
+		// Do not try to recompile precompiled shaders
+		if (compiled_shaders_.find(pair.first) != compiled_shaders_.end())
+		{
+			continue;
+		}
+
+		auto stage_sources(compiled_stage_sources(pair.second));
 
 		if (log::shadertoy()->level() <= spdlog::level::trace || compiled_sources != nullptr)
 		{
 			std::stringstream ss;
-			for (auto &pair : sources)
+			for (auto &source : stage_sources)
 			{
-				ss << pair.second;
+				ss << source->second;
 			}
 
 			auto result(ss.str());
@@ -152,57 +690,46 @@ gl::program program_template::compile(std::map<GLenum, std::vector<std::unique_p
 			log::shadertoy()->trace("Compiled following code for {}:\n{}", static_cast<const void *>(this), result);
 		}
 
-		// Compile shader
-		gl::shader so(pair.first);
-		shader_compiler::compile(so, sources);
-
-		// Add shader for attachment
-		attached_shaders.emplace_back(std::move(so));
+		// Submit shader
+		if (spirv_)
+		{
+			program.submit_module(pair.first, stage_module(pair.first, stage_sources), specialization_constants_);
+		}
+		else
+		{
+			program.submit_shader(pair.first, std::move(stage_sources));
+		}
 	}
 
-	// Attach pre-compiled shaders
-	for (const auto &pair : compiled_shaders_)
+	// Attach pre-compiled shaders, unless they are used through their own separable program
+	if (!separable_)
 	{
-		program.attach_shader(pair.second);
+		for (const auto &pair : compiled_shaders_)
+		{
+			program.attach_shader(pair.second);
+		}
 	}
 
-	// Attach compiled on-the-fly shaders
-	for (const auto &s : attached_shaders)
+	// Attach the shared libraries of the stages in this program, SPIR-V
+	// modules already contain them
+	for (const auto &lpair : libraries_)
 	{
-		program.attach_shader(s);
-	}
+		bool precompiled = compiled_shaders_.find(lpair.first) != compiled_shaders_.end();
+		bool compiled = !precompiled && sources.find(lpair.first) != sources.end();
 
-	try
-	{
-		// Link program
-		program.link();
-	}
-	catch (const shadertoy::gl::program_link_error &ex)
-	{
-		// Detach shaders
-		for (const auto &s : attached_shaders)
+		if (!links_libraries(compiled, precompiled && !separable_))
 		{
-			program.detach_shader(s);
+			continue;
 		}
 
-		for (const auto &pair : compiled_shaders_)
+		for (const auto &pair : lpair.second)
 		{
-			program.detach_shader(pair.second);
+			program.attach_shader(pair.second.shader);
 		}
-
-		throw;
 	}
 
-	// Detach shaders
-	for (const auto &s : attached_shaders)
-	{
-		program.detach_shader(s);
-	}
-
-	for (const auto &pair : compiled_shaders_)
-	{
-		program.detach_shader(pair.second);
-	}
+	// Link program
+	program.link();
 
 	return program;
 }
@@ -217,14 +744,14 @@ gl::program program_template::compile(const std::map<GLenum, shader_template> &t
 	for (const auto &pair : templates)
 	{
 		// Compile sources
-		auto sources(pair.second.sources());
+		auto sources(compiled_stage_sources(pair.second.sources()));
 
 		if (log::shadertoy()->level() <= spdlog::level::trace || compiled_sources != nullptr)
 		{
 			std::stringstream ss;
-			for (auto &pair : sources)
+			for (auto &source : sources)
 			{
-				ss << pair.second;
+				ss << source->second;
 			}
 
 			auto result(ss.str());
@@ -241,22 +768,46 @@ gl::program program_template::compile(const std::map<GLenum, shader_template> &t
 
 		// Compile shader
 		gl::shader so(pair.first);
-		shader_compiler::compile(so, sources);
+		load_shader(so, pair.first, sources);
 
 		// Add shader for attachment
 		attached_shaders.emplace_back(std::move(so));
 	}
 
-	// Attach pre-compiled shaders
+	// Attach pre-compiled shaders and shared libraries
+	std::vector<const gl::shader *> shared_shaders;
 	for (const auto &pair : compiled_shaders_)
 	{
 		// Only attach shaders that are not being overriden
 		if (templates.find(pair.first) == templates.end())
 		{
-			program.attach_shader(pair.second);
+			shared_shaders.push_back(&pair.second);
+		}
+	}
+
+	// Like in submit_sources, libraries are linked with every stage present in
+	// the program, whether it is compiled from a template or pre-compiled
+	for (const auto &lpair : libraries_)
+	{
+		bool compiled = templates.find(lpair.first) != templates.end();
+		bool precompiled = !compiled && compiled_shaders_.find(lpair.first) != compiled_shaders_.end();
+
+		if (!links_libraries(compiled, precompiled))
+		{
+			continue;
+		}
+
+		for (const auto &pair : lpair.second)
+		{
+			shared_shaders.push_back(&pair.second.shader);
 		}
 	}
 
+	for (const auto *shader : shared_shaders)
+	{
+		program.attach_shader(*shader);
+	}
+
 	// Attach compiled on-the-fly shaders
 	for (const auto &s : attached_shaders)
 	{
@@ -276,12 +827,9 @@ gl::program program_template::compile(const std::map<GLenum, shader_template> &t
 			program.detach_shader(s);
 		}
 
-		for (const auto &pair : compiled_shaders_)
+		for (const auto *shader : shared_shaders)
 		{
-			if (templates.find(pair.first) == templates.end())
-			{
-				program.detach_shader(pair.second);
-			}
+			program.detach_shader(*shader);
 		}
 
 		throw;
@@ -293,12 +841,9 @@ gl::program program_template::compile(const std::map<GLenum, shader_template> &t
 		program.detach_shader(s);
 	}
 
-	for (const auto &pair : compiled_shaders_)
+	for (const auto *shader : shared_shaders)
 	{
-		if (templates.find(pair.first) == templates.end())
-		{
-			program.detach_shader(pair.second);
-		}
+		program.detach_shader(*shader);
 	}
 
 	return program;
@@ -1,9 +1,10 @@
 #include <algorithm>
 #include <fstream>
-#include <iomanip>
+#include <iterator>
 #include <map>
-#include <regex>
 #include <sstream>
+#include <string_view>
+#include <unordered_set>
 
 #include "shadertoy/compiler/shader_template.hpp"
 #include "shadertoy/compiler/template_error.hpp"
@@ -53,9 +54,9 @@ bool shader_template::is_specified() const
 					   [](const auto &part_ptr) { return part_ptr->is_specified(); });
 }
 
-std::vector<std::pair<std::string, std::string>> shader_template::sources() const
+source_list shader_template::sources() const
 {
-	std::vector<std::pair<std::string, std::string>> result;
+	source_list result;
 	result.reserve(parts_.size());
 
 	for (auto &part : parts_)
@@ -149,138 +150,265 @@ bool shader_template::erase(const std::string &name)
 	return false;
 }
 
-shader_template shader_template::parse(const std::string &source, const std::string &name)
+namespace
 {
-	std::istringstream iss(source);
-	return parse(iss, name);
-}
 
-static void emit_part(shader_template &st, std::string &name, std::ostringstream &ss)
+/**
+ * @brief Scanner for the `#pragma shadertoy part` directives of a template line
+ *
+ * This accepts the same grammar as the following regular expression, without
+ * allocating:
+ * `^\s*#pragma\s+shadertoy\s+part\s+(?:((?:\*|[a-zA-Z_][a-zA-Z\-_0-9]*):[a-zA-Z_][a-zA-Z\-_0-9]*)(?:\s+(begin))?|(end))\s*$`
+ */
+class directive_scanner
 {
-	st.push_back(std::make_unique<template_part>(name, ss.str()));
-	ss = std::ostringstream();
-	name = std::string();
+	std::string_view line_;
+	size_t pos_;
+
+	static bool is_space(char c)
+	{ return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; }
+
+	static bool is_ident_start(char c)
+	{ return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_'; }
+
+	static bool is_ident(char c)
+	{ return is_ident_start(c) || (c >= '0' && c <= '9') || c == '-'; }
+
+	size_t skip_spaces()
+	{
+		size_t start = pos_;
+		while (pos_ < line_.size() && is_space(line_[pos_]))
+			++pos_;
+		return pos_ - start;
+	}
+
+	bool keyword(std::string_view word)
+	{
+		if (line_.compare(pos_, word.size(), word) != 0)
+			return false;
+
+		pos_ += word.size();
+		return true;
+	}
+
+	bool identifier()
+	{
+		if (pos_ >= line_.size() || !is_ident_start(line_[pos_]))
+			return false;
+
+		while (++pos_ < line_.size() && is_ident(line_[pos_]))
+			;
+		return true;
+	}
+
+	bool at_end()
+	{
+		skip_spaces();
+		return pos_ == line_.size();
+	}
+
+public:
+	enum directive_type
+	{
+		/// Not a directive, plain GLSL source
+		none,
+		/// Template slot, or template part start if begin is true
+		part,
+		/// End of template part
+		end,
+	};
+
+	/// Name of the part for part directives
+	std::string_view name;
+
+	/// true if the part directive starts a template part
+	bool begin;
+
+	directive_scanner(std::string_view line) : line_(line), pos_(0), name(), begin(false) {}
+
+	directive_type scan()
+	{
+		skip_spaces();
+
+		if (!keyword("#pragma") || skip_spaces() == 0 || !keyword("shadertoy") || skip_spaces() == 0 ||
+			!keyword("part") || skip_spaces() == 0)
+			return none;
+
+		// Part name
+		size_t name_start = pos_;
+		size_t after_keyword = pos_;
+
+		if ((keyword("*") || identifier()) && keyword(":") && identifier())
+		{
+			name = line_.substr(name_start, pos_ - name_start);
+
+			if (at_end())
+				return part;
+
+			pos_ = name_start + name.size();
+			if (skip_spaces() > 0 && keyword("begin") && at_end())
+			{
+				begin = true;
+				return part;
+			}
+
+			return none;
+		}
+
+		// End of part
+		pos_ = after_keyword;
+		if (keyword("end") && at_end())
+			return end;
+
+		return none;
+	}
+};
+
+/// Parts of a template being parsed
+struct parsed_parts
+{
+	/// Parts in template order
+	std::deque<std::unique_ptr<basic_part>> parts;
+
+	/// Names of the parts, so checking for duplicates does not scan all the parts
+	std::unordered_set<std::string> names;
+
+	void push_back(std::unique_ptr<basic_part> part)
+	{
+		throw_assert<template_error>(names.insert(part->name()).second, "A part named {} already exists",
+									 part->name());
+		parts.emplace_back(std::move(part));
+	}
+};
+
+void emit_part(parsed_parts &st, std::string_view name, std::string_view contents)
+{
+	st.push_back(std::make_unique<template_part>(std::string(name), std::string(contents)));
 }
 
-static void emit_part(shader_template &st, const std::string &name)
+void emit_part(parsed_parts &st, std::string_view name)
 {
-	st.push_back(std::make_unique<template_part>(name));
+	st.push_back(std::make_unique<template_part>(std::string(name)));
 }
 
-static void emit_part(shader_template &st, const std::string &name_prefix, int &name, std::ostringstream &ss)
+void emit_part(parsed_parts &st, const std::string &name_prefix, int &name, std::string_view contents)
 {
-	auto contents(ss.str());
 	if (!contents.empty())
 	{
-		st.push_back(std::make_unique<template_part>(name_prefix + "-" + std::to_string(name++), contents));
-		ss = std::ostringstream();
+		st.push_back(std::make_unique<template_part>(name_prefix + "-" + std::to_string(name++), std::string(contents)));
 	}
 }
+}
 
-shader_template shader_template::parse(std::istream &is, const std::string &name_prefix)
+shader_template shader_template::parse_source(std::string_view source, const std::string &name_prefix)
 {
-	const std::regex cmd_regex(
-	R"(^\s*#pragma\s+shadertoy\s+part\s+(?:((?:\*|[a-zA-Z_][a-zA-Z\-_0-9]*):[a-zA-Z_][a-zA-Z\-_0-9]*)(?:\s+(begin))?|(end))\s*$)");
-
 	enum
 	{
 		TP_GLSL_SOURCE,
 		TP_TEMPLATE_SOURCE,
 	} t_state = TP_GLSL_SOURCE;
 
-	std::string line;
-	std::ostringstream ss_current;
-	std::string template_name;
+	// Sources lines are accumulated as a range of the original buffer, so
+	// parts are only copied when they are emitted
+	size_t current_start = 0;
+	std::string_view template_name;
 	int part_number = 0;
 	int line_num = 1;
-	shader_template st;
+	parsed_parts st;
 
-	for (; std::getline(is, line); line_num++)
+	size_t line_start = 0;
+	for (; line_start < source.size(); line_num++)
 	{
-		std::smatch match;
+		size_t line_end = source.find('\n', line_start);
+		size_t next_line = line_end == std::string_view::npos ? source.size() : line_end + 1;
+		std::string_view line = source.substr(line_start, (line_end == std::string_view::npos ? source.size() : line_end) - line_start);
+
+		directive_scanner scanner(line);
+		auto directive = scanner.scan();
 
-		if (std::regex_match(line, match, cmd_regex))
+		if (directive == directive_scanner::none)
 		{
-			auto name = match[1].str();
-			if (match[2].length() == 0)
+			line_start = next_line;
+			continue;
+		}
+
+		std::string_view contents(source.substr(current_start, line_start - current_start));
+
+		if (directive == directive_scanner::end)
+		{
+			switch (t_state)
 			{
-				// part name, no begin, or end
-				if (match[3].str() == "end")
-				{
-					switch (t_state)
-					{
-					case TP_GLSL_SOURCE:
-					{
-						std::ostringstream ss;
-						ss << line_num << ": unmatched end";
-						throw template_error(ss.str());
-					}
-					break;
-					case TP_TEMPLATE_SOURCE:
-						emit_part(st, template_name, ss_current);
-						t_state = TP_GLSL_SOURCE;
-						break;
-					}
-				}
-				else
-				{
-					std::string contents;
-					switch (t_state)
-					{
-					case TP_GLSL_SOURCE:
-						emit_part(st, name_prefix, part_number, ss_current);
-						emit_part(st, name);
-						break;
-					case TP_TEMPLATE_SOURCE:
-					{
-						std::ostringstream ss;
-						ss << line_num << ": unexpected template slot " << std::quoted(name);
-						throw template_error(ss.str());
-					}
-					break;
-					}
-				}
+			case TP_GLSL_SOURCE:
+				throw template_error(fmt::format("{}: unmatched end", line_num));
+			case TP_TEMPLATE_SOURCE:
+				emit_part(st, template_name, contents);
+				t_state = TP_GLSL_SOURCE;
+				break;
 			}
-			else
+		}
+		else if (!scanner.begin)
+		{
+			switch (t_state)
 			{
-				switch (t_state)
-				{
-				case TP_GLSL_SOURCE:
-					emit_part(st, name_prefix, part_number, ss_current);
-					template_name = name;
-					t_state = TP_TEMPLATE_SOURCE;
-					break;
-				case TP_TEMPLATE_SOURCE:
-				{
-					std::ostringstream ss;
-					ss << line_num << ": unexpected template begin for " << std::quoted(name);
-					throw template_error(ss.str());
-				}
+			case TP_GLSL_SOURCE:
+				emit_part(st, name_prefix, part_number, contents);
+				emit_part(st, scanner.name);
 				break;
-				}
+			case TP_TEMPLATE_SOURCE:
+				throw template_error(fmt::format("{}: unexpected template slot \"{}\"", line_num, std::string(scanner.name)));
 			}
 		}
 		else
 		{
-			ss_current << line << std::endl;
+			switch (t_state)
+			{
+			case TP_GLSL_SOURCE:
+				emit_part(st, name_prefix, part_number, contents);
+				template_name = scanner.name;
+				t_state = TP_TEMPLATE_SOURCE;
+				break;
+			case TP_TEMPLATE_SOURCE:
+				throw template_error(fmt::format("{}: unexpected template begin for \"{}\"", line_num, std::string(scanner.name)));
+			}
 		}
+
+		line_start = next_line;
+		current_start = next_line;
 	}
 
 	switch (t_state)
 	{
 	case TP_GLSL_SOURCE:
-		emit_part(st, name_prefix, part_number, ss_current);
-		break;
-	case TP_TEMPLATE_SOURCE:
 	{
-		std::ostringstream ss;
-		ss << line_num << ": unexpected end of file while looking for end part " << std::quoted(template_name);
-		throw template_error(ss.str());
+		std::string_view contents(source.substr(current_start));
+
+		// Source lines are always terminated by a line break
+		if (!contents.empty() && contents.back() != '\n')
+		{
+			emit_part(st, name_prefix, part_number, std::string(contents) + '\n');
+		}
+		else
+		{
+			emit_part(st, name_prefix, part_number, contents);
+		}
 	}
 	break;
+	case TP_TEMPLATE_SOURCE:
+		throw template_error(fmt::format("{}: unexpected end of file while looking for end part \"{}\"", line_num, std::string(template_name)));
 	}
 
-	return st;
+	return shader_template(std::move(st.parts));
+}
+
+shader_template shader_template::parse(const std::string &source, const std::string &name)
+{
+	return parse_source(source, name);
+}
+
+shader_template shader_template::parse(std::istream &is, const std::string &name_prefix)
+{
+	std::string source((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	return parse_source(source, name_prefix);
 }
 
 shader_template shader_template::parse_file(const std::string &filename)
@@ -296,3 +424,38 @@ shader_template shader_template::parse_file(const std::string &filename)
 
 	return parse(ifs, filename);
 }
+
+shader_template shader_template::from_embedded(const embedded_template &source, const std::string &name)
+{
+	parsed_parts st;
+	int part_number = 0;
+
+	for (size_t i = 0; i < source.part_count; ++i)
+	{
+		const auto &part = source.parts[i];
+
+		if (!part.specified)
+		{
+			emit_part(st, part.name);
+			continue;
+		}
+
+		std::string_view contents(source.data + part.offset, part.length);
+
+		if (part.name)
+		{
+			emit_part(st, part.name, contents);
+		}
+		else if (part.offset + part.length == source.size && !contents.empty() && contents.back() != '\n')
+		{
+			// Source lines are always terminated by a line break
+			emit_part(st, name, part_number, std::string(contents) + '\n');
+		}
+		else
+		{
+			emit_part(st, name, part_number, contents);
+		}
+	}
+
+	return shader_template(std::move(st.parts));
+}
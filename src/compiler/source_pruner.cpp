@@ -0,0 +1,417 @@
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <set>
+#include <string_view>
+#include <vector>
+
+#include "shadertoy/compiler/source_pruner.hpp"
+
+#include "shadertoy/utils/log.hpp"
+
+using namespace shadertoy::compiler;
+using shadertoy::utils::log;
+
+namespace
+{
+
+/// GLSL token, as a range of the shader source
+struct token
+{
+	/// Offset of the first character of the token
+	size_t begin;
+
+	/// Offset past the last character of the token
+	size_t end;
+
+	/// true for identifiers and keywords, false for numbers and punctuation
+	bool identifier;
+
+	/// Number of preprocessor directives before this token
+	size_t directives;
+};
+
+/// Global declaration, as a range of tokens
+struct declaration
+{
+	enum kind_type
+	{
+		function,
+		constant,
+		prototype,
+		other,
+	} kind;
+
+	/// Index of the first token of the declaration
+	size_t first;
+
+	/// Index of the last token of the declaration
+	size_t last;
+
+	/// Names declared by this declaration
+	std::vector<std::string_view> names;
+};
+
+bool is_identifier_start(char c) { return std::isalpha(static_cast<unsigned char>(c)) || c == '_'; }
+
+bool is_identifier_char(char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; }
+
+/**
+ * @brief Split a GLSL source into tokens
+ *
+ * Comments are skipped. Identifiers found in preprocessor directives are
+ * added to \p directive_identifiers instead of being returned as tokens.
+ */
+std::vector<token> tokenize(std::string_view text, std::vector<std::string_view> &directive_identifiers)
+{
+	std::vector<token> tokens;
+	size_t directives = 0;
+	bool line_start = true;
+
+	for (size_t i = 0; i < text.size();)
+	{
+		char c = text[i];
+		char next = i + 1 < text.size() ? text[i + 1] : '\0';
+
+		if (c == '\n')
+		{
+			line_start = true;
+			++i;
+		}
+		else if (c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f')
+		{
+			++i;
+		}
+		else if (c == '/' && next == '/')
+		{
+			while (i < text.size() && text[i] != '\n')
+				++i;
+		}
+		else if (c == '/' && next == '*')
+		{
+			auto end = text.find("*/", i + 2);
+			i = end == std::string_view::npos ? text.size() : end + 2;
+		}
+		else if (c == '#' && line_start)
+		{
+			// Preprocessor directive, including line continuations
+			size_t start = i;
+			for (; i < text.size() && !(text[i] == '\n' && text[i - 1] != '\\'); ++i)
+			{
+			}
+
+			auto directive(text.substr(start, i - start));
+			for (size_t j = 0; j < directive.size();)
+			{
+				if (is_identifier_start(directive[j]) && (j == 0 || !is_identifier_char(directive[j - 1])))
+				{
+					size_t end = j;
+					while (end < directive.size() && is_identifier_char(directive[end]))
+						++end;
+
+					directive_identifiers.push_back(directive.substr(j, end - j));
+					j = end;
+				}
+				else
+				{
+					++j;
+				}
+			}
+
+			++directives;
+		}
+		else
+		{
+			line_start = false;
+
+			size_t start = i;
+			bool identifier = is_identifier_start(c);
+
+			if (identifier || std::isdigit(static_cast<unsigned char>(c)) ||
+				(c == '.' && std::isdigit(static_cast<unsigned char>(next))))
+			{
+				// Identifiers and numbers, including suffixes and exponents
+				while (i < text.size() && (is_identifier_char(text[i]) || (!identifier && text[i] == '.')))
+					++i;
+			}
+			else
+			{
+				++i;
+			}
+
+			tokens.push_back({ start, i, identifier, directives });
+		}
+	}
+
+	return tokens;
+}
+
+/**
+ * @brief Split tokens into global declarations
+ */
+std::vector<declaration> split_declarations(std::string_view text, const std::vector<token> &tokens)
+{
+	std::vector<declaration> declarations;
+
+	auto str = [&](size_t i) { return text.substr(tokens[i].begin, tokens[i].end - tokens[i].begin); };
+	auto is = [&](size_t i, char c) { return !tokens[i].identifier && tokens[i].end - tokens[i].begin == 1 && text[tokens[i].begin] == c; };
+
+	size_t first = 0;
+	int depth = 0, parens = 0;
+	bool assignment = false;
+	std::string_view call_name;
+
+	auto reset = [&](size_t next) {
+		first = next;
+		depth = parens = 0;
+		assignment = false;
+		call_name = std::string_view();
+	};
+
+	for (size_t i = 0; i < tokens.size(); ++i)
+	{
+		if (depth > 0)
+		{
+			// Inside a struct or interface block
+			if (is(i, '{'))
+				++depth;
+			else if (is(i, '}'))
+				--depth;
+		}
+		else if (is(i, '('))
+		{
+			if (parens++ == 0 && i > first && tokens[i - 1].identifier)
+				call_name = str(i - 1);
+		}
+		else if (is(i, ')'))
+		{
+			--parens;
+		}
+		else if (parens > 0)
+		{
+		}
+		else if (is(i, '='))
+		{
+			assignment = true;
+		}
+		else if (is(i, '{'))
+		{
+			if (i > first && is(i - 1, ')') && !call_name.empty() && !assignment)
+			{
+				// Function definition, find the end of its body
+				size_t last = i;
+				for (int body_depth = 0; last < tokens.size(); ++last)
+				{
+					if (is(last, '{'))
+						++body_depth;
+					else if (is(last, '}') && --body_depth == 0)
+						break;
+				}
+
+				if (last == tokens.size())
+					break;
+
+				declarations.push_back({ declaration::function, first, last, { call_name } });
+				i = last;
+				reset(last + 1);
+			}
+			else
+			{
+				++depth;
+			}
+		}
+		else if (is(i, ';'))
+		{
+			declaration decl{ declaration::other, first, i, {} };
+
+			if (str(first) == "const" && assignment)
+			{
+				decl.kind = declaration::constant;
+
+				// Declared names are the identifiers before initializers
+				int nesting = 0;
+				bool initializer = false;
+				for (size_t j = first + 1; j < i; ++j)
+				{
+					if (is(j, '(') || is(j, '['))
+						++nesting;
+					else if (is(j, ')') || is(j, ']'))
+						--nesting;
+					else if (nesting == 0 && is(j, '='))
+						initializer = true;
+					else if (nesting == 0 && is(j, ','))
+						initializer = false;
+					else if (nesting == 0 && !initializer && tokens[j].identifier &&
+							 (is(j + 1, '=') || is(j + 1, ',') || is(j + 1, '[') || is(j + 1, ';')))
+						decl.names.push_back(str(j));
+				}
+			}
+			else if (i > first && is(i - 1, ')') && !call_name.empty() && !assignment)
+			{
+				decl.kind = declaration::prototype;
+			}
+
+			declarations.push_back(std::move(decl));
+			reset(i + 1);
+		}
+	}
+
+	// Incomplete trailing declaration
+	if (first < tokens.size())
+	{
+		declarations.push_back({ declaration::other, first, tokens.size() - 1, {} });
+	}
+
+	return declarations;
+}
+}
+
+source_list source_pruner::prune(const source_list &sources)
+{
+	// Analyze the sources as a whole, since declarations may use other parts
+	std::string text;
+	std::vector<size_t> offsets;
+
+	for (const auto &source : sources)
+	{
+		offsets.push_back(text.size());
+		text.append(source->second);
+	}
+
+	offsets.push_back(text.size());
+
+	std::vector<std::string_view> roots{ "main", "mainImage" };
+	auto tokens(tokenize(text, roots));
+	auto declarations(split_declarations(text, tokens));
+
+	auto str = [&](size_t i) { return std::string_view(text).substr(tokens[i].begin, tokens[i].end - tokens[i].begin); };
+
+	// Only prune shaders with an entry point, libraries are used from other shaders
+	if (std::none_of(declarations.begin(), declarations.end(), [](const auto &decl) {
+			return decl.kind == declaration::function && decl.names.front() == "main";
+		}))
+	{
+		return sources;
+	}
+
+	std::multimap<std::string_view, size_t> candidates;
+
+	for (size_t d = 0; d < declarations.size(); ++d)
+	{
+		auto &decl(declarations[d]);
+
+		// Declarations spanning directives may not be removed safely
+		if ((decl.kind == declaration::function || decl.kind == declaration::constant) &&
+			tokens[decl.first].directives != tokens[decl.last].directives)
+		{
+			decl.kind = declaration::other;
+		}
+
+		switch (decl.kind)
+		{
+		case declaration::function:
+		case declaration::constant:
+			for (const auto &name : decl.names)
+				candidates.emplace(name, d);
+			break;
+		case declaration::other:
+			// Everything used by other declarations is reachable
+			for (size_t i = decl.first; i <= decl.last; ++i)
+			{
+				if (tokens[i].identifier)
+					roots.push_back(str(i));
+			}
+			break;
+		case declaration::prototype:
+			break;
+		}
+	}
+
+	// Walk the dependency graph from the roots
+	std::vector<bool> used(declarations.size(), false);
+	std::set<std::string_view> visited;
+
+	while (!roots.empty())
+	{
+		auto name(roots.back());
+		roots.pop_back();
+
+		if (!visited.insert(name).second)
+			continue;
+
+		auto range(candidates.equal_range(name));
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (used[it->second])
+				continue;
+
+			used[it->second] = true;
+
+			const auto &decl(declarations[it->second]);
+			for (size_t i = decl.first; i <= decl.last; ++i)
+			{
+				if (tokens[i].identifier && str(i) != name)
+					roots.push_back(str(i));
+			}
+		}
+	}
+
+	// Collect the character ranges to remove
+	std::vector<std::pair<size_t, size_t>> removed;
+	size_t functions = 0, constants = 0, removed_size = 0;
+
+	for (size_t d = 0; d < declarations.size(); ++d)
+	{
+		const auto &decl(declarations[d]);
+
+		if ((decl.kind != declaration::function && decl.kind != declaration::constant) || used[d])
+			continue;
+
+		removed.emplace_back(tokens[decl.first].begin, tokens[decl.last].end);
+		removed_size += tokens[decl.last].end - tokens[decl.first].begin;
+		++(decl.kind == declaration::function ? functions : constants);
+	}
+
+	if (removed.empty())
+	{
+		return sources;
+	}
+
+	log::shadertoy()->debug("Pruned {} functions and {} constants ({} bytes)", functions, constants, removed_size);
+
+	// Rebuild the modified sources, keeping line breaks
+	source_list result;
+	result.reserve(sources.size());
+
+	auto rit = removed.begin();
+	for (size_t s = 0; s < sources.size(); ++s)
+	{
+		size_t begin = offsets[s], end = offsets[s + 1];
+
+		while (rit != removed.end() && rit->second <= begin)
+			++rit;
+
+		if (rit == removed.end() || rit->first >= end)
+		{
+			result.push_back(sources[s]);
+			continue;
+		}
+
+		std::string contents;
+		contents.reserve(end - begin);
+
+		auto it = rit;
+		for (size_t i = begin; i < end; ++i)
+		{
+			while (it != removed.end() && it->second <= i)
+				++it;
+
+			if (it == removed.end() || i < it->first || text[i] == '\n')
+				contents.push_back(text[i]);
+		}
+
+		result.push_back(make_source(sources[s]->first, std::move(contents)));
+	}
+
+	return result;
+}
@@ -18,35 +18,45 @@ template_part::template_part(const std::string &name)
 
 template_part::template_part(const std::string &name, const std::string &source)
 	: cloneable_part(name),
-	sources_{ std::make_pair(name, source) },
+	sources_{ make_source(name, source) },
 	has_sources_(true)
 {
 }
 
 template_part::template_part(const std::string &name, std::vector<std::pair<std::string, std::string>> sources)
+: cloneable_part(name), has_sources_(true)
+{
+	sources_.reserve(sources.size());
+	for (auto &source : sources)
+	{
+		sources_.emplace_back(make_source(std::move(source.first), std::move(source.second)));
+	}
+}
+
+template_part::template_part(const std::string &name, source_list sources)
 : cloneable_part(name), sources_(std::move(sources)), has_sources_(true)
 {
 }
 
 template_part template_part::from_file(const std::string &name, const std::string &filename)
 {
-	std::vector<std::pair<std::string, std::string>> sources;
-	sources.emplace_back(filename, read_contents(filename));
+	source_list sources;
+	sources.emplace_back(make_source(filename, read_contents(filename)));
 
-	return template_part(name, sources);
+	return template_part(name, std::move(sources));
 }
 
 template_part template_part::from_files(const std::string &name, const std::vector<std::string> &filenames)
 {
-	std::vector<std::pair<std::string, std::string>> sources;
+	source_list sources;
 
 	sources.reserve(filenames.size());
 	for (auto filename : filenames)
 	{
-		sources.emplace_back(filename, read_contents(filename));
+		sources.emplace_back(make_source(filename, read_contents(filename)));
 	}
 
-	return template_part(name, sources);
+	return template_part(name, std::move(sources));
 }
 
 template_part::operator bool() const
@@ -54,7 +64,7 @@ template_part::operator bool() const
 	return has_sources_;
 }
 
-std::vector<std::pair<std::string, std::string>> template_part::sources() const
+source_list template_part::sources() const
 {
 	throw_assert<template_error>(has_sources_, "Template part {} is not specified", name());
 	return sources_;
@@ -24,3 +24,18 @@ void buffer::data(GLsizei size, const void *data, GLenum usage) const
 {
 	gl_call(glNamedBufferData, GLuint(*this), size, data, usage);
 }
+
+void buffer::storage(GLsizeiptr size, const void *data, GLbitfield flags) const
+{
+	gl_call(glNamedBufferStorage, GLuint(*this), size, data, flags);
+}
+
+void *buffer::map_range(GLintptr offset, GLsizeiptr length, GLbitfield access) const
+{
+	return gl_call(glMapNamedBufferRange, GLuint(*this), offset, length, access);
+}
+
+GLboolean buffer::unmap() const
+{
+	return gl_call(glUnmapNamedBuffer, GLuint(*this));
+}
@@ -32,6 +32,14 @@ void framebuffer::framebuffer_renderbuffer(GLenum attachment, GLenum renderbuffe
 	gl_call(glNamedFramebufferRenderbuffer, GLuint(*this), attachment, renderbuffertarget, GLuint(renderbuffer));
 }
 
+void framebuffer::blit(GLuint draw_framebuffer, GLint src_x0, GLint src_y0, GLint src_x1, GLint src_y1,
+					   GLint dst_x0, GLint dst_y0, GLint dst_x1, GLint dst_y1, GLbitfield mask,
+					   GLenum filter) const
+{
+	gl_call(glBlitNamedFramebuffer, GLuint(*this), draw_framebuffer, src_x0, src_y0, src_x1, src_y1,
+			dst_x0, dst_y0, dst_x1, dst_y1, mask, filter);
+}
+
 bound_ops<framebuffer>::bound_ops(const framebuffer &resource)
 	: bound_ops_base<framebuffer>(resource)
 {}
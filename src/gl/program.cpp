@@ -51,9 +51,18 @@ program_validate_error::program_validate_error(GLuint programId, std::string log
 }
 
 void program::link() const
+{
+	link_deferred();
+	check_link();
+}
+
+void program::link_deferred() const
 {
 	gl_call(glLinkProgram, GLuint(*this));
+}
 
+void program::check_link() const
+{
 	GLint linkStatus;
 	gl_call(glGetProgramiv, GLuint(*this), GL_LINK_STATUS, &linkStatus);
 	if (linkStatus != GL_TRUE)
@@ -62,6 +71,11 @@ void program::link() const
 	}
 }
 
+void program::parameter(GLenum pname, GLint value) const
+{
+	gl_call(glProgramParameteri, GLuint(*this), pname, value);
+}
+
 void program::use() const
 {
 	gl_call(glUseProgram, GLuint(*this));
@@ -130,6 +144,11 @@ void program::get_binary(GLsizei bufsize, GLsizei *length, GLenum *binaryFormat,
 	gl_call(glGetProgramBinary, GLuint(*this), bufsize, length, binaryFormat, binary);
 }
 
+void program::binary(GLenum binaryFormat, const void *binary, GLsizei length) const
+{
+	gl_call(glProgramBinary, GLuint(*this), binaryFormat, binary, length);
+}
+
 void program::get_program_interface(GLenum programInterface, GLenum pname, GLint *params) const
 {
 	gl_call(glGetProgramInterfaceiv, GLuint(*this), programInterface, pname, params);
@@ -0,0 +1,97 @@
+#include <utility>
+#include <vector>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl/program.hpp"
+#include "shadertoy/gl/program_pipeline.hpp"
+#include "shadertoy/shadertoy_error.hpp"
+
+using namespace shadertoy::gl;
+
+null_program_pipeline_error::null_program_pipeline_error()
+	: shadertoy_error("An attempt was made to dereference a null program pipeline")
+{
+}
+
+program_pipeline_validate_error::program_pipeline_validate_error(GLuint pipelineId, std::string log)
+: shadertoy_error("OpenGL program pipeline validation error"), pipeline_id_(pipelineId), log_(std::move(log))
+{
+}
+
+GLbitfield program_pipeline::stage_bit(GLenum shader_type)
+{
+	switch (shader_type)
+	{
+	case GL_VERTEX_SHADER:
+		return GL_VERTEX_SHADER_BIT;
+	case GL_TESS_CONTROL_SHADER:
+		return GL_TESS_CONTROL_SHADER_BIT;
+	case GL_TESS_EVALUATION_SHADER:
+		return GL_TESS_EVALUATION_SHADER_BIT;
+	case GL_GEOMETRY_SHADER:
+		return GL_GEOMETRY_SHADER_BIT;
+	case GL_FRAGMENT_SHADER:
+		return GL_FRAGMENT_SHADER_BIT;
+	case GL_COMPUTE_SHADER:
+		return GL_COMPUTE_SHADER_BIT;
+	default:
+		throw shadertoy::shadertoy_error("Invalid shader type in stage_bit");
+	}
+}
+
+void program_pipeline::bind() const
+{
+	gl_call(glBindProgramPipeline, GLuint(*this));
+}
+
+void program_pipeline::unbind() const
+{
+	gl_call(glBindProgramPipeline, 0);
+}
+
+void program_pipeline::use_program_stages(GLbitfield stages, const program &program) const
+{
+	gl_call(glUseProgramStages, GLuint(*this), stages, GLuint(program));
+}
+
+void program_pipeline::active_shader_program(const program &program) const
+{
+	gl_call(glActiveShaderProgram, GLuint(*this), GLuint(program));
+}
+
+void program_pipeline::validate() const
+{
+	gl_call(glValidateProgramPipeline, GLuint(*this));
+
+	GLint validateStatus;
+	gl_call(glGetProgramPipelineiv, GLuint(*this), GL_VALIDATE_STATUS, &validateStatus);
+	if (validateStatus != GL_TRUE)
+	{
+		throw program_pipeline_validate_error(GLuint(*this), this->log());
+	}
+}
+
+void program_pipeline::get(GLenum pname, GLint *params) const
+{
+	gl_call(glGetProgramPipelineiv, GLuint(*this), pname, params);
+}
+
+std::string program_pipeline::log() const
+{
+	// Get log length
+	GLint infoLogLength = 0;
+	gl_call(glGetProgramPipelineiv, GLuint(*this), GL_INFO_LOG_LENGTH, &infoLogLength);
+
+	if (infoLogLength == 0)
+	{
+		return std::string();
+	}
+
+	// Get log
+	std::vector<GLchar> logStr(infoLogLength);
+	gl_call(glGetProgramPipelineInfoLog, GLuint(*this), infoLogLength, nullptr, logStr.data());
+
+	// exclude the null character from the range passed to string constructor
+	return std::string(logStr.begin(), logStr.end() - 1);
+}
@@ -54,11 +54,36 @@ void shader::source(const std::vector<std::string> &string) const
 	gl_call(glShaderSource, GLuint(*this), string.size(), cstr.data(), nullptr);
 }
 
+void shader::source(const std::vector<const char *> &string) const
+{
+	gl_call(glShaderSource, GLuint(*this), string.size(), string.data(), nullptr);
+}
+
+void shader::binary(GLenum binary_format, const void *binary, GLsizei length) const
+{
+	GLuint id = GLuint(*this);
+	gl_call(glShaderBinary, 1, &id, binary_format, binary, length);
+}
+
+void shader::specialize(const char *entry_point, GLuint count, const GLuint *indices, const GLuint *values) const
+{
+	gl_call(glSpecializeShader, GLuint(*this), entry_point, count, indices, values);
+}
+
 void shader::compile() const
+{
+	compile_deferred();
+	check_compile();
+}
+
+void shader::compile_deferred() const
 {
 	// Try to compile shader
 	gl_call(glCompileShader, GLuint(*this));
+}
 
+void shader::check_compile() const
+{
 	// Get status
 	GLint compileStatus;
 	gl_call(glGetShaderiv, GLuint(*this), GL_COMPILE_STATUS, &compileStatus);
@@ -69,6 +69,24 @@ void texture::image_2d(GLenum target, GLint level, GLint internalFormat, GLsizei
             data);
 }
 
+void texture::sub_image_2d(GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+						   GLenum format, GLenum type, const GLvoid *data) const
+{
+	gl_call(glTextureSubImage2D, GLuint(*this), level, xoffset, yoffset, width, height, format, type, data);
+}
+
+void texture::storage_2d(GLsizei levels, GLenum internalFormat, GLsizei width, GLsizei height) const
+{
+	gl_call(glTextureStorage2D, GLuint(*this), levels, internalFormat, width, height);
+}
+
+void texture::compressed_sub_image_2d(GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
+									  GLenum format, GLsizei imageSize, const GLvoid *data) const
+{
+	gl_call(glCompressedTextureSubImage2D, GLuint(*this), level, xoffset, yoffset, width, height, format,
+			imageSize, data);
+}
+
 void texture::generate_mipmap() const
 {
     gl_call(glGenerateTextureMipmap, GLuint(*this));
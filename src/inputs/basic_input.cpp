@@ -4,6 +4,10 @@
 
 #include "shadertoy/inputs/basic_input.hpp"
 
+#include "shadertoy/texture_budget.hpp"
+
+#include "shadertoy/utils/texture_cache.hpp"
+
 #include "shadertoy/utils/assert.hpp"
 
 using namespace shadertoy;
@@ -12,7 +16,7 @@ using namespace shadertoy::inputs;
 using shadertoy::utils::log;
 using shadertoy::utils::error_assert;
 
-basic_input::basic_input() : loaded_(false)
+basic_input::basic_input() : loaded_(false), last_use_frame_(0), last_texture_(nullptr), texture_bytes_(0)
 {
 	min_filter(GL_NEAREST);
 	mag_filter(GL_NEAREST);
@@ -37,6 +41,9 @@ void basic_input::reset()
 
 		reset_input();
 		loaded_ = false;
+
+		last_texture_ = nullptr;
+		texture_bytes_ = 0;
 	}
 }
 
@@ -45,7 +52,22 @@ gl::texture *basic_input::use()
 	// Load if needed
 	load();
 
-	return use_input();
+	auto texture(use_input());
+	bool changed = texture != last_texture_;
+	last_texture_ = texture;
+
+	if (auto budget = budget_.lock())
+	{
+		last_use_frame_ = budget->frame();
+
+		// Only measure textures when they change, i.e. once loaded
+		if (changed || (texture && texture_bytes_ == 0))
+		{
+			texture_bytes_ = texture ? utils::texture_cache::texture_bytes(*texture) : 0;
+		}
+	}
+
+	return texture;
 }
 
 GLint basic_input::min_filter() const
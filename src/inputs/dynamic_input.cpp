@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+#include "shadertoy/utils/assert.hpp"
+
+#include "shadertoy/inputs/dynamic_input.hpp"
+
+using namespace shadertoy;
+using namespace shadertoy::inputs;
+
+using shadertoy::gl::gl_call;
+using shadertoy::utils::error_assert;
+using shadertoy::utils::log;
+
+namespace
+{
+/// Alignment of the buffers in the ring
+constexpr size_t buffer_alignment = 256;
+
+/// Time to wait for pending copies when releasing the ring, in nanoseconds
+constexpr GLuint64 release_timeout = 1000000000;
+
+/// Get the size in bytes of a pixel of the given format and type, or 0 if it is not supported
+size_t pixel_bytes(GLenum format, GLenum type)
+{
+	size_t components = 0;
+	switch (format)
+	{
+	case GL_RED:
+	case GL_RED_INTEGER:
+	case GL_DEPTH_COMPONENT:
+		components = 1;
+		break;
+	case GL_RG:
+	case GL_RG_INTEGER:
+		components = 2;
+		break;
+	case GL_RGB:
+	case GL_BGR:
+	case GL_RGB_INTEGER:
+		components = 3;
+		break;
+	case GL_RGBA:
+	case GL_BGRA:
+	case GL_RGBA_INTEGER:
+		components = 4;
+		break;
+	}
+
+	switch (type)
+	{
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+		return components;
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+	case GL_HALF_FLOAT:
+		return components * 2;
+	case GL_UNSIGNED_INT:
+	case GL_INT:
+	case GL_FLOAT:
+		return components * 4;
+	default:
+		return 0;
+	}
+}
+}
+
+void dynamic_input::poll_fences(bool wait)
+{
+	for (auto &slot : slots_)
+	{
+		if (!slot.fence)
+		{
+			continue;
+		}
+
+		GLenum status = gl_call(glClientWaitSync, slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+								wait ? release_timeout : 0);
+
+		if (status == GL_TIMEOUT_EXPIRED && !wait)
+		{
+			continue;
+		}
+
+		gl_call(glDeleteSync, slot.fence);
+		slot.fence = nullptr;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		slot.state = slot_state::free;
+	}
+}
+
+void dynamic_input::load_input()
+{
+	error_assert(frame_bytes_ != 0, "Invalid size or pixel format for dynamic input {}",
+				 static_cast<const void *>(this));
+
+	// Immutable storage, so the copies do not respecify the texture
+	auto levels(static_cast<GLsizei>(std::log2(std::max(size_.width, size_.height))) + 1);
+
+	texture_ = std::make_unique<gl::texture>(GL_TEXTURE_2D);
+	texture_->storage_2d(levels, internal_format_, size_.width, size_.height);
+	texture_->clear_tex_image(0, format_, type_, nullptr);
+	texture_->generate_mipmap();
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	auto ring_bytes(static_cast<GLsizeiptr>(buffer_stride_ * buffer_count_));
+
+	ring_ = std::make_unique<gl::buffer>();
+	ring_->storage(ring_bytes, nullptr, flags);
+	auto mapped(static_cast<char *>(ring_->map_range(0, ring_bytes, flags)));
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		slots_.assign(buffer_count_, slot{ slot_state::free, nullptr });
+		writing_ = buffer_count_;
+		mapped_ = mapped;
+	}
+
+	log::shadertoy()->info("Allocated {}x{} dynamic texture with {} buffers of {} bytes for input {} (GL id {})",
+						   size_.width, size_.height, buffer_count_, frame_bytes_, static_cast<const void *>(this),
+						   GLuint(*texture_));
+}
+
+void dynamic_input::reset_input()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		error_assert(writing_ == buffer_count_, "Cannot reset dynamic input {} while a frame is mapped",
+					 static_cast<const void *>(this));
+
+		// Producers cannot map new frames from now on
+		mapped_ = nullptr;
+	}
+
+	poll_fences(true);
+
+	if (ring_)
+	{
+		ring_->unmap();
+	}
+
+	ring_.reset();
+	texture_.reset();
+	slots_.clear();
+}
+
+gl::texture *dynamic_input::use_input()
+{
+	if (!texture_)
+	{
+		return nullptr;
+	}
+
+	poll_fences(false);
+
+	size_t index = buffer_count_;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		auto it = std::find_if(slots_.begin(), slots_.end(),
+							   [](const auto &slot) { return slot.state == slot_state::ready; });
+
+		if (it != slots_.end())
+		{
+			it->state = slot_state::uploading;
+			index = it - slots_.begin();
+		}
+	}
+
+	if (index == buffer_count_)
+	{
+		return texture_.get();
+	}
+
+	ring_->bind(GL_PIXEL_UNPACK_BUFFER);
+
+	// Frame rows are tightly packed
+	GLint alignment;
+	gl_call(glGetIntegerv, GL_UNPACK_ALIGNMENT, &alignment);
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, 1);
+
+	texture_->sub_image_2d(0, 0, 0, size_.width, size_.height, format_, type_,
+						   reinterpret_cast<const void *>(index * buffer_stride_));
+
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, alignment);
+	ring_->unbind(GL_PIXEL_UNPACK_BUFFER);
+
+	// The buffer is released once the copy is complete
+	slots_[index].fence = gl_call(glFenceSync, GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	uploaded_frames_++;
+
+	if (min_filter() > GL_LINEAR)
+	{
+		texture_->generate_mipmap();
+	}
+
+	return texture_.get();
+}
+
+dynamic_input::dynamic_input(rsize size, GLenum internal_format, GLenum format, GLenum type, size_t buffer_count)
+: size_(size), internal_format_(internal_format), format_(format), type_(type),
+  buffer_count_(std::max<size_t>(2, buffer_count)),
+  frame_bytes_(static_cast<size_t>(size.width) * size.height * pixel_bytes(format, type)),
+  buffer_stride_((frame_bytes_ + buffer_alignment - 1) / buffer_alignment * buffer_alignment), mapped_(nullptr),
+  writing_(buffer_count_), uploaded_frames_(0), dropped_frames_(0)
+{
+}
+
+dynamic_input::~dynamic_input()
+{
+	if (!ring_)
+	{
+		return;
+	}
+
+	try
+	{
+		reset_input();
+	}
+	catch (const std::exception &ex)
+	{
+		log::shadertoy()->error("Cannot release dynamic input {}: {}", static_cast<const void *>(this), ex.what());
+	}
+}
+
+void *dynamic_input::map_next()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (!mapped_)
+	{
+		return nullptr;
+	}
+
+	error_assert(writing_ == buffer_count_, "A frame is already mapped for dynamic input {}",
+				 static_cast<const void *>(this));
+
+	// Use a free buffer, or replace the frame waiting to be uploaded
+	auto it = std::find_if(slots_.begin(), slots_.end(),
+						   [](const auto &slot) { return slot.state == slot_state::free; });
+
+	if (it == slots_.end())
+	{
+		it = std::find_if(slots_.begin(), slots_.end(),
+						  [](const auto &slot) { return slot.state == slot_state::ready; });
+
+		if (it == slots_.end())
+		{
+			return nullptr;
+		}
+
+		dropped_frames_++;
+	}
+
+	it->state = slot_state::writing;
+	writing_ = it - slots_.begin();
+
+	return mapped_ + writing_ * buffer_stride_;
+}
+
+void dynamic_input::commit()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	error_assert(writing_ != buffer_count_, "No frame is mapped for dynamic input {}",
+				 static_cast<const void *>(this));
+
+	// Only the latest frame is uploaded
+	for (auto &slot : slots_)
+	{
+		if (slot.state == slot_state::ready)
+		{
+			slot.state = slot_state::free;
+			dropped_frames_++;
+		}
+	}
+
+	slots_[writing_].state = slot_state::ready;
+	writing_ = buffer_count_;
+}
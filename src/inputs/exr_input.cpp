@@ -1,8 +1,20 @@
+#include <utility>
+
 #include <epoxy/gl.h>
 
 #if LIBSHADERTOY_OPENEXR
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <OpenEXR/ImfChannelList.h>
+#include <OpenEXR/ImfFrameBuffer.h>
+#include <OpenEXR/ImfHeader.h>
+#include <OpenEXR/ImfInputFile.h>
 #include <OpenEXR/ImfRgba.h>
 #include <OpenEXR/ImfRgbaFile.h>
+#include <OpenEXR/ImfThreading.h>
 #endif /* LIBSHADERTOY_OPENEXR */
 
 #include "shadertoy/gl.hpp"
@@ -16,40 +28,187 @@ using namespace shadertoy::utils;
 
 using shadertoy::utils::log;
 
-std::unique_ptr<gl::texture> exr_input::load_file(const std::string &filename, bool vflip)
+namespace
 {
-	std::unique_ptr<gl::texture> texture;
-
 #if LIBSHADERTOY_OPENEXR
-	log::shadertoy()->trace("Reading {} for input {}", filename, static_cast<const void *>(this));
+/// Get the number of threads decoding a file, creating OpenEXR's global pool on first use
+int exr_threads()
+{
+	static const int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	static std::once_flag initialized;
+
+	// The thread count of input files is ignored without a global pool, keep
+	// the pool of the application if it already created one
+	std::call_once(initialized, []() {
+		if (Imf::globalThreadCount() == 0)
+		{
+			Imf::setGlobalThreadCount(threads);
+		}
+	});
+
+	return threads;
+}
 
-	Imf::RgbaInputFile in(filename.c_str());
+/// Decode luminance/chroma images, which need the color conversion of the RGBA interface
+decoded_image decode_exr_rgba(const std::string &filename, bool vflip, int threads)
+{
+	Imf::RgbaInputFile in(filename.c_str(), threads);
 
 	Imath::Box2i win = in.dataWindow();
 
 	Imath::V2i dim(win.max.x - win.min.x + 1, win.max.y - win.min.y + 1);
 
-	std::vector<Imf::Rgba> pixelBuffer(dim.x * dim.y);
+	decoded_image image;
+	image.pixels.resize(sizeof(Imf::Rgba) * dim.x * dim.y);
+	auto pixelBuffer = reinterpret_cast<Imf::Rgba *>(image.pixels.data());
 
-	// Set buffer stride according to reading direction
+	// Set buffer stride according to reading direction, the frame buffer is
+	// addressed with data window coordinates
 	if (vflip)
 	{
-		in.setFrameBuffer(std::addressof(pixelBuffer[(dim.y - 1) * dim.x]), 1, -dim.x); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		in.setFrameBuffer(pixelBuffer + (dim.y - 1 + win.min.y) * dim.x - win.min.x, 1, -dim.x); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 	}
 	else
 	{
-		in.setFrameBuffer(pixelBuffer.data(), 1, dim.x);
+		in.setFrameBuffer(pixelBuffer - win.min.y * dim.x - win.min.x, 1, dim.x); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 	}
 
 	// Read the whole image
 	in.readPixels(win.min.y, win.max.y);
 
-	// Create a texture object
-	texture = std::make_unique<gl::texture>(GL_TEXTURE_2D);
-	texture->image_2d(GL_TEXTURE_2D, 0, GL_RGBA16F, dim.x, dim.y, 0, GL_RGBA, GL_HALF_FLOAT,
-					  pixelBuffer.data());
+	image.width = dim.x;
+	image.height = dim.y;
+	image.internal_format = (in.channels() & Imf::WRITE_A) ? GL_RGBA16F : GL_RGB16F;
+	image.format = GL_RGBA;
+	image.type = GL_HALF_FLOAT;
+
+	return image;
+}
+
+decoded_image decode_exr(const std::string &filename, bool vflip, const std::string &layer)
+{
+	log::shadertoy()->trace("Reading {}", filename);
+
+	// Decode scanline blocks and tiles on OpenEXR's thread pool
+	int threads = exr_threads();
+
+	Imf::InputFile in(filename.c_str(), threads);
+	const auto &channels(in.header().channels());
+
+	std::string prefix(layer.empty() ? std::string() : layer + ".");
+	auto find_channel = [&](const char *name) { return channels.findChannel((prefix + name).c_str()); };
+
+	// Luminance/chroma images are converted to RGB by the RGBA interface
+	if (layer.empty() && (find_channel("RY") || find_channel("BY")))
+	{
+		return decode_exr_rgba(filename, vflip, threads);
+	}
+
+	decoded_image image;
+	std::vector<std::string> names;
+
+	if (find_channel("R") || find_channel("G") || find_channel("B"))
+	{
+		if (find_channel("G") || find_channel("B") || find_channel("A"))
+			names = { "R", "G", "B" };
+		else
+			names = { "R" };
+
+		if (find_channel("A"))
+			names.emplace_back("A");
+	}
+	else if (find_channel("Y"))
+	{
+		names = { "Y" };
+		image.swizzle = { GL_RED, GL_RED, GL_RED, GL_ONE };
+
+		if (find_channel("A"))
+		{
+			names.emplace_back("A");
+			image.swizzle = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+		}
+	}
+	else
+	{
+		// Arbitrary channels, such as depth.Z, in name order
+		for (auto it = channels.begin(); it != channels.end() && names.size() < 4; ++it)
+		{
+			std::string name(it.name());
+			if (name.compare(0, prefix.size(), prefix) == 0 &&
+				name.find('.', prefix.size()) == std::string::npos)
+			{
+				names.emplace_back(name.substr(prefix.size()));
+			}
+		}
+	}
+
+	error_assert(!names.empty(), "Cannot load {}: no channels found in layer \"{}\"", filename, layer);
+
+	// Keep float32 precision when the file stores it
+	Imf::PixelType pixel_type = Imf::HALF;
+	for (const auto &name : names)
+	{
+		if (auto channel = find_channel(name.c_str()); channel && channel->type != Imf::HALF)
+		{
+			pixel_type = Imf::FLOAT;
+		}
+	}
+
+	Imath::Box2i win = in.header().dataWindow();
+	Imath::V2i dim(win.max.x - win.min.x + 1, win.max.y - win.min.y + 1);
+
+	size_t component_size = pixel_type == Imf::HALF ? sizeof(half) : sizeof(float);
+	size_t xstride = component_size * names.size(), ystride = xstride * dim.x;
+	image.pixels.resize(ystride * dim.y);
+
+	// The frame buffer is addressed with data window coordinates
+	char *base = image.pixels.data() - win.min.x * xstride; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	if (vflip)
+	{
+		base += (dim.y - 1 + win.min.y) * ystride; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	}
+	else
+	{
+		base -= win.min.y * ystride; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	}
+
+	Imf::FrameBuffer frame_buffer;
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		// Missing color channels read as 0, alpha as 1
+		frame_buffer.insert(prefix + names[i],
+							Imf::Slice(pixel_type, base + i * component_size, xstride, // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+									   vflip ? -static_cast<ptrdiff_t>(ystride) : static_cast<ptrdiff_t>(ystride),
+									   1, 1, names[i] == "A" ? 1.0 : 0.0));
+	}
+
+	in.setFrameBuffer(frame_buffer);
+	in.readPixels(win.min.y, win.max.y);
+
+	static const GLint half_formats[] = { GL_R16F, GL_RG16F, GL_RGB16F, GL_RGBA16F };
+	static const GLint float_formats[] = { GL_R32F, GL_RG32F, GL_RGB32F, GL_RGBA32F };
+	static const GLenum formats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+
+	image.width = dim.x;
+	image.height = dim.y;
+	image.internal_format = (pixel_type == Imf::HALF ? half_formats : float_formats)[names.size() - 1];
+	image.format = formats[names.size() - 1];
+	image.type = pixel_type == Imf::HALF ? GL_HALF_FLOAT : GL_FLOAT;
 
-	log::shadertoy()->info("Loaded {}x{} EXR {} for input {} (GL id {})", dim.x, dim.y, filename,
+	return image;
+}
+#endif /* LIBSHADERTOY_OPENEXR */
+}
+
+std::unique_ptr<gl::texture> exr_input::load_file(const std::string &filename, bool vflip)
+{
+	std::unique_ptr<gl::texture> texture;
+
+#if LIBSHADERTOY_OPENEXR
+	auto image(decode_exr(filename, vflip, layer_));
+	texture = upload_image(image);
+
+	log::shadertoy()->info("Loaded {}x{} EXR {} for input {} (GL id {})", image.width, image.height, filename,
 						   static_cast<const void *>(this), GLuint(*texture));
 #else  /* LIBSHADERTOY_OPENEXR */
 	error_assert(false, "Cannot load {} for input {}: OpenEXR support is disabled", filename,
@@ -59,8 +218,20 @@ std::unique_ptr<gl::texture> exr_input::load_file(const std::string &filename, b
 	return texture;
 }
 
+file_input::decoder_type exr_input::decoder() const
+{
+#if LIBSHADERTOY_OPENEXR
+	return [layer = layer_](const std::string &filename, bool vflip) { return decode_exr(filename, vflip, layer); };
+#else
+	return nullptr;
+#endif
+}
+
 exr_input::exr_input() = default;
 
-exr_input::exr_input(const std::string &filename) : file_input(filename) {}
+exr_input::exr_input(const std::string &filename, std::string layer)
+: file_input(filename), layer_(std::move(layer))
+{
+}
 
 bool exr_input::supported() { return LIBSHADERTOY_OPENEXR; }
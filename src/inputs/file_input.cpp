@@ -1,9 +1,13 @@
+#include <atomic>
+#include <chrono>
 #include <utility>
 
 #include <epoxy/gl.h>
 
 #include "shadertoy/gl.hpp"
 #include "shadertoy/utils/assert.hpp"
+#include "shadertoy/utils/texture_cache.hpp"
+#include "shadertoy/utils/thread_pool.hpp"
 
 #include "shadertoy/inputs/file_input.hpp"
 
@@ -18,7 +22,18 @@ namespace fs = std::experimental::filesystem::v1;
 using namespace shadertoy;
 using namespace shadertoy::inputs;
 
+using shadertoy::gl::gl_call;
 using shadertoy::utils::error_assert;
+using shadertoy::utils::log;
+
+namespace
+{
+/// Total size of the textures uploaded by file inputs
+std::atomic<size_t> total_uploaded_bytes(0);
+
+/// Total size of the same textures in GL_RGBA32F
+std::atomic<size_t> total_rgba32f_bytes(0);
+}
 
 std::unique_ptr<gl::texture> file_input::load_image()
 {
@@ -29,12 +44,112 @@ std::unique_ptr<gl::texture> file_input::load_image()
 		error_assert(fs::exists(filepath), "{}: file not found for input {}", filename_,
 					 static_cast<const void *>(this));
 
+		auto decode(decoder());
+		if (decode_pool_ && decode)
+		{
+			log::shadertoy()->trace("Queuing {} for decoding for input {}", filename_, static_cast<const void *>(this));
+
+			pending_image_ = decode_pool_->submit(
+			[decode, filename = filename_, vflip = vflip_]() { return decode(filename, vflip); });
+			return {};
+		}
+
 		return load_file(filename_, vflip_);
 	}
 
 	return {};
 }
 
-file_input::file_input() : vflip_(true) {}
+file_input::decoder_type file_input::decoder() const { return nullptr; }
+
+std::unique_ptr<gl::texture> file_input::upload_image(const decoded_image &image) const
+{
+	GLint internal_format = internal_format_ != 0 ? internal_format_ : image.internal_format;
+
+	auto texture(std::make_unique<gl::texture>(GL_TEXTURE_2D));
+	texture->image_2d(GL_TEXTURE_2D, 0, internal_format, image.width, image.height, 0, image.format,
+					  image.type, nullptr);
+
+	gl::buffer pbo;
+	pbo.data(static_cast<GLsizei>(image.pixels.size()), image.pixels.data(), GL_STREAM_DRAW);
+	pbo.bind(GL_PIXEL_UNPACK_BUFFER);
+
+	// Decoded rows are tightly packed
+	GLint alignment;
+	gl_call(glGetIntegerv, GL_UNPACK_ALIGNMENT, &alignment);
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, 1);
+
+	texture->sub_image_2d(0, 0, 0, image.width, image.height, image.format, image.type, nullptr);
+
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, alignment);
+	pbo.unbind(GL_PIXEL_UNPACK_BUFFER);
+
+	// The swizzle only applies to the format chosen by the decoder
+	if (internal_format == image.internal_format)
+	{
+		texture->parameter(GL_TEXTURE_SWIZZLE_R, image.swizzle[0]);
+		texture->parameter(GL_TEXTURE_SWIZZLE_G, image.swizzle[1]);
+		texture->parameter(GL_TEXTURE_SWIZZLE_B, image.swizzle[2]);
+		texture->parameter(GL_TEXTURE_SWIZZLE_A, image.swizzle[3]);
+	}
+
+	record_upload(utils::texture_cache::texture_bytes(*texture), image.width, image.height, internal_format);
+
+	return texture;
+}
+
+void file_input::record_upload(size_t bytes, GLsizei width, GLsizei height, GLint internal_format)
+{
+	size_t rgba32f_bytes = static_cast<size_t>(width) * height * 4 * sizeof(float);
+
+	total_uploaded_bytes += bytes;
+	total_rgba32f_bytes += rgba32f_bytes;
+
+	log::shadertoy()->debug("Uploaded {}x{} image as format {:#x} ({} bytes, {} bytes saved)", width, height,
+							internal_format, bytes, rgba32f_bytes > bytes ? rgba32f_bytes - bytes : 0);
+}
+
+bool file_input::poll_image(std::unique_ptr<gl::texture> &texture)
+{
+	if (!pending_image_.valid())
+	{
+		return false;
+	}
+
+	if (pending_image_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return true;
+	}
+
+	try
+	{
+		auto image(pending_image_.get());
+		texture = upload_image(image);
 
-file_input::file_input(std::string filename) : filename_(std::move(filename)), vflip_(true) {}
+		log::shadertoy()->info("Loaded {}x{} {} for input {} (GL id {})", image.width, image.height, filename_,
+							   static_cast<const void *>(this), GLuint(*texture));
+	}
+	catch (const std::exception &ex)
+	{
+		// Do not interrupt rendering, the input will use the error texture
+		log::shadertoy()->error("Cannot load {} for input {}: {}", filename_, static_cast<const void *>(this),
+								ex.what());
+	}
+
+	return false;
+}
+
+size_t file_input::uploaded_bytes() { return total_uploaded_bytes; }
+
+size_t file_input::saved_bytes()
+{
+	size_t uploaded = total_uploaded_bytes, rgba32f = total_rgba32f_bytes;
+	return rgba32f > uploaded ? rgba32f - uploaded : 0;
+}
+
+file_input::file_input() : vflip_(true), internal_format_(0) {}
+
+file_input::file_input(std::string filename)
+: filename_(std::move(filename)), vflip_(true), internal_format_(0)
+{
+}
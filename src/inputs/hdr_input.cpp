@@ -0,0 +1,262 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+#include "shadertoy/utils/assert.hpp"
+
+#include "shadertoy/inputs/hdr_input.hpp"
+
+using namespace shadertoy;
+using namespace shadertoy::inputs;
+
+using shadertoy::utils::error_assert;
+using shadertoy::utils::log;
+
+namespace
+{
+/// Shift a mantissa right, rounding to nearest even
+inline uint32_t round_shift(uint32_t mantissa, uint32_t shift)
+{
+	uint32_t result = mantissa >> shift;
+	uint32_t remainder = mantissa & ((1u << shift) - 1);
+	uint32_t halfway = 1u << (shift - 1);
+
+	return result + ((remainder > halfway || (remainder == halfway && (result & 1))) ? 1 : 0);
+}
+
+/**
+ * @brief Convert a positive float to a half float, rounding to nearest even
+ *
+ * Values too large for a half float are clamped to the largest finite value,
+ * which is preferable to infinities in shaders.
+ */
+inline uint16_t to_half(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xff) - 127 + 15;
+	uint32_t mantissa = bits & 0x7fffff;
+
+	if (exponent <= 0)
+	{
+		// Subnormal half, or zero
+		if (exponent < -10)
+			return 0;
+
+		return static_cast<uint16_t>(round_shift(mantissa | 0x800000, 14 - exponent));
+	}
+
+	// Rounding may carry into the exponent, which is still correct
+	uint32_t half = (static_cast<uint32_t>(exponent) << 10) + round_shift(mantissa, 13);
+	return static_cast<uint16_t>(std::min(half, 0x7bffu));
+}
+
+/// Convert rows of RGBE pixels to RGB half floats
+void convert_rgbe(const uint8_t *rgbe, uint16_t *rgb, size_t count)
+{
+	// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	for (size_t i = 0; i < count; ++i, rgbe += 4, rgb += 3)
+	{
+		// Same reconstruction as the Radiance library, with 0.5 bias
+		float scale = rgbe[3] == 0 ? 0.f : std::ldexp(1.f, static_cast<int>(rgbe[3]) - (128 + 8));
+
+		rgb[0] = to_half((rgbe[0] + 0.5f) * scale);
+		rgb[1] = to_half((rgbe[1] + 0.5f) * scale);
+		rgb[2] = to_half((rgbe[2] + 0.5f) * scale);
+	}
+	// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+/// Reader for the RGBE scanlines of a file
+class scanline_reader
+{
+	const std::vector<uint8_t> &data_;
+	size_t pos_;
+	const std::string &filename_;
+
+	uint8_t next()
+	{
+		error_assert(pos_ < data_.size(), "Cannot load {}: unexpected end of file", filename_);
+		return data_[pos_++];
+	}
+
+	/// Decode a flat scanline, possibly using the old run-length encoding
+	void read_flat(uint8_t *out, size_t width)
+	{
+		int shift = 0;
+		for (size_t x = 0; x < width;)
+		{
+			uint8_t px[4] = { next(), next(), next(), next() };
+
+			if (px[0] == 1 && px[1] == 1 && px[2] == 1)
+			{
+				// Repeat the previous pixel
+				error_assert(x > 0, "Cannot load {}: invalid run at the start of a scanline", filename_);
+
+				// Consecutive runs multiply the count by 256, more than three exceed any width
+				error_assert(shift < 24, "Cannot load {}: too many consecutive runs", filename_);
+
+				size_t count = static_cast<size_t>(px[3]) << shift;
+				error_assert(x + count <= width, "Cannot load {}: run exceeds scanline", filename_);
+
+				for (size_t i = 0; i < count; ++i, ++x)
+					memcpy(&out[x * 4], &out[(x - 1) * 4], 4);
+
+				shift += 8;
+			}
+			else
+			{
+				memcpy(&out[x * 4], px, 4);
+				x++;
+				shift = 0;
+			}
+		}
+	}
+
+public:
+	scanline_reader(const std::vector<uint8_t> &data, size_t pos, const std::string &filename)
+	: data_(data), pos_(pos), filename_(filename)
+	{
+	}
+
+	void read(uint8_t *out, size_t width)
+	{
+		// New run-length encoding: 2 2 followed by the scanline width
+		if (width < 8 || width > 0x7fff || pos_ + 4 > data_.size() || data_[pos_] != 2 || data_[pos_ + 1] != 2 ||
+			(data_[pos_ + 2] & 0x80) != 0)
+		{
+			read_flat(out, width);
+			return;
+		}
+
+		size_t encoded_width = (static_cast<size_t>(data_[pos_ + 2]) << 8) | data_[pos_ + 3];
+		error_assert(encoded_width == width, "Cannot load {}: invalid scanline width", filename_);
+		pos_ += 4;
+
+		// Components are encoded one after the other
+		for (size_t c = 0; c < 4; ++c)
+		{
+			for (size_t x = 0; x < width;)
+			{
+				size_t count = next();
+
+				if (count > 128)
+				{
+					count -= 128;
+					error_assert(x + count <= width, "Cannot load {}: run exceeds scanline", filename_);
+
+					uint8_t value = next();
+					for (size_t i = 0; i < count; ++i, ++x)
+						out[x * 4 + c] = value;
+				}
+				else
+				{
+					error_assert(count > 0 && x + count <= width, "Cannot load {}: invalid scanline data",
+								 filename_);
+
+					for (size_t i = 0; i < count; ++i, ++x)
+						out[x * 4 + c] = next();
+				}
+			}
+		}
+	}
+};
+
+decoded_image decode_hdr(const std::string &filename, bool vflip)
+{
+	log::shadertoy()->trace("Reading {}", filename);
+
+	std::ifstream src(filename, std::ios::binary | std::ios::ate);
+	error_assert(src.is_open(), "Cannot load {}: failed to open file for reading", filename);
+
+	std::vector<uint8_t> data(static_cast<size_t>(src.tellg()));
+	src.seekg(0);
+	src.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+	error_assert(!src.fail(), "Cannot load {}: failed to read file", filename);
+
+	// Header lines, up to an empty line
+	size_t pos = 0;
+	auto read_line = [&]() {
+		size_t end = std::find(data.begin() + pos, data.end(), '\n') - data.begin();
+		error_assert(end < data.size(), "Cannot load {}: unexpected end of header", filename);
+
+		std::string line(data.begin() + pos, data.begin() + end);
+		pos = end + 1;
+		return line;
+	};
+
+	auto magic(read_line());
+	error_assert(magic == "#?RADIANCE" || magic == "#?RGBE", "Cannot load {}: not a Radiance HDR file", filename);
+
+	for (std::string line = read_line(); !line.empty(); line = read_line())
+	{
+		if (line.compare(0, 7, "FORMAT=") == 0)
+		{
+			error_assert(line == "FORMAT=32-bit_rle_rgbe", "Cannot load {}: unsupported {}", filename, line);
+		}
+	}
+
+	// Resolution line, only the standard orientations are supported
+	std::istringstream resolution(read_line());
+	std::string y_axis, x_axis;
+	long height = 0, width = 0;
+	resolution >> y_axis >> height >> x_axis >> width;
+
+	error_assert(!resolution.fail() && (y_axis == "-Y" || y_axis == "+Y") && x_axis == "+X" && width > 0 &&
+				 height > 0,
+				 "Cannot load {}: unsupported image orientation or size", filename);
+
+	// -Y stores the top scanline first, GL textures start at the bottom
+	bool bottom_up = (y_axis == "+Y") != vflip;
+
+	size_t w = static_cast<size_t>(width), h = static_cast<size_t>(height);
+	std::vector<uint8_t> rgbe(w * h * 4);
+
+	scanline_reader reader(data, pos, filename);
+	for (size_t y = 0; y < h; ++y)
+	{
+		size_t row = bottom_up ? h - 1 - y : y;
+		reader.read(&rgbe[row * w * 4], w);
+	}
+
+	decoded_image image;
+	image.width = static_cast<GLsizei>(w);
+	image.height = static_cast<GLsizei>(h);
+	image.internal_format = GL_RGB16F;
+	image.format = GL_RGB;
+	image.type = GL_HALF_FLOAT;
+	image.pixels.resize(w * h * 3 * sizeof(uint16_t));
+
+	// Decoders already run on the thread pool, so the conversion stays on this thread
+	convert_rgbe(rgbe.data(), reinterpret_cast<uint16_t *>(image.pixels.data()), w * h);
+
+	return image;
+}
+}
+
+std::unique_ptr<gl::texture> hdr_input::load_file(const std::string &filename, bool vflip)
+{
+	auto image(decode_hdr(filename, vflip));
+	auto texture(upload_image(image));
+
+	log::shadertoy()->info("Loaded {}x{} HDR {} for input {} (GL id {})", image.width, image.height, filename,
+						   static_cast<const void *>(this), GLuint(*texture));
+
+	return texture;
+}
+
+file_input::decoder_type hdr_input::decoder() const { return &decode_hdr; }
+
+hdr_input::hdr_input() = default;
+
+hdr_input::hdr_input(const std::string &filename) : file_input(filename) {}
+
+bool hdr_input::supported() { return true; }
@@ -7,6 +7,27 @@
 using namespace shadertoy;
 using namespace shadertoy::inputs;
 
+namespace
+{
+/**
+ * @brief Generate the mipmaps of a loaded image
+ *
+ * Textures which already store their mipmaps, or which use a compressed
+ * format that cannot be rendered to, are left untouched.
+ */
+void generate_mipmap(const gl::texture &texture)
+{
+	GLint compressed, level1_width;
+	texture.get_parameter(0, GL_TEXTURE_COMPRESSED, &compressed);
+	texture.get_parameter(1, GL_TEXTURE_WIDTH, &level1_width);
+
+	if (!compressed && level1_width == 0)
+	{
+		texture.generate_mipmap();
+	}
+}
+}
+
 void image_input::load_input()
 {
 	image_texture_ = load_image();
@@ -15,12 +36,53 @@ void image_input::load_input()
 	// the sampler settings afterwards from non-mipmap to mipmap
 	if (image_texture_)
 	{
-		image_texture_->generate_mipmap();
+		generate_mipmap(*image_texture_);
+	}
+	else
+	{
+		// The image may be loaded asynchronously
+		pending_ = true;
 	}
 }
 
-void image_input::reset_input() { image_texture_.reset(); }
+void image_input::reset_input()
+{
+	image_texture_.reset();
+	pending_ = false;
+}
+
+gl::texture *image_input::use_input()
+{
+	if (pending_)
+	{
+		if (poll_image(image_texture_))
+		{
+			if (!placeholder_)
+			{
+				uint8_t black[4] = { 0 };
+
+				placeholder_ = std::make_unique<gl::texture>(GL_TEXTURE_2D);
+				placeholder_->image_2d(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, black);
+
+				// Complete with mipmapping samplers
+				placeholder_->parameter(GL_TEXTURE_MAX_LEVEL, 0);
+			}
+
+			return placeholder_.get();
+		}
+
+		pending_ = false;
+		placeholder_.reset();
+
+		if (image_texture_)
+		{
+			generate_mipmap(*image_texture_);
+		}
+	}
+
+	return image_texture_.get();
+}
 
-gl::texture *image_input::use_input() { return image_texture_.get(); }
+bool image_input::poll_image(std::unique_ptr<gl::texture> &texture) { return false; }
 
-image_input::image_input() : image_texture_() {}
+image_input::image_input() : image_texture_(), pending_(false) {}
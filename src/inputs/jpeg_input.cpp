@@ -2,8 +2,10 @@
 #include <epoxy/gl.h>
 
 #if LIBSHADERTOY_JPEG
+#include <algorithm>
 #include <cstdio>
 #include <jpeglib.h>
+#include <vector>
 #endif /* LIBSHADERTOY_JPEG */
 
 #include "shadertoy/gl.hpp"
@@ -17,84 +19,118 @@ using namespace shadertoy::inputs;
 using shadertoy::utils::log;
 using shadertoy::utils::error_assert;
 
-std::unique_ptr<gl::texture> jpeg_input::load_file(const std::string &filename, bool vflip)
+namespace
 {
-	std::unique_ptr<gl::texture> texture;
-
 #if LIBSHADERTOY_JPEG
+decoded_image decode_jpeg(const std::string &filename, bool vflip, GLsizei max_dimension)
+{
+	decoded_image image;
+
 	// use libjpeg
 	FILE *infile;
 	if ((infile = fopen(filename.c_str(), "rbe")) == nullptr)
 	{
-		error_assert(false, "Cannot load {} for input {}: failed to open file for reading",
-					 filename, static_cast<const void *>(this));
+		error_assert(false, "Cannot load {}: failed to open file for reading", filename);
 	}
-	else
-	{
-		log::shadertoy()->trace("Reading {} for input {}", filename, static_cast<const void *>(this));
 
-		struct jpeg_decompress_struct cinfo
-		{
-		};
-		struct jpeg_error_mgr jerr
-		{
-		};
-		cinfo.err = jpeg_std_error(&jerr);
+	log::shadertoy()->trace("Reading {}", filename);
 
-		jpeg_create_decompress(&cinfo);
-		jpeg_stdio_src(&cinfo, infile);
+	struct jpeg_decompress_struct cinfo
+	{
+	};
+	struct jpeg_error_mgr jerr
+	{
+	};
+	cinfo.err = jpeg_std_error(&jerr);
 
-		jpeg_read_header(&cinfo, TRUE);
-		jpeg_start_decompress(&cinfo);
+	jpeg_create_decompress(&cinfo);
+	jpeg_stdio_src(&cinfo, infile);
 
-		GLenum fmt = GL_RGB;
-		if (cinfo.output_components == 1)
-		{
-			fmt = GL_RED;
-		}
-		else if (cinfo.output_components == 4)
-		{
-			fmt = GL_RGBA;
-		}
-		else if (cinfo.output_components != 3)
-		{
-			// Don't decode unknown format
-			jpeg_finish_decompress(&cinfo);
-			jpeg_destroy_decompress(&cinfo);
-			fclose(infile);
-
-			error_assert(false, "Cannot load {} for input {}: unsupported component count {}",
-						 filename, static_cast<const void *>(this), cinfo.output_components);
-		}
+	jpeg_read_header(&cinfo, TRUE);
 
-		int stride = cinfo.output_width * cinfo.output_components;
-		JSAMPARRAY buffer =
-		(*cinfo.mem->alloc_sarray)(reinterpret_cast<j_common_ptr>(&cinfo), JPOOL_IMAGE, stride, 1);
-		std::vector<char> imgbuf_vec(cinfo.output_height * stride);
-		char *imgbuf(imgbuf_vec.data());
+	// Let the IDCT decode at 1/2, 1/4 or 1/8 scale, as long as the result
+	// is still at least max_dimension pixels on its largest side
+	if (max_dimension > 0)
+	{
+		JDIMENSION largest = std::max(cinfo.image_width, cinfo.image_height);
+		unsigned int denom = 1;
 
-		while (cinfo.output_scanline < cinfo.output_height)
+		while (denom < 8 && (largest + denom * 2 - 1) / (denom * 2) >= static_cast<JDIMENSION>(max_dimension))
 		{
-			JDIMENSION read_now = jpeg_read_scanlines(&cinfo, buffer, 1);
-			size_t off = cinfo.output_scanline - read_now;
-			if (vflip)
-			{
-				off = cinfo.output_height - off - read_now;
-			}
-			memcpy(std::addressof(imgbuf[off * stride]), buffer[0], stride);
+			denom *= 2;
 		}
 
-		texture = std::make_unique<gl::texture>(GL_TEXTURE_2D);
-		texture->image_2d(GL_TEXTURE_2D, 0, GL_RGBA32F, cinfo.output_width, cinfo.output_height,
-						  0, fmt, GL_UNSIGNED_BYTE, imgbuf);
+		cinfo.scale_num = 1;
+		cinfo.scale_denom = denom;
+	}
+
+	jpeg_start_decompress(&cinfo);
 
-		jpeg_finish_decompress(&cinfo);
+	GLenum fmt = GL_RGB;
+	GLint internal_format = GL_RGB8;
+	if (cinfo.output_components == 1)
+	{
+		fmt = GL_RED;
+		internal_format = GL_R8;
+	}
+	else if (cinfo.output_components == 4)
+	{
+		fmt = GL_RGBA;
+		internal_format = GL_RGBA8;
+	}
+	else if (cinfo.output_components != 3)
+	{
+		// Don't decode unknown format
+		int components = cinfo.output_components;
+		jpeg_abort_decompress(&cinfo);
 		jpeg_destroy_decompress(&cinfo);
 		fclose(infile);
 
-		log::shadertoy()->info("Loaded {}x{} JPEG {} for input {} (GL id {})", cinfo.output_width,
-							   cinfo.output_height, filename, static_cast<const void *>(this), GLuint(*texture));
+		error_assert(false, "Cannot load {}: unsupported component count {}", filename, components);
 	}
+
+	size_t stride = static_cast<size_t>(cinfo.output_width) * cinfo.output_components;
+	image.pixels.resize(cinfo.output_height * stride);
+
+	// Decode straight into the final buffer, flipping through the row pointers
+	std::vector<JSAMPROW> rows(cinfo.output_height);
+	for (JDIMENSION row = 0; row < cinfo.output_height; ++row)
+	{
+		JDIMENSION target = vflip ? cinfo.output_height - 1 - row : row;
+		rows[row] = reinterpret_cast<JSAMPROW>(std::addressof(image.pixels[target * stride]));
+	}
+
+	while (cinfo.output_scanline < cinfo.output_height)
+	{
+		jpeg_read_scanlines(&cinfo, std::addressof(rows[cinfo.output_scanline]),
+							cinfo.output_height - cinfo.output_scanline);
+	}
+
+	image.width = cinfo.output_width;
+	image.height = cinfo.output_height;
+	image.internal_format = internal_format;
+	image.format = fmt;
+	image.type = GL_UNSIGNED_BYTE;
+
+	jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+	fclose(infile);
+
+	return image;
+}
+#endif /* LIBSHADERTOY_JPEG */
+}
+
+std::unique_ptr<gl::texture> jpeg_input::load_file(const std::string &filename, bool vflip)
+{
+	std::unique_ptr<gl::texture> texture;
+
+#if LIBSHADERTOY_JPEG
+	auto image(decode_jpeg(filename, vflip, max_dimension_));
+	texture = upload_image(image);
+
+	log::shadertoy()->info("Loaded {}x{} JPEG {} for input {} (GL id {})", image.width, image.height, filename,
+						   static_cast<const void *>(this), GLuint(*texture));
 #else /* LIBSHADERTOY_JPEG */
 	error_assert(false, "Cannot load {} for input {}: JPEG support is disabled", filename,
 				 static_cast<const void *>(this));
@@ -103,8 +139,19 @@ std::unique_ptr<gl::texture> jpeg_input::load_file(const std::string &filename,
 	return texture;
 }
 
-jpeg_input::jpeg_input() = default;
+file_input::decoder_type jpeg_input::decoder() const
+{
+#if LIBSHADERTOY_JPEG
+	return [max_dimension = max_dimension_](const std::string &filename, bool vflip) {
+		return decode_jpeg(filename, vflip, max_dimension);
+	};
+#else
+	return nullptr;
+#endif
+}
+
+jpeg_input::jpeg_input() : max_dimension_(0) {}
 
-jpeg_input::jpeg_input(const std::string &filename) : file_input(filename) {}
+jpeg_input::jpeg_input(const std::string &filename) : file_input(filename), max_dimension_(0) {}
 
 bool jpeg_input::supported() { return LIBSHADERTOY_JPEG; }
@@ -0,0 +1,503 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+#include "shadertoy/utils/assert.hpp"
+
+#include "shadertoy/inputs/ktx_input.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LIBSHADERTOY_MMAP 1
+#else
+#define LIBSHADERTOY_MMAP 0
+#endif
+
+using namespace shadertoy;
+using namespace shadertoy::inputs;
+
+using shadertoy::gl::gl_call;
+using shadertoy::utils::error_assert;
+using shadertoy::utils::log;
+
+namespace
+{
+
+/// Read-only contents of a file, memory-mapped where supported
+class mapped_file
+{
+	/// Pointer to the contents of the file
+	const char *data_;
+
+	/// Size of the file
+	size_t size_;
+
+#if LIBSHADERTOY_MMAP
+	/// Mapping of the file, or null if it is empty
+	void *mapping_;
+#else
+	/// Contents of the file
+	std::vector<char> contents_;
+#endif
+
+public:
+	explicit mapped_file(const std::string &filename) : data_(nullptr), size_(0)
+	{
+#if LIBSHADERTOY_MMAP
+		mapping_ = nullptr;
+
+		int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+		error_assert(fd >= 0, "Cannot load {}: failed to open file for reading", filename);
+
+		struct stat st
+		{
+		};
+		if (fstat(fd, &st) == 0 && st.st_size > 0)
+		{
+			size_ = static_cast<size_t>(st.st_size);
+			mapping_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		}
+
+		close(fd);
+
+		if (mapping_ == MAP_FAILED)
+		{
+			mapping_ = nullptr;
+			error_assert(false, "Cannot load {}: failed to map file", filename);
+		}
+
+		data_ = static_cast<const char *>(mapping_);
+#else
+		std::ifstream src(filename, std::ios::binary);
+		error_assert(src.is_open(), "Cannot load {}: failed to open file for reading", filename);
+
+		contents_.assign(std::istreambuf_iterator<char>(src), std::istreambuf_iterator<char>());
+		data_ = contents_.data();
+		size_ = contents_.size();
+#endif
+	}
+
+	~mapped_file()
+	{
+#if LIBSHADERTOY_MMAP
+		if (mapping_)
+		{
+			munmap(mapping_, size_);
+		}
+#endif
+	}
+
+	mapped_file(const mapped_file &) = delete;
+	mapped_file &operator=(const mapped_file &) = delete;
+
+	inline const char *data() const { return data_; }
+
+	inline size_t size() const { return size_; }
+
+	/// Read a little-endian value at the given offset
+	template <typename T> T read(size_t offset, const std::string &filename) const
+	{
+		error_assert(offset + sizeof(T) <= size_, "Cannot load {}: unexpected end of file", filename);
+
+		T value;
+		memcpy(&value, data_ + offset, sizeof(T)); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		return value;
+	}
+};
+
+/// Texture format stored in a container
+struct format_info
+{
+	/// Format identifier in the container (VkFormat or DXGI_FORMAT)
+	uint32_t id;
+
+	/// Internal format of the texture
+	GLenum internal_format;
+
+	/// Format of the pixel data, or 0 for compressed formats
+	GLenum format;
+
+	/// Type of the pixel data, or 0 for compressed formats
+	GLenum type;
+
+	/// Bytes per block of 4x4 texels for compressed formats, bytes per texel otherwise
+	size_t bytes;
+};
+
+/// Formats supported in KTX2 files, by VkFormat
+const format_info vk_formats[] = {
+	{ 9, GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1 },
+	{ 16, GL_RG8, GL_RG, GL_UNSIGNED_BYTE, 2 },
+	{ 23, GL_RGB8, GL_RGB, GL_UNSIGNED_BYTE, 3 },
+	{ 29, GL_SRGB8, GL_RGB, GL_UNSIGNED_BYTE, 3 },
+	{ 37, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 },
+	{ 43, GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 },
+	{ 44, GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE, 4 },
+	{ 50, GL_SRGB8_ALPHA8, GL_BGRA, GL_UNSIGNED_BYTE, 4 },
+	{ 76, GL_R16F, GL_RED, GL_HALF_FLOAT, 2 },
+	{ 83, GL_RG16F, GL_RG, GL_HALF_FLOAT, 4 },
+	{ 97, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8 },
+	{ 100, GL_R32F, GL_RED, GL_FLOAT, 4 },
+	{ 103, GL_RG32F, GL_RG, GL_FLOAT, 8 },
+	{ 109, GL_RGBA32F, GL_RGBA, GL_FLOAT, 16 },
+	{ 131, GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 0, 0, 8 },
+	{ 132, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, 0, 0, 8 },
+	{ 133, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0, 0, 8 },
+	{ 134, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 0, 0, 8 },
+	{ 135, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 0, 0, 16 },
+	{ 136, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, 0, 0, 16 },
+	{ 137, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0, 0, 16 },
+	{ 138, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 0, 0, 16 },
+	{ 139, GL_COMPRESSED_RED_RGTC1, 0, 0, 8 },
+	{ 140, GL_COMPRESSED_SIGNED_RED_RGTC1, 0, 0, 8 },
+	{ 141, GL_COMPRESSED_RG_RGTC2, 0, 0, 16 },
+	{ 142, GL_COMPRESSED_SIGNED_RG_RGTC2, 0, 0, 16 },
+	{ 143, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, 0, 0, 16 },
+	{ 144, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, 0, 0, 16 },
+	{ 145, GL_COMPRESSED_RGBA_BPTC_UNORM, 0, 0, 16 },
+	{ 146, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 0, 0, 16 },
+	{ 147, GL_COMPRESSED_RGB8_ETC2, 0, 0, 8 },
+	{ 148, GL_COMPRESSED_SRGB8_ETC2, 0, 0, 8 },
+	{ 149, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 0, 0, 8 },
+	{ 150, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2, 0, 0, 8 },
+	{ 151, GL_COMPRESSED_RGBA8_ETC2_EAC, 0, 0, 16 },
+	{ 152, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC, 0, 0, 16 },
+	{ 153, GL_COMPRESSED_R11_EAC, 0, 0, 8 },
+	{ 154, GL_COMPRESSED_SIGNED_R11_EAC, 0, 0, 8 },
+	{ 155, GL_COMPRESSED_RG11_EAC, 0, 0, 16 },
+	{ 156, GL_COMPRESSED_SIGNED_RG11_EAC, 0, 0, 16 },
+};
+
+/// Formats supported in DDS files with a DX10 header, by DXGI_FORMAT
+const format_info dxgi_formats[] = {
+	{ 2, GL_RGBA32F, GL_RGBA, GL_FLOAT, 16 },
+	{ 10, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT, 8 },
+	{ 16, GL_RG32F, GL_RG, GL_FLOAT, 8 },
+	{ 28, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 },
+	{ 29, GL_SRGB8_ALPHA8, GL_RGBA, GL_UNSIGNED_BYTE, 4 },
+	{ 34, GL_RG16F, GL_RG, GL_HALF_FLOAT, 4 },
+	{ 41, GL_R32F, GL_RED, GL_FLOAT, 4 },
+	{ 49, GL_RG8, GL_RG, GL_UNSIGNED_BYTE, 2 },
+	{ 54, GL_R16F, GL_RED, GL_HALF_FLOAT, 2 },
+	{ 61, GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1 },
+	{ 71, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0, 0, 8 },
+	{ 72, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 0, 0, 8 },
+	{ 74, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 0, 0, 16 },
+	{ 75, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT, 0, 0, 16 },
+	{ 77, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0, 0, 16 },
+	{ 78, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 0, 0, 16 },
+	{ 80, GL_COMPRESSED_RED_RGTC1, 0, 0, 8 },
+	{ 81, GL_COMPRESSED_SIGNED_RED_RGTC1, 0, 0, 8 },
+	{ 83, GL_COMPRESSED_RG_RGTC2, 0, 0, 16 },
+	{ 84, GL_COMPRESSED_SIGNED_RG_RGTC2, 0, 0, 16 },
+	{ 87, GL_RGBA8, GL_BGRA, GL_UNSIGNED_BYTE, 4 },
+	{ 91, GL_SRGB8_ALPHA8, GL_BGRA, GL_UNSIGNED_BYTE, 4 },
+	{ 95, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT, 0, 0, 16 },
+	{ 96, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT, 0, 0, 16 },
+	{ 98, GL_COMPRESSED_RGBA_BPTC_UNORM, 0, 0, 16 },
+	{ 99, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 0, 0, 16 },
+};
+
+template <size_t N> const format_info *find_format(const format_info (&formats)[N], uint32_t id)
+{
+	auto it = std::find_if(std::begin(formats), std::end(formats), [id](const auto &info) { return info.id == id; });
+	return it == std::end(formats) ? nullptr : it;
+}
+
+constexpr uint32_t fourcc(const char (&code)[5])
+{
+	return static_cast<uint32_t>(code[0]) | (static_cast<uint32_t>(code[1]) << 8) |
+		   (static_cast<uint32_t>(code[2]) << 16) | (static_cast<uint32_t>(code[3]) << 24);
+}
+
+/// Mip level stored in a container
+struct container_level
+{
+	/// Offset of the level data in the file
+	size_t offset;
+
+	/// Size of the level data
+	size_t size;
+};
+
+/// 2D image stored in a container
+struct container_image
+{
+	/// Format of the image
+	format_info format;
+
+	/// Width of the first level
+	GLsizei width;
+
+	/// Height of the first level
+	GLsizei height;
+
+	/// Stored levels, largest first
+	std::vector<container_level> levels;
+
+	/// true if the levels below the first one must be generated
+	bool generate_mipmaps;
+};
+
+/// Number of levels of a complete mipmap chain for the given dimensions
+uint32_t mipmap_levels(GLsizei width, GLsizei height)
+{
+	uint32_t levels = 1;
+	for (auto size = static_cast<uint32_t>(std::max(width, height)); size > 1; size >>= 1)
+	{
+		++levels;
+	}
+
+	return levels;
+}
+
+/// Expected size of a level of the given dimensions
+size_t level_size(const format_info &format, GLsizei width, GLsizei height)
+{
+	if (format.format == 0)
+	{
+		return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * format.bytes;
+	}
+
+	return static_cast<size_t>(width) * height * format.bytes;
+}
+
+container_image parse_ktx2(const mapped_file &file, const std::string &filename)
+{
+	container_image image{};
+
+	auto vk_format = file.read<uint32_t>(12, filename);
+	image.width = file.read<uint32_t>(20, filename);
+	image.height = file.read<uint32_t>(24, filename);
+	auto depth = file.read<uint32_t>(28, filename);
+	auto layers = file.read<uint32_t>(32, filename);
+	auto faces = file.read<uint32_t>(36, filename);
+	auto level_count = file.read<uint32_t>(40, filename);
+	auto supercompression = file.read<uint32_t>(44, filename);
+
+	error_assert(image.width > 0 && image.height > 0 && depth <= 1 && layers <= 1 && faces == 1,
+				 "Cannot load {}: only 2D KTX2 textures are supported", filename);
+	error_assert(supercompression == 0, "Cannot load {}: supercompressed KTX2 files are not supported", filename);
+	error_assert(level_count <= mipmap_levels(image.width, image.height),
+				 "Cannot load {}: too many levels ({}) for a {}x{} texture", filename, level_count, image.width,
+				 image.height);
+
+	auto format = find_format(vk_formats, vk_format);
+	error_assert(format != nullptr, "Cannot load {}: unsupported KTX2 format {}", filename, vk_format);
+	image.format = *format;
+
+	// A level count of 0 requests the mipmaps to be generated from the only stored level
+	image.generate_mipmaps = level_count == 0;
+	error_assert(!image.generate_mipmaps || image.format.format != 0,
+				 "Cannot load {}: mipmaps cannot be generated for compressed KTX2 textures", filename);
+
+	auto levels = std::max(level_count, 1u);
+
+	// Level index, largest level first
+	for (uint32_t level = 0; level < levels; ++level)
+	{
+		size_t entry = 80 + level * 24;
+		image.levels.push_back({ static_cast<size_t>(file.read<uint64_t>(entry, filename)),
+								 static_cast<size_t>(file.read<uint64_t>(entry + 8, filename)) });
+	}
+
+	return image;
+}
+
+container_image parse_dds(const mapped_file &file, const std::string &filename)
+{
+	constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+	constexpr uint32_t DDPF_ALPHAPIXELS = 0x1;
+	constexpr uint32_t DDPF_FOURCC = 0x4;
+	constexpr uint32_t DDPF_RGB = 0x40;
+	constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+	constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+	constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+	container_image image{};
+
+	error_assert(file.read<uint32_t>(4, filename) == 124, "Cannot load {}: invalid DDS header", filename);
+
+	auto flags = file.read<uint32_t>(8, filename);
+	image.height = file.read<uint32_t>(12, filename);
+	image.width = file.read<uint32_t>(16, filename);
+	uint32_t levels = (flags & DDSD_MIPMAPCOUNT) ? std::max(file.read<uint32_t>(28, filename), 1u) : 1u;
+
+	error_assert(image.width > 0 && image.height > 0, "Cannot load {}: invalid DDS dimensions", filename);
+	error_assert(levels <= mipmap_levels(image.width, image.height),
+				 "Cannot load {}: too many levels ({}) for a {}x{} texture", filename, levels, image.width,
+				 image.height);
+
+	auto pf_flags = file.read<uint32_t>(80, filename);
+	auto pf_fourcc = file.read<uint32_t>(84, filename);
+	auto caps2 = file.read<uint32_t>(112, filename);
+
+	error_assert((caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) == 0,
+				 "Cannot load {}: only 2D DDS textures are supported", filename);
+
+	size_t offset = 128;
+	const format_info *format = nullptr;
+	format_info rgb_format{};
+
+	if ((pf_flags & DDPF_FOURCC) && pf_fourcc == fourcc("DX10"))
+	{
+		auto dxgi_format = file.read<uint32_t>(128, filename);
+		auto misc_flag = file.read<uint32_t>(136, filename);
+		auto array_size = file.read<uint32_t>(140, filename);
+
+		error_assert((misc_flag & DDS_RESOURCE_MISC_TEXTURECUBE) == 0 && array_size <= 1,
+					 "Cannot load {}: only 2D DDS textures are supported", filename);
+
+		format = find_format(dxgi_formats, dxgi_format);
+		error_assert(format != nullptr, "Cannot load {}: unsupported DXGI format {}", filename, dxgi_format);
+
+		offset = 148;
+	}
+	else if (pf_flags & DDPF_FOURCC)
+	{
+		// Legacy block-compressed formats
+		uint32_t dxgi_format = 0;
+		if (pf_fourcc == fourcc("DXT1"))
+			dxgi_format = 71;
+		else if (pf_fourcc == fourcc("DXT3"))
+			dxgi_format = 74;
+		else if (pf_fourcc == fourcc("DXT5"))
+			dxgi_format = 77;
+		else if (pf_fourcc == fourcc("ATI1") || pf_fourcc == fourcc("BC4U"))
+			dxgi_format = 80;
+		else if (pf_fourcc == fourcc("BC4S"))
+			dxgi_format = 81;
+		else if (pf_fourcc == fourcc("ATI2") || pf_fourcc == fourcc("BC5U"))
+			dxgi_format = 83;
+		else if (pf_fourcc == fourcc("BC5S"))
+			dxgi_format = 84;
+
+		format = find_format(dxgi_formats, dxgi_format);
+		error_assert(format != nullptr, "Cannot load {}: unsupported DDS format {:#x}", filename, pf_fourcc);
+	}
+	else if ((pf_flags & DDPF_RGB) && file.read<uint32_t>(88, filename) == 32)
+	{
+		// 32-bit RGBA or BGRA, X8 variants are sampled with an opaque alpha
+		auto red_mask = file.read<uint32_t>(92, filename);
+		error_assert(red_mask == 0xff || red_mask == 0xff0000, "Cannot load {}: unsupported DDS channel layout",
+					 filename);
+
+		rgb_format = { 0, static_cast<GLenum>((pf_flags & DDPF_ALPHAPIXELS) ? GL_RGBA8 : GL_RGB8),
+					   static_cast<GLenum>(red_mask == 0xff ? GL_RGBA : GL_BGRA), GL_UNSIGNED_BYTE, 4 };
+		format = &rgb_format;
+	}
+
+	error_assert(format != nullptr, "Cannot load {}: unsupported DDS pixel format", filename);
+	image.format = *format;
+
+	// Levels are stored consecutively, largest first
+	for (uint32_t level = 0; level < levels; ++level)
+	{
+		auto size(level_size(image.format, std::max(image.width >> level, 1), std::max(image.height >> level, 1)));
+		image.levels.push_back({ offset, size });
+		offset += size;
+	}
+
+	return image;
+}
+}
+
+std::unique_ptr<gl::texture> ktx_input::load_file(const std::string &filename, bool vflip)
+{
+	log::shadertoy()->trace("Reading {} for input {}", filename, static_cast<const void *>(this));
+
+	mapped_file file(filename);
+
+	static const unsigned char ktx2_identifier[] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	container_image image;
+	if (file.size() >= sizeof(ktx2_identifier) && memcmp(file.data(), ktx2_identifier, sizeof(ktx2_identifier)) == 0)
+	{
+		image = parse_ktx2(file, filename);
+	}
+	else if (file.size() >= 4 && memcmp(file.data(), "DDS ", 4) == 0)
+	{
+		image = parse_dds(file, filename);
+	}
+	else
+	{
+		error_assert(false, "Cannot load {} for input {}: not a KTX2 or DDS file", filename,
+					 static_cast<const void *>(this));
+	}
+
+	auto levels = static_cast<GLsizei>(image.levels.size());
+
+	// Reject truncated files before allocating the texture
+	for (GLsizei level = 0; level < levels; ++level)
+	{
+		const auto &data(image.levels[level]);
+		auto expected(level_size(image.format, std::max(image.width >> level, 1), std::max(image.height >> level, 1)));
+
+		error_assert(data.size >= expected && data.offset <= file.size() && data.size <= file.size() - data.offset,
+					 "Cannot load {} for input {}: level {} is truncated", filename, static_cast<const void *>(this),
+					 level);
+	}
+
+	// Allocate the complete chain if the mipmaps are generated
+	auto storage_levels =
+	image.generate_mipmaps ? static_cast<GLsizei>(mipmap_levels(image.width, image.height)) : levels;
+
+	auto texture(std::make_unique<gl::texture>(GL_TEXTURE_2D));
+	texture->storage_2d(storage_levels, image.format.internal_format, image.width, image.height);
+
+	// Stored rows are tightly packed
+	GLint alignment;
+	gl_call(glGetIntegerv, GL_UNPACK_ALIGNMENT, &alignment);
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, 1);
+
+	// Upload every level straight from the mapped file
+	for (GLsizei level = 0; level < levels; ++level)
+	{
+		const auto &data(image.levels[level]);
+		GLsizei width = std::max(image.width >> level, 1), height = std::max(image.height >> level, 1);
+		const char *pixels = file.data() + data.offset; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+		if (image.format.format == 0)
+		{
+			texture->compressed_sub_image_2d(level, 0, 0, width, height, image.format.internal_format,
+											 static_cast<GLsizei>(level_size(image.format, width, height)), pixels);
+		}
+		else
+		{
+			texture->sub_image_2d(level, 0, 0, width, height, image.format.format, image.format.type, pixels);
+		}
+	}
+
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, alignment);
+
+	if (image.generate_mipmaps)
+	{
+		texture->generate_mipmap();
+	}
+
+	// Complete with mipmapping samplers even if only some levels are stored
+	texture->parameter(GL_TEXTURE_MAX_LEVEL, storage_levels - 1);
+
+	record_upload(level_size(image.format, image.width, image.height), image.width, image.height,
+				  image.format.internal_format);
+
+	log::shadertoy()->info("Loaded {}x{} ({} levels) texture {} for input {} (GL id {})", image.width, image.height,
+						   storage_levels, filename, static_cast<const void *>(this), GLuint(*texture));
+
+	return texture;
+}
+
+ktx_input::ktx_input() = default;
+
+ktx_input::ktx_input(const std::string &filename) : file_input(filename) {}
+
+bool ktx_input::supported() { return true; }
@@ -0,0 +1,185 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+#include "shadertoy/utils/assert.hpp"
+
+#include "shadertoy/inputs/qoi_input.hpp"
+
+using namespace shadertoy;
+using namespace shadertoy::inputs;
+
+using shadertoy::utils::error_assert;
+using shadertoy::utils::log;
+
+namespace
+{
+/// Size of the QOI header
+constexpr size_t header_size = 14;
+
+/// Size of the end marker, which also pads the last chunk
+constexpr size_t padding_size = 8;
+
+/// Largest supported image, as in the reference decoder
+constexpr uint64_t max_pixels = 400000000;
+
+constexpr uint8_t op_index = 0x00;
+constexpr uint8_t op_diff = 0x40;
+constexpr uint8_t op_luma = 0x80;
+constexpr uint8_t op_rgb = 0xfe;
+constexpr uint8_t op_rgba = 0xff;
+constexpr uint8_t op_mask = 0xc0;
+
+uint32_t read_be32(const uint8_t *bytes)
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+	return (uint32_t(bytes[0]) << 24) | (uint32_t(bytes[1]) << 16) | (uint32_t(bytes[2]) << 8) | uint32_t(bytes[3]);
+}
+
+/**
+ * @brief Decode the chunks of a QOI image
+ *
+ * @tparam Channels Number of channels of the decoded pixels, so storing a
+ *                  pixel is a fixed-size copy
+ */
+template <unsigned int Channels>
+void decode_chunks(const std::vector<uint8_t> &data, decoded_image &image, bool vflip)
+{
+	uint32_t width = image.width, height = image.height;
+	size_t stride = size_t(width) * Channels;
+
+	std::array<std::array<uint8_t, 4>, 64> index{};
+	std::array<uint8_t, 4> px{ { 0, 0, 0, 255 } };
+
+	const uint8_t *in = data.data();
+	size_t p = header_size, chunks_end = data.size() - padding_size;
+	unsigned int run = 0;
+
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		// Write rows in their final order, so the buffer can be uploaded as is
+		auto out = reinterpret_cast<uint8_t *>(&image.pixels[(vflip ? height - 1 - y : y) * stride]);
+		auto row_end = out + stride; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+		for (; out != row_end; out += Channels)
+		{
+			if (run > 0)
+			{
+				run--;
+			}
+			else if (p < chunks_end)
+			{
+				uint8_t b1 = in[p++];
+
+				if (b1 == op_rgb)
+				{
+					px[0] = in[p++];
+					px[1] = in[p++];
+					px[2] = in[p++];
+				}
+				else if (b1 == op_rgba)
+				{
+					px[0] = in[p++];
+					px[1] = in[p++];
+					px[2] = in[p++];
+					px[3] = in[p++];
+				}
+				else if ((b1 & op_mask) == op_index)
+				{
+					px = index[b1];
+				}
+				else if ((b1 & op_mask) == op_diff)
+				{
+					px[0] += ((b1 >> 4) & 0x03) - 2;
+					px[1] += ((b1 >> 2) & 0x03) - 2;
+					px[2] += (b1 & 0x03) - 2;
+				}
+				else if ((b1 & op_mask) == op_luma)
+				{
+					uint8_t b2 = in[p++];
+					int vg = (b1 & 0x3f) - 32;
+					px[0] += vg - 8 + ((b2 >> 4) & 0x0f);
+					px[1] += vg;
+					px[2] += vg - 8 + (b2 & 0x0f);
+				}
+				else
+				{
+					// Run of the previous pixel, with a bias of -1
+					run = b1 & 0x3f;
+				}
+
+				index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64] = px;
+			}
+
+			memcpy(out, px.data(), Channels);
+		}
+	}
+}
+
+decoded_image decode_qoi(const std::string &filename, bool vflip)
+{
+	log::shadertoy()->trace("Reading {}", filename);
+
+	std::ifstream src(filename, std::ios::binary | std::ios::ate);
+	error_assert(src.is_open(), "Cannot load {}: failed to open file for reading", filename);
+
+	// Read the file at once, reading it through stream iterators is slower than decoding it
+	std::vector<uint8_t> data(static_cast<size_t>(src.tellg()));
+	src.seekg(0);
+	src.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+	error_assert(!src.fail(), "Cannot load {}: failed to read file", filename);
+
+	error_assert(data.size() >= header_size + padding_size && memcmp(data.data(), "qoif", 4) == 0,
+				 "Cannot load {}: not a QOI file", filename);
+
+	uint32_t width = read_be32(&data[4]), height = read_be32(&data[8]);
+	unsigned int channels = data[12];
+
+	error_assert(width > 0 && height > 0 && uint64_t(width) * height <= max_pixels,
+				 "Cannot load {}: invalid image size {}x{}", filename, width, height);
+	error_assert(channels == 3 || channels == 4, "Cannot load {}: invalid channel count {}", filename, channels);
+
+	decoded_image image;
+	image.width = width;
+	image.height = height;
+	image.internal_format = channels == 4 ? GL_RGBA8 : GL_RGB8;
+	image.format = channels == 4 ? GL_RGBA : GL_RGB;
+	image.type = GL_UNSIGNED_BYTE;
+	image.pixels.resize(size_t(width) * channels * height);
+
+	if (channels == 4)
+	{
+		decode_chunks<4>(data, image, vflip);
+	}
+	else
+	{
+		decode_chunks<3>(data, image, vflip);
+	}
+
+	return image;
+}
+}
+
+std::unique_ptr<gl::texture> qoi_input::load_file(const std::string &filename, bool vflip)
+{
+	auto image(decode_qoi(filename, vflip));
+	auto texture(upload_image(image));
+
+	log::shadertoy()->info("Loaded {}x{} QOI {} for input {} (GL id {})", image.width, image.height, filename,
+						   static_cast<const void *>(this), GLuint(*texture));
+
+	return texture;
+}
+
+file_input::decoder_type qoi_input::decoder() const { return &decode_qoi; }
+
+qoi_input::qoi_input() = default;
+
+qoi_input::qoi_input(const std::string &filename) : file_input(filename) {}
+
+bool qoi_input::supported() { return true; }
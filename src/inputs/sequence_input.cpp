@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <regex>
+#include <utility>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+#include "shadertoy/utils/assert.hpp"
+#include "shadertoy/utils/thread_pool.hpp"
+
+#include "shadertoy/inputs/exr_input.hpp"
+#include "shadertoy/inputs/hdr_input.hpp"
+#include "shadertoy/inputs/jpeg_input.hpp"
+#include "shadertoy/inputs/qoi_input.hpp"
+#include "shadertoy/inputs/sequence_input.hpp"
+#include "shadertoy/inputs/soil_input.hpp"
+
+#if __cpp_lib_filesystem >= 201703
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem::v1;
+#endif
+
+using namespace shadertoy;
+using namespace shadertoy::inputs;
+
+using shadertoy::gl::gl_call;
+using shadertoy::utils::error_assert;
+using shadertoy::utils::log;
+
+namespace
+{
+/// Create an input able to decode files with the given extension, or null if none is available
+std::unique_ptr<file_input> frame_input(std::string ext)
+{
+	std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+	if ((ext == ".jpg" || ext == ".jpeg") && jpeg_input::supported())
+		return std::make_unique<jpeg_input>();
+	if (ext == ".exr" && exr_input::supported())
+		return std::make_unique<exr_input>();
+	if (ext == ".qoi" && qoi_input::supported())
+		return std::make_unique<qoi_input>();
+	if (ext == ".hdr" && hdr_input::supported())
+		return std::make_unique<hdr_input>();
+	if ((ext == ".bmp" || ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".psd" ||
+		 ext == ".hdr") &&
+		soil_input::supported())
+		return std::make_unique<soil_input>();
+
+	return {};
+}
+}
+
+std::vector<sequence_input::frame_file> sequence_input::list_frames() const
+{
+	std::vector<std::string> filenames;
+
+	if (fs::is_directory(pattern_))
+	{
+		for (const auto &entry : fs::directory_iterator(pattern_))
+		{
+			if (fs::is_regular_file(entry.status()))
+			{
+				filenames.push_back(entry.path().string());
+			}
+		}
+
+		std::sort(filenames.begin(), filenames.end());
+	}
+	else
+	{
+		// Only accept a single integer conversion, the pattern may come from an input URI
+		static const std::regex frame_pattern("[^%]*%0?[0-9]*d[^%]*");
+		error_assert(std::regex_match(pattern_, frame_pattern),
+					 "{}: expected a directory or a pattern with a single %d conversion for input {}", pattern_,
+					 static_cast<const void *>(this));
+
+		std::vector<char> buffer(pattern_.size() + 32);
+		auto format = [&](int index) {
+			snprintf(buffer.data(), buffer.size(), pattern_.c_str(), index);
+			return std::string(buffer.data());
+		};
+
+		// Sequences are numbered from 0 or 1
+		int index = fs::exists(format(0)) ? 0 : 1;
+		for (auto filename(format(index)); fs::exists(filename); filename = format(++index))
+		{
+			filenames.push_back(filename);
+		}
+	}
+
+	// Decoders are shared by frames of the same type
+	std::map<std::string, std::function<decoded_image(const std::string &, bool)>> decoders;
+	std::vector<frame_file> frames;
+
+	for (auto &filename : filenames)
+	{
+		auto ext(fs::path(filename).extension().string());
+		auto it = decoders.find(ext);
+
+		if (it == decoders.end())
+		{
+			auto input(frame_input(ext));
+			it = decoders.emplace(ext, input ? input->decoder() : nullptr).first;
+		}
+
+		if (it->second)
+		{
+			frames.push_back({ std::move(filename), it->second });
+		}
+	}
+
+	return frames;
+}
+
+size_t sequence_input::next_frame(size_t index) const
+{
+	if (++index < frames_.size() || !loop_)
+	{
+		return index;
+	}
+
+	return 0;
+}
+
+void sequence_input::fill_ring(size_t first)
+{
+	size_t index = ring_.empty() ? first : next_frame(ring_.back().index);
+
+	// Frames past the end are not queued, and a short looping sequence is not queued twice
+	while (ring_.size() < std::min(ring_size_, frames_.size()) && index < frames_.size())
+	{
+		const auto &frame(frames_[index]);
+		ring_.push_back({ index, decode_pool_->submit([decode = frame.decode, filename = frame.filename,
+													   vflip = vflip_]() { return decode(filename, vflip); }) });
+
+		index = next_frame(index);
+	}
+}
+
+void sequence_input::upload_frame(const decoded_image &image)
+{
+	GLint width = 0, height = 0, internal_format = 0;
+	if (texture_)
+	{
+		texture_->get_parameter(0, GL_TEXTURE_WIDTH, &width);
+		texture_->get_parameter(0, GL_TEXTURE_HEIGHT, &height);
+		texture_->get_parameter(0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format);
+	}
+
+	// Frames are usually the same size, only allocate the texture once
+	if (width != image.width || height != image.height || internal_format != image.internal_format)
+	{
+		texture_ = std::make_unique<gl::texture>(GL_TEXTURE_2D);
+		texture_->image_2d(GL_TEXTURE_2D, 0, image.internal_format, image.width, image.height, 0, image.format,
+						   image.type, nullptr);
+
+		texture_->parameter(GL_TEXTURE_SWIZZLE_R, image.swizzle[0]);
+		texture_->parameter(GL_TEXTURE_SWIZZLE_G, image.swizzle[1]);
+		texture_->parameter(GL_TEXTURE_SWIZZLE_B, image.swizzle[2]);
+		texture_->parameter(GL_TEXTURE_SWIZZLE_A, image.swizzle[3]);
+
+		log::shadertoy()->debug("Allocated {}x{} texture for sequence input {} (GL id {})", image.width,
+								image.height, static_cast<const void *>(this), GLuint(*texture_));
+	}
+
+	if (!staging_)
+	{
+		staging_ = std::make_unique<gl::buffer>();
+	}
+
+	// Respecifying the buffer orphans the storage of the previous frame, so
+	// the copy does not wait for the previous upload to complete
+	staging_->data(static_cast<GLsizei>(image.pixels.size()), image.pixels.data(), GL_STREAM_DRAW);
+	staging_->bind(GL_PIXEL_UNPACK_BUFFER);
+
+	// Decoded rows are tightly packed
+	GLint alignment;
+	gl_call(glGetIntegerv, GL_UNPACK_ALIGNMENT, &alignment);
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, 1);
+
+	texture_->sub_image_2d(0, 0, 0, image.width, image.height, image.format, image.type, nullptr);
+
+	gl_call(glPixelStorei, GL_UNPACK_ALIGNMENT, alignment);
+	staging_->unbind(GL_PIXEL_UNPACK_BUFFER);
+
+	if (min_filter() > GL_LINEAR)
+	{
+		texture_->generate_mipmap();
+	}
+}
+
+void sequence_input::load_input()
+{
+	if (pattern_.empty())
+	{
+		return;
+	}
+
+	frames_ = list_frames();
+	error_assert(!frames_.empty(), "{}: no frames found for input {}", pattern_, static_cast<const void *>(this));
+
+	if (!decode_pool_)
+	{
+		decode_pool_ = std::make_shared<utils::thread_pool>(static_cast<unsigned int>(ring_size_));
+	}
+
+	log::shadertoy()->info("Loaded sequence {} ({} frames) for input {}", pattern_, frames_.size(),
+						   static_cast<const void *>(this));
+
+	fill_ring(frame());
+}
+
+void sequence_input::reset_input()
+{
+	// Frames being decoded are dropped when they complete
+	ring_.clear();
+	frames_.clear();
+	texture_.reset();
+	staging_.reset();
+	current_frame_ = 0;
+}
+
+gl::texture *sequence_input::use_input()
+{
+	if (frames_.empty())
+	{
+		return nullptr;
+	}
+
+	size_t target = frame();
+	if (texture_ && target == current_frame_)
+	{
+		return texture_.get();
+	}
+
+	// Drop skipped frames, or all frames if seeking outside of the ring
+	auto it = std::find_if(ring_.begin(), ring_.end(), [target](const auto &slot) { return slot.index == target; });
+	ring_.erase(ring_.begin(), it);
+	fill_ring(target);
+
+	auto &slot(ring_.front());
+
+	// Keep the previous frame rather than waiting, except for the first one
+	if (texture_ && slot.image.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		dropped_frames_++;
+		return texture_.get();
+	}
+
+	try
+	{
+		upload_frame(slot.image.get());
+	}
+	catch (const std::exception &ex)
+	{
+		// Do not interrupt playback, keep the previous frame
+		log::shadertoy()->error("Cannot load {} for input {}: {}", frames_[slot.index].filename,
+								static_cast<const void *>(this), ex.what());
+	}
+
+	current_frame_ = target;
+	ring_.pop_front();
+	fill_ring(next_frame(target));
+
+	return texture_.get();
+}
+
+void sequence_input::ring_size(size_t new_ring_size) { ring_size_ = std::max<size_t>(1, new_ring_size); }
+
+void sequence_input::time(double new_time)
+{
+	time_ = new_time;
+	use_time_ = true;
+}
+
+size_t sequence_input::frame() const
+{
+	size_t index = frame_;
+
+	if (use_time_)
+	{
+		index = static_cast<size_t>(std::max(0.0, std::floor(time_ * frame_rate_)));
+	}
+
+	if (frames_.empty())
+	{
+		return index;
+	}
+
+	return loop_ ? index % frames_.size() : std::min(index, frames_.size() - 1);
+}
+
+void sequence_input::frame(size_t new_frame)
+{
+	frame_ = new_frame;
+	use_time_ = false;
+}
+
+sequence_input::sequence_input() : sequence_input(std::string()) {}
+
+sequence_input::sequence_input(std::string pattern, double frame_rate)
+: pattern_(std::move(pattern)), vflip_(true), frame_rate_(frame_rate), loop_(true), ring_size_(4), time_(0.0),
+  frame_(0), use_time_(true), current_frame_(0), dropped_frames_(0)
+{
+}
@@ -0,0 +1,19 @@
+#include <memory>
+#include <utility>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+
+#include "shadertoy/inputs/shared_input.hpp"
+
+using namespace shadertoy;
+using namespace shadertoy::inputs;
+
+void shared_input::load_input() { source_->load(); }
+
+void shared_input::reset_input() {}
+
+gl::texture *shared_input::use_input() { return source_->use(); }
+
+shared_input::shared_input(std::shared_ptr<basic_input> source) : source_(std::move(source)) {}
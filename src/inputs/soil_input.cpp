@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include <epoxy/gl.h>
 
 #if LIBSHADERTOY_SOIL
@@ -15,36 +17,71 @@ using namespace shadertoy::inputs;
 using shadertoy::utils::log;
 using shadertoy::utils::error_assert;
 
-std::unique_ptr<gl::texture> soil_input::load_file(const std::string &filename, bool vflip)
+namespace
 {
-	// Create a texture object
-	std::unique_ptr<gl::texture> texture;
-	
 #if LIBSHADERTOY_SOIL
-	log::shadertoy()->trace("Reading {} for input {}", filename, static_cast<const void *>(this));
+decoded_image decode_soil(const std::string &filename, bool vflip)
+{
+	log::shadertoy()->trace("Reading {}", filename);
 
-	texture = std::make_unique<gl::texture>(GL_TEXTURE_2D);
+	int width, height, channels;
+	unsigned char *data = SOIL_load_image(filename.c_str(), &width, &height, &channels, SOIL_LOAD_AUTO);
+	error_assert(data != nullptr, "Cannot load {}: {}", filename, SOIL_last_result());
 
-	// Load image into texture object using SOIL
-	GLuint texid = SOIL_load_OGL_texture(filename.c_str(), SOIL_LOAD_AUTO, GLuint(*texture),
-										 vflip ? SOIL_FLAG_INVERT_Y : 0);
+	decoded_image image;
+	image.width = width;
+	image.height = height;
+	image.type = GL_UNSIGNED_BYTE;
 
-	if (texid == 0)
+	switch (channels)
 	{
-		// If loading failed, delete the texture object
-		texture = {};
-		error_assert(false, "Cannot load {} for input {}: {}", filename, static_cast<const void *>(this),
-					 SOIL_last_result());
+	case SOIL_LOAD_L:
+		image.internal_format = GL_R8;
+		image.format = GL_RED;
+		image.swizzle = { GL_RED, GL_RED, GL_RED, GL_ONE };
+		break;
+	case SOIL_LOAD_LA:
+		image.internal_format = GL_RG8;
+		image.format = GL_RG;
+		image.swizzle = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+		break;
+	case SOIL_LOAD_RGB:
+		image.internal_format = GL_RGB8;
+		image.format = GL_RGB;
+		break;
+	default:
+		image.internal_format = GL_RGBA8;
+		image.format = GL_RGBA;
+		break;
 	}
-	else
-	{
-		GLint width, height;
-		texture->get_parameter(0, GL_TEXTURE_WIDTH, &width);
-		texture->get_parameter(0, GL_TEXTURE_HEIGHT, &height);
 
-		log::shadertoy()->info("Loaded {}x{} SOIL {} for input {} (GL id {})", width, height,
-							   filename, static_cast<const void *>(this), GLuint(*texture));
+	// SOIL returns the rows top to bottom, flip them manually if requested
+	size_t stride = static_cast<size_t>(width) * channels;
+	image.pixels.resize(stride * height);
+
+	for (int y = 0; y < height; ++y)
+	{
+		int src_row = vflip ? height - 1 - y : y;
+		memcpy(std::addressof(image.pixels[y * stride]), data + src_row * stride, stride); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 	}
+
+	SOIL_free_image_data(data);
+
+	return image;
+}
+#endif /* LIBSHADERTOY_SOIL */
+}
+
+std::unique_ptr<gl::texture> soil_input::load_file(const std::string &filename, bool vflip)
+{
+	std::unique_ptr<gl::texture> texture;
+
+#if LIBSHADERTOY_SOIL
+	auto image(decode_soil(filename, vflip));
+	texture = upload_image(image);
+
+	log::shadertoy()->info("Loaded {}x{} SOIL {} for input {} (GL id {})", image.width, image.height, filename,
+						   static_cast<const void *>(this), GLuint(*texture));
 #else
 	error_assert(false, "Cannot load {} for input {}: SOIL support is disabled", filename,
 				 static_cast<const void *>(this));
@@ -53,6 +90,15 @@ std::unique_ptr<gl::texture> soil_input::load_file(const std::string &filename,
 	return texture;
 }
 
+file_input::decoder_type soil_input::decoder() const
+{
+#if LIBSHADERTOY_SOIL
+	return &decode_soil;
+#else
+	return nullptr;
+#endif
+}
+
 soil_input::soil_input() = default;
 
 soil_input::soil_input(const std::string &filename) : file_input(filename) {}
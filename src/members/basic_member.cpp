@@ -1,7 +1,11 @@
 #include <epoxy/gl.h>
 
+#include "shadertoy/gl.hpp"
+
 #include "shadertoy/members/basic_member.hpp"
 
+#include "shadertoy/utils/log.hpp"
+
 using namespace shadertoy;
 using namespace shadertoy::members;
 
@@ -15,9 +19,34 @@ void basic_member::init(const swap_chain &chain, const render_context &context)
 	init_member(chain, context);
 }
 
+void basic_member::prepare(const swap_chain &chain, const render_context &context)
+{
+	prepare_member(chain, context);
+}
+
 void basic_member::allocate(const swap_chain &chain, const render_context &context)
 {
 	allocate_member(chain, context);
 }
 
+std::chrono::nanoseconds basic_member::warm_up(const swap_chain &chain, const render_context &context)
+{
+	auto start(std::chrono::steady_clock::now());
+
+	warm_up_member(chain, context);
+
+	return std::chrono::steady_clock::now() - start;
+}
+
+void basic_member::prepare_member(const swap_chain &chain, const render_context &context) {}
+
+void basic_member::warm_up_member(const swap_chain &chain, const render_context &context) {}
+
 int basic_member::find_output(const output_name_t &name) const { return -1; }
+
+std::shared_ptr<basic_member> basic_member::clone() const
+{
+	throw shadertoy_error(fmt::format("Member {} cannot be cloned", static_cast<const void *>(this)));
+}
+
+void basic_member::remap_members(const member_map_t &clones) {}
@@ -26,6 +26,11 @@ void buffer_member::render_member(const swap_chain &chain, const render_context
 	io_.swap();
 }
 
+void buffer_member::prepare_member(const swap_chain &chain, const render_context &context)
+{
+	buffer_->prepare(context, io_);
+}
+
 void buffer_member::init_member(const swap_chain &chain, const render_context &context)
 {
 	buffer_->init(context, io_);
@@ -49,12 +54,12 @@ void buffer_member::init_member(const swap_chain &chain, const render_context &c
 
 			if (output_allocator_)
 			{
-				auto props(output_allocator_(*it_output, render_size_));
+				auto props(output_allocator_(*it_output, render_size_ref_));
 				*it_spec = output_buffer_spec(std::move(std::get<0>(props)), name, std::get<1>(props));
 			}
 			else
 			{
-				*it_spec = output_buffer_spec(make_ref(*render_size_), name, internal_format_);
+				*it_spec = output_buffer_spec(make_shared_ref(render_size_), name, internal_format_);
 			}
 		}
 	}
@@ -73,10 +78,35 @@ void buffer_member::allocate_member(const swap_chain &chain, const render_contex
 	buffer_->allocate_textures(context, io_);
 }
 
+void buffer_member::warm_up_member(const swap_chain &chain, const render_context &context)
+{
+	// Render to single-pixel textures with the same formats, so the outputs
+	// of this member are left untouched
+	io_resource scratch(member_swap_policy::single_buffer);
+
+	for (const auto &spec : io_.output_specs())
+	{
+		scratch.output_specs().emplace_back(make_size(rsize(1, 1)), spec.name, spec.internal_format);
+	}
+
+	if (scratch.output_specs().empty())
+	{
+		return;
+	}
+
+	scratch.allocate();
+	buffer_->allocate_textures(context, scratch);
+
+	buffer_->render(context, scratch, *this);
+
+	// Restore the depth buffer and render targets of the actual outputs
+	buffer_->allocate_textures(context, io_);
+}
+
 buffer_member::buffer_member(std::shared_ptr<buffers::basic_buffer> buffer, rsize_ref render_size,
 							 GLint internal_format, member_swap_policy swap_policy)
 : buffer_(std::move(std::move(buffer))), io_(swap_policy), render_size_(std::move(render_size)),
-  internal_format_(internal_format)
+  render_size_ref_(make_shared_ref(render_size_)), internal_format_(internal_format)
 {
 }
 
@@ -105,6 +135,20 @@ int buffer_member::find_output(const output_name_t &name) const
 	return it - io_.output_specs().begin();
 }
 
+std::shared_ptr<basic_member> buffer_member::clone() const
+{
+	auto result(std::make_shared<buffer_member>(buffer_->clone(), make_shared_ref(render_size_), internal_format_,
+												io_.swap_policy()));
+	result->state_ = state_;
+	result->output_allocator_ = output_allocator_;
+	return result;
+}
+
+void buffer_member::remap_members(const member_map_t &clones)
+{
+	buffer_->remap_members(clones);
+}
+
 std::shared_ptr<buffer_member> members::make_member(const swap_chain &chain, std::shared_ptr<buffers::basic_buffer> buffer, rsize_ref &&render_size)
 {
 	return make_buffer(buffer, std::forward<rsize_ref&&>(render_size), chain.internal_format(), chain.swap_policy());
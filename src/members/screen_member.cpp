@@ -19,7 +19,7 @@ using shadertoy::gl::gl_call;
 using shadertoy::utils::error_assert;
 using shadertoy::utils::log;
 
-void screen_member::render_member(const swap_chain &chain, const render_context &context)
+gl::texture *screen_member::find_texture(const swap_chain &chain)
 {
 	gl::texture *texptr = nullptr;
 	auto outputs(output(chain));
@@ -68,10 +68,34 @@ void screen_member::render_member(const swap_chain &chain, const render_context
 		texptr = std::get<1>(outputs.front());
 	}
 
+	return texptr;
+}
+
+void screen_member::render_member(const swap_chain &chain, const render_context &context)
+{
+	gl::texture *texptr = find_texture(chain);
+
 	rsize vp_size(viewport_size_->resolve());
 	gl_call(glBindFramebuffer, GL_DRAW_FRAMEBUFFER, 0);
 	gl_call(glViewport, viewport_x_, viewport_y_, vp_size.width, vp_size.height);
 
+	// Check if the output can be copied without invoking the screen program
+	const blit_info *blit = allow_blit_ ? blit_filter(*texptr, vp_size) : nullptr;
+
+	// Apply member state
+	state_.apply();
+
+	// Clear buffers as requested
+	state_.clear();
+
+	if (blit)
+	{
+		// Blit the output texture to the viewport
+		blit->read_fbo->blit(0, 0, 0, blit->width, blit->height, viewport_x_, viewport_y_, viewport_x_ + vp_size.width,
+					   viewport_y_ + vp_size.height, GL_COLOR_BUFFER_BIT, *blit->filter);
+		return;
+	}
+
 	// Use the screen program
 	context.screen_prog().use();
 
@@ -79,21 +103,119 @@ void screen_member::render_member(const swap_chain &chain, const render_context
 	texptr->bind_unit(0);
 	sampler_.bind(0);
 
-	// Apply member state
-	state_.apply();
+	context.screen_quad().render();
+}
 
-	// Clear buffers as requested
+void screen_member::warm_up_member(const swap_chain &chain, const render_context &context)
+{
+	gl::texture *texptr = find_texture(chain);
+	if (!texptr)
+	{
+		return;
+	}
+
+	// Blits do not use any program
+	if (allow_blit_ && blit_filter(*texptr, viewport_size_->resolve()))
+	{
+		return;
+	}
+
+	// Single-pixel scratch target
+	gl::texture target(GL_TEXTURE_2D);
+	target.image_2d(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+
+	gl::framebuffer fbo;
+	fbo.texture(GL_COLOR_ATTACHMENT0, target, 0);
+
+	auto fbo_bind(gl::get_bind_guard(fbo, GL_DRAW_FRAMEBUFFER));
+	gl_call(glViewport, 0, 0, 1, 1);
+
+	state_.apply();
 	state_.clear();
 
+	context.screen_prog().use();
+
+	texptr->bind_unit(0);
+	sampler_.bind(0);
+
 	context.screen_quad().render();
 }
 
+const screen_member::blit_info *screen_member::blit_filter(const gl::texture &texture, const rsize &vp_size)
+{
+	// Blits bypass the fragment pipeline, so any state that would alter the
+	// result of drawing the screen quad requires the shader path
+	for (auto cap : { GL_BLEND, GL_COLOR_LOGIC_OP, GL_CULL_FACE, GL_DEPTH_TEST, GL_STENCIL_TEST,
+					  GL_FRAMEBUFFER_SRGB, GL_RASTERIZER_DISCARD, GL_SAMPLE_ALPHA_TO_COVERAGE,
+					  GL_SAMPLE_ALPHA_TO_ONE, GL_SAMPLE_COVERAGE, GL_SAMPLE_MASK })
+	{
+		if (state_.enabled(cap))
+			return nullptr;
+	}
+
+	if (state_.polygon_mode() != GL_FILL)
+		return nullptr;
+
+	// The draw state is checked every frame, but the OpenGL queries below
+	// only depend on the texture and the viewport
+	auto it = blit_info_.find(GLuint(texture));
+	if (it != blit_info_.end() && it->second.texture == &texture && it->second.vp_size == vp_size)
+	{
+		return it->second.filter ? &it->second : nullptr;
+	}
+
+	blit_info info{ &texture, vp_size, 0, 0, std::nullopt, nullptr };
+	texture.get_parameter(0, GL_TEXTURE_WIDTH, &info.width);
+	texture.get_parameter(0, GL_TEXTURE_HEIGHT, &info.height);
+
+	// Integer textures cannot be blitted to the normalized default framebuffer
+	GLint component_type;
+	texture.get_parameter(0, GL_TEXTURE_RED_TYPE, &component_type);
+
+	// Blitting to a multisampled framebuffer is not allowed
+	GLint sample_buffers;
+	gl_call(glGetNamedFramebufferParameteriv, 0, GL_SAMPLE_BUFFERS, &sample_buffers);
+
+	if (component_type != GL_INT && component_type != GL_UNSIGNED_INT && sample_buffers == 0)
+	{
+		if (static_cast<unsigned int>(info.width) == vp_size.width &&
+			static_cast<unsigned int>(info.height) == vp_size.height)
+		{
+			// Same size: exact copy
+			info.filter = GL_NEAREST;
+		}
+		else
+		{
+			// Scaled copy: the sampler filters must be expressible as a blit filter
+			GLint min_filter, mag_filter;
+			sampler_.get_parameter(GL_TEXTURE_MIN_FILTER, &min_filter);
+			sampler_.get_parameter(GL_TEXTURE_MAG_FILTER, &mag_filter);
+
+			if (min_filter == mag_filter && (min_filter == GL_NEAREST || min_filter == GL_LINEAR))
+				info.filter = static_cast<GLenum>(min_filter);
+		}
+	}
+
+	// Attach the texture once, not on every blit
+	if (info.filter)
+	{
+		info.read_fbo = std::make_unique<gl::framebuffer>();
+		info.read_fbo->texture(GL_COLOR_ATTACHMENT0, texture, 0);
+	}
+
+	auto &entry(blit_info_[GLuint(texture)]);
+	entry = std::move(info);
+	return entry.filter ? &entry : nullptr;
+}
+
 void screen_member::init_member(const swap_chain &chain, const render_context &context)
 {
 }
 
 void screen_member::allocate_member(const swap_chain &chain, const render_context &context)
 {
+	// Textures may have been reallocated
+	blit_info_.clear();
 }
 
 std::vector<member_output_t> screen_member::output(const swap_chain &chain)
@@ -120,7 +242,8 @@ std::vector<member_output_t> screen_member::output(const swap_chain &chain)
 
 screen_member::screen_member(rsize_ref &&viewport_size, std::optional<output_name_t> output_name)
 : output_name_(output_name), output_index_(-1), viewport_x_(0), viewport_y_(0),
-  viewport_size_(std::move(viewport_size))
+  viewport_size_(std::move(viewport_size)),
+  viewport_size_ref_(make_shared_ref(viewport_size_)), allow_blit_(true)
 {
 	sampler_.parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	sampler_.parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -131,7 +254,8 @@ screen_member::screen_member(rsize_ref &&viewport_size, std::optional<output_nam
 screen_member::screen_member(int viewport_x, int viewport_y, rsize_ref &&viewport_size,
 							 std::optional<output_name_t> output_name)
 : output_name_(output_name), output_index_(-1), viewport_x_(viewport_x), viewport_y_(viewport_y),
-  viewport_size_(std::move(viewport_size))
+  viewport_size_(std::move(viewport_size)),
+  viewport_size_ref_(make_shared_ref(viewport_size_)), allow_blit_(true)
 {
 	sampler_.parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	sampler_.parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -143,7 +267,8 @@ screen_member::screen_member(rsize_ref &&viewport_size, std::weak_ptr<members::b
 							 std::optional<output_name_t> output_name)
 : member_(std::move(std::move(member))), output_name_(output_name), output_index_(-1),
 
-  viewport_x_(0), viewport_y_(0), viewport_size_(std::move(viewport_size))
+  viewport_x_(0), viewport_y_(0), viewport_size_(std::move(viewport_size)),
+  viewport_size_ref_(make_shared_ref(viewport_size_)), allow_blit_(true)
 {
 	sampler_.parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	sampler_.parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -155,7 +280,8 @@ screen_member::screen_member(int viewport_x, int viewport_y, rsize_ref &&viewpor
 							 std::weak_ptr<members::basic_member> member, std::optional<output_name_t> output_name)
 : member_(std::move(std::move(member))), output_name_(output_name), output_index_(-1),
 
-  viewport_x_(viewport_x), viewport_y_(viewport_y), viewport_size_(std::move(viewport_size))
+  viewport_x_(viewport_x), viewport_y_(viewport_y), viewport_size_(std::move(viewport_size)),
+  viewport_size_ref_(make_shared_ref(viewport_size_)), allow_blit_(true)
 {
 	sampler_.parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	sampler_.parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -172,3 +298,33 @@ std::vector<member_output_t> screen_member::output()
 
 	return {};
 }
+
+std::shared_ptr<basic_member> screen_member::clone() const
+{
+	auto result(std::make_shared<screen_member>(viewport_x_, viewport_y_, make_shared_ref(viewport_size_), member_,
+												output_name_));
+	result->state_ = state_;
+	result->allow_blit_ = allow_blit_;
+
+	for (GLenum pname :
+		 { GL_TEXTURE_MIN_FILTER, GL_TEXTURE_MAG_FILTER, GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R })
+	{
+		GLint value;
+		sampler_.get_parameter(pname, &value);
+		result->sampler_.parameter(pname, value);
+	}
+
+	return result;
+}
+
+void screen_member::remap_members(const member_map_t &clones)
+{
+	if (auto member = member_.lock())
+	{
+		auto it = clones.find(member.get());
+		if (it != clones.end())
+		{
+			member_ = it->second;
+		}
+	}
+}
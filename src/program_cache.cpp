@@ -0,0 +1,650 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <random>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+#include "shadertoy/utils/log.hpp"
+
+#include "shadertoy/program_cache.hpp"
+#include "shadertoy/spirv_compiler.hpp"
+
+#include "utils/fnv1a.hpp"
+
+#if __cpp_lib_filesystem >= 201703
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem::v1;
+#endif
+
+using namespace shadertoy;
+using shadertoy::gl::gl_call;
+using shadertoy::utils::fnv1a;
+using shadertoy::utils::log;
+
+namespace
+{
+
+/// Magic bytes at the start of every cache entry
+constexpr const char entry_magic[4] = { 'S', 'T', 'P', 'C' };
+
+/// Version of the cache entry format
+constexpr const uint32_t entry_version = 2;
+
+/// Size of the fixed cache entry header: magic, version, key hash, key material size, binary format,
+/// payload size, checksum. It is followed by the key material, then the payload.
+constexpr const size_t header_size = 4 + 4 + 8 + 4 + 4 + 4 + 8;
+
+/// Extension of cache entry files
+constexpr const char entry_extension[] = ".bin";
+
+/// Extension of SPIR-V module files
+constexpr const char module_extension[] = ".spv";
+
+/// Version of the SPIR-V module cache keys
+constexpr const uint32_t module_version = 2;
+
+/// Magic number at the start of SPIR-V modules
+constexpr const uint32_t spirv_magic = 0x07230203;
+
+template<typename T>
+void write_value(std::vector<char> &buffer, T value)
+{
+	auto bytes = reinterpret_cast<const char *>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void write_string(std::vector<char> &buffer, const std::string &value)
+{
+	write_value(buffer, static_cast<uint32_t>(value.size()));
+	buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+template<typename T>
+void write_interface(std::vector<char> &buffer, const resource_interface<T> &interface)
+{
+	write_value(buffer, static_cast<uint32_t>(interface.resources().size()));
+
+	for (const auto &resource : interface.resources())
+	{
+		write_value(buffer, static_cast<uint32_t>(resource.resource_index));
+		write_value(buffer, static_cast<int32_t>(resource.location));
+		write_value(buffer, static_cast<int32_t>(resource.type));
+		write_value(buffer, static_cast<int32_t>(resource.array_size));
+		write_string(buffer, resource.name);
+	}
+}
+
+/**
+ * @brief Write chunks of data to a temporary file and rename it to \p path,
+ * so concurrent readers never see a partially written entry
+ *
+ * @return true if the file was written, false otherwise
+ */
+bool write_entry(const std::string &path, std::initializer_list<std::pair<const char *, size_t>> chunks)
+{
+	// Unique name, so processes sharing the cache directory do not write the same file
+	std::random_device rd;
+	auto tmp_path(fmt::format("{}.{:08x}{:08x}.tmp", path, rd(), rd()));
+
+	{
+		std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+		for (const auto &chunk : chunks)
+		{
+			ofs.write(chunk.first, chunk.second);
+		}
+
+		if (!ofs)
+		{
+			log::shadertoy()->warn("Failed to write program cache entry {}", tmp_path);
+
+			ofs.close();
+			std::error_code ec;
+			fs::remove(tmp_path, ec);
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	fs::rename(tmp_path, path, ec);
+
+	if (ec)
+	{
+		log::shadertoy()->warn("Failed to write program cache entry {}: {}", path, ec.message());
+		fs::remove(tmp_path, ec);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Bounds-checked reader over a cache entry payload
+ */
+class entry_reader
+{
+	const char *current_;
+	const char *end_;
+
+public:
+	entry_reader(const char *begin, const char *end) : current_(begin), end_(end) {}
+
+	template<typename T>
+	bool read(T &value)
+	{
+		if (static_cast<size_t>(end_ - current_) < sizeof(T))
+			return false;
+
+		std::memcpy(&value, current_, sizeof(T));
+		current_ += sizeof(T);
+		return true;
+	}
+
+	bool read(std::string &value)
+	{
+		uint32_t size;
+		if (!read(size) || static_cast<size_t>(end_ - current_) < size)
+			return false;
+
+		value.assign(current_, size);
+		current_ += size;
+		return true;
+	}
+
+	bool read(const char *&data, size_t size)
+	{
+		if (static_cast<size_t>(end_ - current_) < size)
+			return false;
+
+		data = current_;
+		current_ += size;
+		return true;
+	}
+
+	template<typename T>
+	bool read(std::vector<T> &resources)
+	{
+		uint32_t count;
+		if (!read(count))
+			return false;
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			uint32_t resource_index;
+			int32_t location, type, array_size;
+			std::string name;
+
+			if (!read(resource_index) || !read(location) || !read(type) || !read(array_size) || !read(name))
+				return false;
+
+			resources.emplace_back(resource_index, std::move(name), location, type, array_size);
+		}
+
+		return true;
+	}
+};
+
+/// Status of a cache entry, see check_entry
+enum class entry_status
+{
+	/// The entry matches the key
+	valid,
+	/// The entry is valid, but for another key with the same hash
+	key_mismatch,
+	/// The entry is corrupted or uses an unsupported format
+	invalid,
+};
+
+/// Contents of a valid cache entry
+struct entry_contents
+{
+	/// Binary format of the payload
+	uint32_t binary_format;
+
+	/// Start of the payload
+	const char *payload;
+
+	/// Size of the payload
+	uint32_t payload_size;
+};
+
+/// Build the header of a cache entry, which is followed by the key material and the payload
+std::vector<char> entry_header(const program_cache::entry_key &key, uint32_t binary_format,
+							   const char *payload, size_t payload_size)
+{
+	std::vector<char> header;
+	header.insert(header.end(), std::begin(entry_magic), std::end(entry_magic));
+	write_value(header, entry_version);
+	write_value(header, key.hash);
+	write_value(header, static_cast<uint32_t>(key.material.size()));
+	write_value(header, binary_format);
+	write_value(header, static_cast<uint32_t>(payload_size));
+	write_value(header, fnv1a(payload, payload_size));
+	return header;
+}
+
+/**
+ * @brief Check the header, key material and checksum of a cache entry
+ *
+ * @param buffer   Contents of the entry file
+ * @param key      Expected key of the entry
+ * @param contents Contents of the entry, set if it is valid
+ * @param reason   Reason for discarding the entry, set if it is invalid
+ *
+ * @return Status of the entry
+ */
+entry_status check_entry(const std::vector<char> &buffer, const program_cache::entry_key &key,
+						 entry_contents &contents, const char *&reason)
+{
+	entry_reader header(buffer.data(), buffer.data() + buffer.size());
+
+	const char *magic, *material;
+	uint32_t version, material_size;
+	uint64_t entry_hash, checksum;
+
+	if (!header.read(magic, sizeof(entry_magic)) || !header.read(version) || !header.read(entry_hash) ||
+		!header.read(material_size) || !header.read(contents.binary_format) ||
+		!header.read(contents.payload_size) || !header.read(checksum))
+	{
+		reason = "truncated header";
+		return entry_status::invalid;
+	}
+
+	if (std::memcmp(magic, entry_magic, sizeof(entry_magic)) != 0 || version != entry_version)
+	{
+		reason = "unsupported format";
+		return entry_status::invalid;
+	}
+
+	if (buffer.size() != header_size + static_cast<size_t>(material_size) + contents.payload_size)
+	{
+		reason = "size mismatch";
+		return entry_status::invalid;
+	}
+
+	// The hash only names the file, the full key guards against collisions
+	header.read(material, material_size);
+	if (entry_hash != key.hash || material_size != key.material.size() ||
+		std::memcmp(material, key.material.data(), material_size) != 0)
+	{
+		return entry_status::key_mismatch;
+	}
+
+	contents.payload = buffer.data() + header_size + material_size;
+	if (fnv1a(contents.payload, contents.payload_size) != checksum)
+	{
+		reason = "checksum mismatch";
+		return entry_status::invalid;
+	}
+
+	return entry_status::valid;
+}
+}
+
+std::string program_cache::entry_path(uint64_t key, const char *extension) const
+{
+	return (fs::path(directory_) / fmt::format("{:016x}{}", key, extension)).string();
+}
+
+program_cache::program_cache(const std::string &directory, size_t max_size)
+: directory_(directory), max_size_(max_size)
+{
+	std::error_code ec;
+	fs::create_directories(directory_, ec);
+
+	if (ec)
+	{
+		log::shadertoy()->warn("Failed to create program cache directory {}: {}", directory_, ec.message());
+	}
+}
+
+program_cache::entry_key program_cache::key(const compiler::program_template::sources_map &sources,
+											bool separable) const
+{
+	std::vector<char> material;
+	write_value(material, entry_version);
+	write_value(material, static_cast<uint8_t>(separable ? 1 : 0));
+
+	// Driver identification: binaries are only valid for the exact same driver
+	for (auto name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+	{
+		auto str = reinterpret_cast<const char *>(gl_call(glGetString, name));
+		write_string(material, str ? str : "");
+	}
+
+	GLint num_formats = 0;
+	gl_call(glGetIntegerv, GL_NUM_PROGRAM_BINARY_FORMATS, &num_formats);
+
+	std::vector<GLint> formats(num_formats);
+	if (num_formats > 0)
+	{
+		gl_call(glGetIntegerv, GL_PROGRAM_BINARY_FORMATS, formats.data());
+	}
+
+	write_value(material, static_cast<uint32_t>(formats.size()));
+	for (auto format : formats)
+	{
+		write_value(material, static_cast<int32_t>(format));
+	}
+
+	// Program sources
+	for (const auto &pair : sources)
+	{
+		write_value(material, pair.first);
+		write_value(material, static_cast<uint32_t>(pair.second.size()));
+
+		for (const auto &source : pair.second)
+		{
+			write_string(material, source->second);
+		}
+	}
+
+	entry_key result;
+	result.material.assign(material.begin(), material.end());
+	result.hash = fnv1a(result.material.data(), result.material.size());
+	return result;
+}
+
+program_cache::entry_key program_cache::key(const compiler::program_template &program_template,
+											const compiler::program_template::sources_map &sources) const
+{
+	auto result(key(program_template.link_sources(sources), program_template.separable()));
+
+	if (program_template.spirv())
+	{
+		// Specialization constants are applied when loading SPIR-V modules
+		std::vector<char> material;
+		write_value(material, static_cast<uint8_t>(1));
+		write_value(material, static_cast<uint32_t>(program_template.specialization_constants().size()));
+
+		for (const auto &pair : program_template.specialization_constants())
+		{
+			write_value(material, pair.first);
+			write_value(material, pair.second);
+		}
+
+		result.material.append(material.begin(), material.end());
+		result.hash = fnv1a(result.material.data(), result.material.size());
+	}
+
+	return result;
+}
+
+program_cache::entry_key program_cache::module_key(GLenum type, const std::vector<compiler::source_list> &units,
+												   bool optimize) const
+{
+	std::vector<char> material;
+	write_value(material, module_version);
+	write_value(material, type);
+	write_value(material, static_cast<uint8_t>(optimize ? 1 : 0));
+
+	// Modules depend on the versions of the compiler and the optimizer
+	write_string(material, spirv_compiler::version());
+
+	for (const auto &unit : units)
+	{
+		write_value(material, static_cast<uint32_t>(unit.size()));
+
+		for (const auto &source : unit)
+		{
+			write_string(material, source->second);
+		}
+	}
+
+	entry_key result;
+	result.material.assign(material.begin(), material.end());
+	result.hash = fnv1a(result.material.data(), result.material.size());
+	return result;
+}
+
+std::vector<uint32_t> program_cache::load_module(const entry_key &key) const
+{
+	auto path(entry_path(key.hash, module_extension));
+
+	std::ifstream ifs(path, std::ios::binary);
+	if (!ifs.is_open())
+	{
+		log::shadertoy()->debug("SPIR-V module cache miss for {:016x}", key.hash);
+		return {};
+	}
+
+	std::vector<char> buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	ifs.close();
+
+	auto discard = [&](const char *reason) -> std::vector<uint32_t> {
+		log::shadertoy()->warn("Discarding SPIR-V module cache entry {}: {}", path, reason);
+
+		std::error_code ec;
+		fs::remove(path, ec);
+		return {};
+	};
+
+	entry_contents contents;
+	const char *reason = nullptr;
+
+	switch (check_entry(buffer, key, contents, reason))
+	{
+	case entry_status::key_mismatch:
+		log::shadertoy()->debug("SPIR-V module cache miss for {:016x}: key mismatch", key.hash);
+		return {};
+	case entry_status::invalid:
+		return discard(reason);
+	case entry_status::valid:
+		break;
+	}
+
+	std::vector<uint32_t> module(contents.payload_size / sizeof(uint32_t));
+	std::memcpy(module.data(), contents.payload, module.size() * sizeof(uint32_t));
+
+	if (contents.binary_format != GL_SHADER_BINARY_FORMAT_SPIR_V || contents.payload_size % sizeof(uint32_t) != 0 ||
+		module.empty() || module[0] != spirv_magic)
+		return discard("invalid module");
+
+	// Mark the entry as recently used
+	std::error_code ec;
+	fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+	log::shadertoy()->debug("SPIR-V module cache hit for {:016x}", key.hash);
+
+	return module;
+}
+
+void program_cache::store_module(const entry_key &key, const std::vector<uint32_t> &module) const
+{
+	auto payload = reinterpret_cast<const char *>(module.data());
+	auto size = module.size() * sizeof(uint32_t);
+	auto header(entry_header(key, GL_SHADER_BINARY_FORMAT_SPIR_V, payload, size));
+
+	if (!write_entry(entry_path(key.hash, module_extension),
+					 { { header.data(), header.size() },
+					   { key.material.data(), key.material.size() },
+					   { payload, size } }))
+	{
+		return;
+	}
+
+	log::shadertoy()->debug("Stored SPIR-V module in cache as {:016x} ({} bytes)", key.hash, size);
+
+	evict();
+}
+
+std::unique_ptr<program_interface> program_cache::load(const entry_key &key, gl::program &program,
+													  bool separable) const
+{
+	auto path(entry_path(key.hash, entry_extension));
+
+	std::ifstream ifs(path, std::ios::binary);
+	if (!ifs.is_open())
+	{
+		log::shadertoy()->debug("Program cache miss for {:016x}", key.hash);
+		return {};
+	}
+
+	std::vector<char> buffer((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+	ifs.close();
+
+	auto discard = [&](const char *reason) -> std::unique_ptr<program_interface> {
+		log::shadertoy()->warn("Discarding program cache entry {}: {}", path, reason);
+
+		std::error_code ec;
+		fs::remove(path, ec);
+		return {};
+	};
+
+	entry_contents contents;
+	const char *reason = nullptr;
+
+	switch (check_entry(buffer, key, contents, reason))
+	{
+	case entry_status::key_mismatch:
+		log::shadertoy()->debug("Program cache miss for {:016x}: key mismatch", key.hash);
+		return {};
+	case entry_status::invalid:
+		return discard(reason);
+	case entry_status::valid:
+		break;
+	}
+
+	// Read the payload
+	entry_reader payload(contents.payload, contents.payload + contents.payload_size);
+
+	std::vector<uniform_resource> uniforms;
+	std::vector<input_resource> inputs;
+	std::vector<output_resource> outputs;
+	uint32_t binary_length;
+	const char *binary;
+
+	if (!payload.read(uniforms) || !payload.read(inputs) || !payload.read(outputs) ||
+		!payload.read(binary_length) || !payload.read(binary, binary_length))
+		return discard("truncated payload");
+
+	// Load the binary, the driver may still reject it
+	gl::program loaded;
+
+	try
+	{
+		if (separable)
+		{
+			loaded.parameter(GL_PROGRAM_SEPARABLE, GL_TRUE);
+		}
+
+		loaded.binary(contents.binary_format, binary, binary_length);
+	}
+	catch (const gl::opengl_error &ex)
+	{
+		return discard(ex.what());
+	}
+
+	GLint link_status;
+	loaded.get(GL_LINK_STATUS, &link_status);
+	if (link_status != GL_TRUE)
+		return discard("rejected by the driver");
+
+	// Mark the entry as recently used
+	std::error_code ec;
+	fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+	log::shadertoy()->debug("Program cache hit for {:016x}", key.hash);
+
+	program = std::move(loaded);
+	return std::make_unique<program_interface>(program, uniform_interface(std::move(uniforms)),
+											   input_interface(std::move(inputs)),
+											   output_interface(std::move(outputs)));
+}
+
+void program_cache::store(const entry_key &key, const gl::program &program, const program_interface &interface) const
+{
+	GLint length = 0;
+	program.get(GL_PROGRAM_BINARY_LENGTH, &length);
+
+	if (length <= 0)
+	{
+		log::shadertoy()->debug("Program {} has no binary representation, not caching", GLuint(program));
+		return;
+	}
+
+	// Build the payload
+	std::vector<char> payload;
+	write_interface(payload, interface.uniforms());
+	write_interface(payload, interface.inputs());
+	write_interface(payload, interface.outputs());
+
+	GLsizei binary_length = 0;
+	GLenum binary_format;
+	std::vector<char> binary(length);
+	program.get_binary(length, &binary_length, &binary_format, binary.data());
+
+	write_value(payload, static_cast<uint32_t>(binary_length));
+	payload.insert(payload.end(), binary.begin(), binary.begin() + binary_length);
+
+	auto header(entry_header(key, static_cast<uint32_t>(binary_format), payload.data(), payload.size()));
+
+	if (!write_entry(entry_path(key.hash, entry_extension),
+					 { { header.data(), header.size() },
+					   { key.material.data(), key.material.size() },
+					   { payload.data(), payload.size() } }))
+	{
+		return;
+	}
+
+	log::shadertoy()->debug("Stored program {} in cache as {:016x} ({} bytes)", GLuint(program), key.hash,
+							header.size() + key.material.size() + payload.size());
+
+	evict();
+}
+
+void program_cache::evict() const
+{
+	struct entry
+	{
+		fs::path path;
+		uintmax_t size;
+		fs::file_time_type last_use;
+	};
+
+	std::vector<entry> entries;
+	uintmax_t total_size = 0;
+
+	std::error_code ec;
+	for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec))
+	{
+		auto extension(it->path().extension());
+		if (extension != entry_extension && extension != module_extension)
+			continue;
+
+		std::error_code entry_ec;
+		auto size(fs::file_size(it->path(), entry_ec));
+		auto last_use(fs::last_write_time(it->path(), entry_ec));
+
+		if (!entry_ec)
+		{
+			entries.push_back({ it->path(), size, last_use });
+			total_size += size;
+		}
+	}
+
+	if (total_size <= max_size_)
+		return;
+
+	// Remove least recently used entries first
+	std::sort(entries.begin(), entries.end(),
+			  [](const auto &a, const auto &b) { return a.last_use < b.last_use; });
+
+	for (const auto &entry : entries)
+	{
+		if (total_size <= max_size_)
+			break;
+
+		if (fs::remove(entry.path, ec))
+		{
+			log::shadertoy()->debug("Evicted program cache entry {}", entry.path.string());
+			total_size -= entry.size;
+		}
+	}
+}
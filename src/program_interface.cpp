@@ -26,9 +26,19 @@ program_resource::program_resource(const gl::program &program, GLenum program_in
 	type = values[2];
 	array_size = values[3];
 
-	// Fetch name
-	name = std::string(values[0] - 1, ' ');
-	program.get_program_resource_name(program_interface, resource_index, values[0], nullptr, name.data());
+	// Fetch name, which may not be reflected for SPIR-V programs
+	if (values[0] > 1)
+	{
+		name = std::string(values[0] - 1, ' ');
+		program.get_program_resource_name(program_interface, resource_index, values[0], nullptr, name.data());
+	}
+}
+
+program_resource::program_resource(GLenum program_interface, GLuint resource_index, std::string name,
+								   GLint location, GLint type, GLint array_size)
+: program_interface(program_interface), resource_index(resource_index), name(std::move(name)),
+  location(location), type(type), array_size(array_size)
+{
 }
 
 program_resource::~program_resource() = default;
@@ -113,16 +123,31 @@ uniform_resource::uniform_resource(const gl::program &program, GLuint resource_i
 {
 }
 
+uniform_resource::uniform_resource(GLuint resource_index, std::string name, GLint location, GLint type, GLint array_size)
+: program_resource(INTERFACE_TYPE, resource_index, std::move(name), location, type, array_size)
+{
+}
+
 input_resource::input_resource(const gl::program &program, GLuint resource_index)
 : program_resource(program, INTERFACE_TYPE, resource_index)
 {
 }
 
+input_resource::input_resource(GLuint resource_index, std::string name, GLint location, GLint type, GLint array_size)
+: program_resource(INTERFACE_TYPE, resource_index, std::move(name), location, type, array_size)
+{
+}
+
 output_resource::output_resource(const gl::program &program, GLuint resource_index)
 : program_resource(program, INTERFACE_TYPE, resource_index)
 {
 }
 
+output_resource::output_resource(GLuint resource_index, std::string name, GLint location, GLint type, GLint array_size)
+: program_resource(INTERFACE_TYPE, resource_index, std::move(name), location, type, array_size)
+{
+}
+
 program_interface::program_interface(const gl::program &program)
 	: program_(program),
 	uniforms_(program_),
@@ -130,3 +155,11 @@ program_interface::program_interface(const gl::program &program)
 	outputs_(program_)
 {}
 
+program_interface::program_interface(const gl::program &program, uniform_interface uniforms,
+									 input_interface inputs, output_interface outputs)
+	: program_(program),
+	uniforms_(std::move(uniforms)),
+	inputs_(std::move(inputs)),
+	outputs_(std::move(outputs))
+{}
+
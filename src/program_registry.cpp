@@ -0,0 +1,143 @@
+#include <algorithm>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+
+#include "shadertoy/program_registry.hpp"
+
+#include "utils/fnv1a.hpp"
+
+using namespace shadertoy;
+using shadertoy::utils::fnv1a;
+
+bool program_registry::entry_key::operator==(const entry_key &other) const
+{
+	if (hash != other.hash || separable != other.separable || spirv != other.spirv ||
+		specialization_constants != other.specialization_constants || sources.size() != other.sources.size())
+	{
+		return false;
+	}
+
+	return std::equal(sources.begin(), sources.end(), other.sources.begin(), [](const auto &lhs, const auto &rhs) {
+		return lhs.first == rhs.first &&
+			   std::equal(lhs.second.begin(), lhs.second.end(), rhs.second.begin(), rhs.second.end(),
+						  [](const auto &lsource, const auto &rsource) {
+							  // Identical buffers usually share the same source objects
+							  return lsource == rsource || lsource->second == rsource->second;
+						  });
+	});
+}
+
+program_registry::program_registry() : sweep_size_(16) {}
+
+std::multimap<uint64_t, program_registry::entry>::iterator program_registry::find_entry(const entry_key &key)
+{
+	auto range(programs_.equal_range(key.hash));
+	auto it = std::find_if(range.first, range.second, [&key](const auto &pair) { return pair.second.key == key; });
+	return it == range.second ? programs_.end() : it;
+}
+
+program_registry::entry_key program_registry::key(const compiler::program_template &program_template,
+												  const compiler::program_template::sources_map &sources)
+{
+	entry_key result;
+	result.separable = program_template.separable();
+	result.spirv = program_template.spirv();
+
+	// SPIR-V programs differ by their specialization constants
+	if (result.spirv)
+	{
+		result.specialization_constants = program_template.specialization_constants();
+	}
+
+	// Pre-compiled stages are part of the specified sources, so programs built
+	// from different templates with the same contents are interchangeable
+	result.sources = program_template.link_sources(sources);
+
+	uint8_t flags = (result.separable ? 1 : 0) | (result.spirv ? 2 : 0);
+	uint64_t hash = fnv1a(&flags, sizeof(flags));
+
+	for (const auto &pair : result.specialization_constants)
+	{
+		hash = fnv1a(hash, &pair.first, sizeof(pair.first));
+		hash = fnv1a(hash, &pair.second, sizeof(pair.second));
+	}
+
+	for (const auto &pair : result.sources)
+	{
+		hash = fnv1a(hash, &pair.first, sizeof(pair.first));
+
+		for (const auto &source : pair.second)
+		{
+			uint64_t size = source->second.size();
+			hash = fnv1a(hash, &size, sizeof(size));
+			hash = fnv1a(hash, source->second.data(), source->second.size());
+		}
+	}
+
+	result.hash = hash;
+	return result;
+}
+
+std::shared_ptr<shared_program> program_registry::find(const entry_key &key)
+{
+	auto it = find_entry(key);
+	if (it == programs_.end())
+	{
+		return {};
+	}
+
+	auto program(it->second.program.lock());
+	if (!program)
+	{
+		// No buffer is using this program anymore
+		programs_.erase(it);
+	}
+
+	return program;
+}
+
+std::shared_ptr<shared_program> program_registry::emplace(const entry_key &key)
+{
+	// Drop the program this one replaces
+	auto existing = find_entry(key);
+	if (existing != programs_.end())
+	{
+		programs_.erase(existing);
+	}
+
+	// Drop the programs which are not in use anymore, only once the registry
+	// doubled in size so registering a program does not scan all the others
+	if (programs_.size() >= sweep_size_)
+	{
+		for (auto it = programs_.begin(); it != programs_.end();)
+		{
+			if (it->second.program.expired())
+				it = programs_.erase(it);
+			else
+				++it;
+		}
+
+		sweep_size_ = std::max<size_t>(16, 2 * programs_.size());
+	}
+
+	auto program(std::make_shared<shared_program>());
+	programs_.emplace(key.hash, entry{ key, program });
+	return program;
+}
+
+void program_registry::erase(const entry_key &key)
+{
+	auto it = find_entry(key);
+	if (it != programs_.end())
+	{
+		programs_.erase(it);
+	}
+}
+
+size_t program_registry::size() const
+{
+	return std::count_if(programs_.begin(), programs_.end(),
+						 [](const auto &pair) { return !pair.second.program.expired(); });
+}
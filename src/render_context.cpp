@@ -6,7 +6,9 @@
 #include "resources.hpp"
 #include "shadertoy/buffers/program_buffer.hpp"
 #include "shadertoy/render_context.hpp"
+#include "shadertoy/program_registry.hpp"
 #include "shadertoy/shader_compiler.hpp"
+#include "shadertoy/source_cache.hpp"
 
 #include "shadertoy/compiler/define_part.hpp"
 #include "shadertoy/compiler/input_part.hpp"
@@ -22,7 +24,9 @@
 using namespace shadertoy;
 using namespace shadertoy::utils;
 
-render_context::render_context() : error_input_(std::make_shared<inputs::error_input>())
+render_context::render_context()
+: error_input_(std::make_shared<inputs::error_input>()), source_files_(std::make_shared<source_cache>()),
+  programs_(std::make_shared<program_registry>()), warm_up_on_init_(false)
 {
 	auto preprocessor_defines(std::make_shared<compiler::preprocessor_defines>());
 
@@ -32,13 +36,13 @@ render_context::render_context() : error_input_(std::make_shared<inputs::error_i
 	buffer_template_.shader_defines().emplace("glsl", preprocessor_defines);
 
 	buffer_template_.emplace(GL_VERTEX_SHADER,
-							 compiler::shader_template::parse(
-							 std::string(std::addressof(screenQuad_vsh[0]), screenQuad_vsh_size),
+							 compiler::shader_template::from_embedded(
+							 screenQuad_vsh_template,
 							 "libshadertoy/shaders/screenQuad.vsh"));
 
 	buffer_template_.emplace(GL_FRAGMENT_SHADER,
-							 compiler::shader_template::parse(
-							 std::string(std::addressof(shadertoy_frag_glsl[0]), shadertoy_frag_glsl_size),
+							 compiler::shader_template::from_embedded(
+							 shadertoy_frag_glsl_template,
 							 "libshadertoy/shaders/shadertoy_frag.glsl"));
 
 	// Compile screen quad vertex shader
@@ -82,6 +86,68 @@ void render_context::init(swap_chain &chain) const
 	chain.init(*this);
 
 	allocate_textures(chain);
+
+	if (warm_up_on_init_)
+	{
+		warm_up(chain);
+	}
+}
+
+std::vector<std::chrono::nanoseconds> render_context::warm_up(swap_chain &chain) const
+{
+	log::shadertoy()->trace("Warming up chain {}", static_cast<const void *>(&chain));
+
+	const auto &members(chain.members());
+
+	// Timestamps around the warm-up of every member, so the GPU time of each
+	// one is known without waiting for the GPU between members
+	std::vector<gl::query> timestamps;
+	timestamps.reserve(members.size() + 1);
+	timestamps.emplace_back(GL_TIMESTAMP).query_counter(GL_TIMESTAMP);
+
+	std::vector<std::chrono::nanoseconds> timings;
+	timings.reserve(members.size());
+
+	for (const auto &member : members)
+	{
+		timings.push_back(member->warm_up(chain, *this));
+		timestamps.emplace_back(GL_TIMESTAMP).query_counter(GL_TIMESTAMP);
+	}
+
+	// Wait for the driver to complete the work deferred to the draw calls only
+	// once all the members have been warmed up
+	GLuint64 previous;
+	timestamps.front().get_object_ui64v(GL_QUERY_RESULT, &previous);
+
+	std::chrono::nanoseconds total(0);
+
+	for (size_t i = 0; i < members.size(); ++i)
+	{
+		const auto &member(members[i]);
+
+		GLuint64 current;
+		timestamps[i + 1].get_object_ui64v(GL_QUERY_RESULT, &current);
+
+		timings[i] += std::chrono::nanoseconds(current - previous);
+		total += timings[i];
+		previous = current;
+
+		double ms = std::chrono::duration<double, std::milli>(timings[i]).count();
+		if (auto buffer_member = dynamic_cast<members::buffer_member *>(member.get()))
+		{
+			log::shadertoy()->info("Warmed up buffer {} ({}) in {:.2f} ms", buffer_member->buffer()->id(),
+								   static_cast<const void *>(member.get()), ms);
+		}
+		else
+		{
+			log::shadertoy()->info("Warmed up member {} in {:.2f} ms", static_cast<const void *>(member.get()), ms);
+		}
+	}
+
+	log::shadertoy()->info("Warmed up chain {} in {:.2f} ms", static_cast<const void *>(&chain),
+						   std::chrono::duration<double, std::milli>(total).count());
+
+	return timings;
 }
 
 void render_context::allocate_textures(swap_chain &chain) const
@@ -90,6 +156,27 @@ void render_context::allocate_textures(swap_chain &chain) const
 	chain.allocate_textures(*this);
 }
 
+void render_context::apply_compiler_threads() const
+{
+	if (!compiler_threads_)
+	{
+		return;
+	}
+
+	if (epoxy_has_gl_extension("GL_KHR_parallel_shader_compile"))
+	{
+		gl::gl_call(glMaxShaderCompilerThreadsKHR, *compiler_threads_);
+	}
+	else if (epoxy_has_gl_extension("GL_ARB_parallel_shader_compile"))
+	{
+		gl::gl_call(glMaxShaderCompilerThreadsARB, *compiler_threads_);
+	}
+	else
+	{
+		log::shadertoy()->debug("Parallel shader compilation is not supported, ignoring compiler_threads hint");
+	}
+}
+
 std::shared_ptr<members::basic_member> render_context::render(swap_chain &chain) const
 {
 	return chain.render(*this);
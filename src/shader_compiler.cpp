@@ -11,29 +11,41 @@
 using namespace std;
 using namespace shadertoy;
 
-void shader_compiler::compile(gl::shader &shader, const std::vector<std::pair<std::string, std::string>> &named_sources)
+void shader_compiler::compile(gl::shader &shader, const compiler::source_list &named_sources)
 {
-	// Transform pairs into list of C strings
-	vector<std::string> sources(named_sources.size());
+	submit(shader, named_sources);
+	check(shader, named_sources);
+}
+
+void shader_compiler::submit(gl::shader &shader, const compiler::source_list &named_sources)
+{
+	// Transform pairs into list of C strings, the shared sources outlive this call
+	vector<const char *> sources(named_sources.size());
 	transform(named_sources.begin(), named_sources.end(), sources.begin(),
-		[] (const pair<string, string> &namedSource) {
-			return namedSource.second;
+		[] (const compiler::shared_source &namedSource) {
+			return namedSource->second.c_str();
 		});
 
-	// Also, build a line count
+	// Load sources in shader and start compiling
+	shader.source(sources);
+	shader.compile_deferred();
+}
+
+void shader_compiler::check(gl::shader &shader, const compiler::source_list &named_sources)
+{
+	// Build a line count
 	vector<int> lineCounts(named_sources.size());
 	transform(named_sources.begin(), named_sources.end(), lineCounts.begin(),
-		[] (const pair<string, string> &namedSource) {
-			return count(namedSource.second.begin(),
-						 namedSource.second.end(),
+		[] (const compiler::shared_source &namedSource) {
+			return count(namedSource->second.begin(),
+						 namedSource->second.end(),
 						 '\n');
 		});
 
-	// Load sources in fragment shader and compile
+	// Wait for the compilation result
 	try
 	{
-		shader.source(sources);
-		shader.compile();
+		shader.check_compile();
 	}
 	catch (gl::shader_compilation_error &ex)
 	{
@@ -87,7 +99,7 @@ void shader_compiler::compile(gl::shader &shader, const std::vector<std::pair<st
 				}
 
 				// Output a formatted message with the error
-				os << named_sources.at(li).first
+				os << named_sources.at(li)->first
 				   << c
 				   << (pline - lc)
 				   << d
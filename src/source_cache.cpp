@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+
+#include "shadertoy/compiler/template_error.hpp"
+#include "shadertoy/utils/assert.hpp"
+#include "shadertoy/utils/log.hpp"
+
+#include "utils/fnv1a.hpp"
+
+#include "shadertoy/source_cache.hpp"
+
+#if __cpp_lib_filesystem >= 201703
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem::v1;
+#endif
+
+using namespace shadertoy;
+using namespace shadertoy::compiler;
+using shadertoy::utils::throw_assert;
+using shadertoy::utils::log;
+
+namespace
+{
+
+/// Files modified less than this long before being read may be modified again without changing their timestamp
+constexpr const std::chrono::seconds racy_window(2);
+
+/**
+ * @brief Read the contents of a file, ensuring they end with a line break
+ *
+ * The contents are read directly into the string which is then split into
+ * sources, since GL needs null-terminated copies of the sources anyway.
+ *
+ * @param path Path to the file
+ * @param size Size of the file
+ *
+ * @return Contents of the file
+ */
+std::string read_file(const std::string &path, uintmax_t size)
+{
+	std::ifstream src(path, std::ios::binary);
+	throw_assert<template_error>(src.is_open(), "Failed to open file {}", path);
+
+	std::string contents(size, '\0');
+	src.read(&contents[0], static_cast<std::streamsize>(size));
+	contents.resize(static_cast<size_t>(src.gcount()));
+
+	if (contents.empty() || contents.back() != '\n')
+	{
+		contents += '\n';
+	}
+
+	return contents;
+}
+
+/**
+ * @brief Check if a file modified at the given time may be modified again without changing its timestamp
+ *
+ * @param write_time Modification time of the file
+ *
+ * @return true if the file contents must be compared to detect changes
+ */
+bool is_racy(fs::file_time_type write_time)
+{
+	return fs::file_time_type::clock::now() - write_time < racy_window;
+}
+
+/**
+ * @brief Parse a `#pragma shadertoy include "file"` directive
+ *
+ * @param line      Line to parse, without its line break
+ * @param[out] file Included file name
+ *
+ * @return true if \p line is an include directive, false otherwise
+ */
+bool parse_include(std::string_view line, std::string_view &file)
+{
+	size_t pos = 0;
+
+	auto skip_spaces = [&]() {
+		size_t start = pos;
+		while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r'))
+			++pos;
+		return pos - start;
+	};
+
+	auto keyword = [&](std::string_view word) {
+		if (line.compare(pos, word.size(), word) != 0)
+			return false;
+
+		pos += word.size();
+		return true;
+	};
+
+	skip_spaces();
+
+	if (!keyword("#pragma") || skip_spaces() == 0 || !keyword("shadertoy") || skip_spaces() == 0 ||
+		!keyword("include") || skip_spaces() == 0 || !keyword("\""))
+		return false;
+
+	size_t end = line.find('"', pos);
+	if (end == std::string_view::npos || end == pos)
+		return false;
+
+	file = line.substr(pos, end - pos);
+	pos = end + 1;
+
+	skip_spaces();
+	return pos == line.size();
+}
+
+std::string canonical_path(const std::string &path)
+{
+	std::error_code ec;
+	auto result(fs::canonical(path, ec));
+
+	if (ec)
+	{
+		return fs::absolute(path).string();
+	}
+
+	return result.string();
+}
+}
+
+const source_cache::entry &source_cache::load(const std::string &path, std::vector<std::string> &stack)
+{
+	throw_assert<template_error>(std::find(stack.begin(), stack.end(), path) == stack.end(),
+								 "Include cycle detected: {} includes itself", path);
+
+	std::error_code ec;
+	auto write_time(fs::last_write_time(path, ec));
+	auto mtime = static_cast<int64_t>(
+	std::chrono::duration_cast<std::chrono::nanoseconds>(write_time.time_since_epoch()).count());
+	uintmax_t size = ec ? 0 : fs::file_size(path, ec);
+
+	throw_assert<template_error>(!ec, "Failed to open file {}", path);
+
+	stack.push_back(path);
+
+	std::string contents;
+	bool read = false;
+
+	// Check if the cached entry and its includes are up-to-date
+	auto it = entries_.find(path);
+	if (it != entries_.end() && it->second.mtime == mtime && it->second.size == size)
+	{
+		bool unchanged = true;
+
+		if (it->second.racy)
+		{
+			// The timestamp cannot be trusted, compare the contents
+			contents = read_file(path, size);
+			read = true;
+
+			unchanged = utils::fnv1a(contents.data(), contents.size()) == it->second.hash;
+			if (unchanged)
+			{
+				it->second.racy = is_racy(write_time);
+			}
+		}
+
+		if (unchanged && std::all_of(it->second.includes.begin(), it->second.includes.end(), [&](const auto &include) {
+				return load(include.first, stack).generation == include.second;
+			}))
+		{
+			stack.pop_back();
+			return it->second;
+		}
+	}
+
+	log::shadertoy()->trace("Reading {}", path);
+
+	if (!read)
+	{
+		contents = read_file(path, size);
+	}
+
+	auto directory(fs::path(path).parent_path());
+	std::string_view view(contents);
+
+	entry result{ mtime, size, utils::fnv1a(contents.data(), contents.size()), is_racy(write_time), 0, {}, {} };
+
+	// Split the file on include directives
+	size_t chunk_start = 0, line_start = 0;
+	size_t line_num = 0, chunk_line = 0;
+
+	auto emit_chunk = [&](size_t end) {
+		if (end > chunk_start)
+		{
+			// Pad the chunk so line numbers match the file
+			std::string chunk(chunk_line, '\n');
+			chunk.append(view.substr(chunk_start, end - chunk_start));
+			result.sources.emplace_back(make_source(path, std::move(chunk)));
+		}
+	};
+
+	for (; line_start < view.size(); ++line_num)
+	{
+		size_t line_end = view.find('\n', line_start);
+		std::string_view file;
+
+		if (parse_include(view.substr(line_start, line_end - line_start), file))
+		{
+			emit_chunk(line_start);
+
+			auto include_path(canonical_path((directory / std::string(file)).string()));
+			const auto &include(load(include_path, stack));
+
+			result.sources.insert(result.sources.end(), include.sources.begin(), include.sources.end());
+			result.includes.emplace_back(include_path, include.generation);
+
+			chunk_start = line_end + 1;
+			chunk_line = line_num + 1;
+		}
+
+		line_start = line_end + 1;
+	}
+
+	emit_chunk(view.size());
+
+	stack.pop_back();
+
+	result.generation = ++generation_;
+
+	auto &target(entries_[path]);
+	target = std::move(result);
+	return target;
+}
+
+source_cache::source_cache()
+: generation_(0)
+{
+}
+
+compiler::source_list source_cache::sources(const std::string &path)
+{
+	std::error_code ec;
+	auto canonical(fs::canonical(path, ec));
+	throw_assert<template_error>(!ec, "Failed to open file {}", path);
+
+	std::vector<std::string> stack;
+	return load(canonical.string(), stack).sources;
+}
+
+std::set<std::string> source_cache::dependencies(const std::string &path) const
+{
+	std::set<std::string> result;
+	std::vector<std::string> pending{ canonical_path(path) };
+
+	while (!pending.empty())
+	{
+		auto it = entries_.find(pending.back());
+		pending.pop_back();
+
+		if (it == entries_.end())
+			continue;
+
+		for (const auto &include : it->second.includes)
+		{
+			if (result.insert(include.first).second)
+			{
+				pending.push_back(include.first);
+			}
+		}
+	}
+
+	return result;
+}
+
+std::set<std::string> source_cache::dependents(const std::string &path) const
+{
+	// Build the reverse include graph
+	std::multimap<std::string, std::string> included_by;
+	for (const auto &pair : entries_)
+	{
+		for (const auto &include : pair.second.includes)
+		{
+			included_by.emplace(include.first, pair.first);
+		}
+	}
+
+	std::set<std::string> result;
+	std::vector<std::string> pending{ canonical_path(path) };
+
+	while (!pending.empty())
+	{
+		auto range = included_by.equal_range(pending.back());
+		pending.pop_back();
+
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (result.insert(it->second).second)
+			{
+				pending.push_back(it->second);
+			}
+		}
+	}
+
+	return result;
+}
+
+void source_cache::invalidate(const std::string &path)
+{
+	entries_.erase(canonical_path(path));
+}
+
+void source_cache::clear()
+{
+	entries_.clear();
+}
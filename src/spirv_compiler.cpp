@@ -0,0 +1,207 @@
+#include <mutex>
+#include <string>
+
+#include <epoxy/gl.h>
+
+#if LIBSHADERTOY_SPIRV
+#include <glslang/Public/ResourceLimits.h>
+#include <glslang/Public/ShaderLang.h>
+#include <glslang/SPIRV/GlslangToSpv.h>
+#include <spirv-tools/optimizer.hpp>
+#endif /* LIBSHADERTOY_SPIRV */
+
+#include "shadertoy/gl.hpp"
+#include "shadertoy/utils/assert.hpp"
+
+#include "shadertoy/spirv_compiler.hpp"
+
+using namespace shadertoy;
+using shadertoy::gl::gl_call;
+using shadertoy::utils::log;
+using shadertoy::utils::throw_assert;
+
+#if LIBSHADERTOY_SPIRV
+namespace
+{
+
+EShLanguage stage_language(GLenum type)
+{
+	switch (type)
+	{
+	case GL_VERTEX_SHADER:
+		return EShLangVertex;
+	case GL_TESS_CONTROL_SHADER:
+		return EShLangTessControl;
+	case GL_TESS_EVALUATION_SHADER:
+		return EShLangTessEvaluation;
+	case GL_GEOMETRY_SHADER:
+		return EShLangGeometry;
+	case GL_FRAGMENT_SHADER:
+		return EShLangFragment;
+	case GL_COMPUTE_SHADER:
+		return EShLangCompute;
+	default:
+		throw_assert<shadertoy_error>(false, "Unsupported shader type {} for SPIR-V compilation", type);
+		return EShLangCount;
+	}
+}
+
+void initialize_glslang()
+{
+	static std::once_flag initialized;
+	std::call_once(initialized, []() { glslang::InitializeProcess(); });
+}
+}
+#endif /* LIBSHADERTOY_SPIRV */
+
+bool spirv_compiler::supported()
+{
+#if LIBSHADERTOY_SPIRV
+	return epoxy_gl_version() >= 46 || epoxy_has_gl_extension("GL_ARB_gl_spirv");
+#else
+	return false;
+#endif
+}
+
+bool spirv_compiler::reflects_names()
+{
+	if (!supported())
+	{
+		return false;
+	}
+
+	try
+	{
+		auto source(compiler::make_source("spirv:probe", "#version 450\n"
+														 "uniform float iProbe;\n"
+														 "out vec4 fragColor;\n"
+														 "void main() { fragColor = vec4(iProbe); }\n"));
+		auto module(compile(GL_FRAGMENT_SHADER, { { source } }, false));
+
+		gl::shader so(GL_FRAGMENT_SHADER);
+		load(so, module, {});
+		so.check_compile();
+
+		gl::program program;
+		program.parameter(GL_PROGRAM_SEPARABLE, GL_TRUE);
+		program.attach_shader(so);
+		program.link();
+		program.detach_shader(so);
+
+		return gl_call(glGetProgramResourceIndex, GLuint(program), GL_UNIFORM, "iProbe") != GL_INVALID_INDEX;
+	}
+	catch (const shadertoy_error &ex)
+	{
+		log::shadertoy()->debug("Failed to link the SPIR-V reflection probe: {}", ex.what());
+		return false;
+	}
+}
+
+std::string spirv_compiler::version()
+{
+#if LIBSHADERTOY_SPIRV
+	auto glslang_version(glslang::GetVersion());
+	return fmt::format("glslang {}.{}.{}{} {}", glslang_version.major, glslang_version.minor, glslang_version.patch,
+					   glslang_version.flavor, spvSoftwareVersionDetailsString());
+#else
+	return {};
+#endif
+}
+
+std::vector<uint32_t> spirv_compiler::compile(GLenum type, const std::vector<compiler::source_list> &units, bool optimize)
+{
+#if LIBSHADERTOY_SPIRV
+	initialize_glslang();
+
+	auto language = stage_language(type);
+	auto messages = static_cast<EShMessages>(EShMsgSpvRules | EShMsgDefault);
+
+	// The compilation units must outlive the program linking them
+	std::vector<std::unique_ptr<glslang::TShader>> shaders;
+	glslang::TProgram program;
+
+	for (const auto &unit : units)
+	{
+		// Named strings make glslang report errors with the part names
+		std::vector<const char *> strings, names;
+		std::vector<int> lengths;
+
+		for (const auto &source : unit)
+		{
+			strings.push_back(source->second.c_str());
+			lengths.push_back(static_cast<int>(source->second.size()));
+			names.push_back(source->first.c_str());
+		}
+
+		auto shader(std::make_unique<glslang::TShader>(language));
+		shader->setStringsWithLengthsAndNames(strings.data(), lengths.data(), names.data(),
+											  static_cast<int>(strings.size()));
+		shader->setEnvInput(glslang::EShSourceGlsl, language, glslang::EShClientOpenGL, 100);
+		shader->setEnvClient(glslang::EShClientOpenGL, glslang::EShTargetOpenGL_450);
+		shader->setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+
+		// Shadertoy sources do not specify locations and bindings
+		shader->setAutoMapLocations(true);
+		shader->setAutoMapBindings(true);
+
+		if (!shader->parse(GetDefaultResources(), 100, false, messages))
+		{
+			throw gl::shader_compilation_error(0, shader->getInfoLog());
+		}
+
+		program.addShader(shader.get());
+		shaders.emplace_back(std::move(shader));
+	}
+
+	if (!program.link(messages) || !program.mapIO())
+	{
+		throw gl::shader_compilation_error(0, program.getInfoLog());
+	}
+
+	std::vector<uint32_t> module;
+	glslang::SpvOptions options;
+	options.disableOptimizer = true;
+	glslang::GlslangToSpv(*program.getIntermediate(language), module, &options);
+
+	if (optimize)
+	{
+		spvtools::Optimizer optimizer(SPV_ENV_OPENGL_4_5);
+		optimizer.SetMessageConsumer([](spv_message_level_t, const char *, const spv_position_t &, const char *message) {
+			log::shadertoy()->debug("SPIR-V optimizer: {}", message);
+		});
+		optimizer.RegisterPerformancePasses();
+
+		std::vector<uint32_t> optimized;
+		if (optimizer.Run(module.data(), module.size(), &optimized))
+		{
+			log::shadertoy()->trace("Optimized SPIR-V module from {} to {} words", module.size(), optimized.size());
+			module = std::move(optimized);
+		}
+		else
+		{
+			log::shadertoy()->warn("Failed to optimize SPIR-V module, using the unoptimized module");
+		}
+	}
+
+	return module;
+#else
+	throw_assert<shadertoy_error>(false, "SPIR-V support was not enabled at compile-time");
+	return {};
+#endif
+}
+
+void spirv_compiler::load(gl::shader &shader, const std::vector<uint32_t> &module, const specialization_map &constants)
+{
+	std::vector<GLuint> indices, values;
+	indices.reserve(constants.size());
+	values.reserve(constants.size());
+
+	for (const auto &pair : constants)
+	{
+		indices.push_back(pair.first);
+		values.push_back(pair.second);
+	}
+
+	shader.binary(GL_SHADER_BINARY_FORMAT_SPIR_V, module.data(), static_cast<GLsizei>(module.size() * sizeof(uint32_t)));
+	shader.specialize("main", static_cast<GLuint>(indices.size()), indices.data(), values.data());
+}
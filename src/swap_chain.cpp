@@ -1,10 +1,11 @@
 #include <epoxy/gl.h>
 
-#include "shadertoy/gl/texture.hpp"
+#include "shadertoy/gl.hpp"
 
 #include "shadertoy/members/basic_member.hpp"
 #include "shadertoy/members/buffer_member.hpp"
 
+#include "shadertoy/render_context.hpp"
 #include "shadertoy/swap_chain.hpp"
 
 #include "shadertoy/utils/assert.hpp"
@@ -100,6 +101,16 @@ swap_chain::render(const render_context &context, const std::shared_ptr<members:
 
 void swap_chain::init(const render_context &context)
 {
+	context.apply_compiler_threads();
+
+	// Submit the work of all members first (i.e., program compilation), so
+	// the driver can process it concurrently
+	for (auto &member : members_)
+	{
+		member->prepare(*this, context);
+	}
+
+	// Then wait for the results in order
 	for (auto &member : members_)
 	{
 		member->init(*this, context);
@@ -113,3 +124,24 @@ void swap_chain::allocate_textures(const render_context &context)
 		member->allocate(*this, context);
 	}
 }
+
+swap_chain swap_chain::clone() const
+{
+	swap_chain result(internal_format_, swap_policy_);
+	members::member_map_t clones;
+
+	for (const auto &member : members_)
+	{
+		auto clone(member->clone());
+		clones.emplace(member.get(), clone);
+		result.push_back(clone);
+	}
+
+	// Update the references between members once they have all been cloned
+	for (const auto &member : result.members_)
+	{
+		member->remap_members(clones);
+	}
+
+	return result;
+}
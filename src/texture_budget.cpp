@@ -0,0 +1,120 @@
+#include <algorithm>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+
+#include "shadertoy/inputs/file_input.hpp"
+#include "shadertoy/inputs/shared_input.hpp"
+
+#include "shadertoy/texture_budget.hpp"
+
+#include "shadertoy/utils/log.hpp"
+
+using namespace shadertoy;
+
+using shadertoy::utils::log;
+
+texture_budget::texture_budget(size_t max_size) : max_size_(max_size), frame_(0), evictions_(0) {}
+
+void texture_budget::track(const std::shared_ptr<inputs::basic_input> &input)
+{
+	auto tracked(input);
+
+	// Shared inputs are accounted through the input owning the texture
+	while (auto shared = dynamic_cast<inputs::shared_input *>(tracked.get()))
+	{
+		tracked = shared->source();
+	}
+
+	if (!dynamic_cast<inputs::file_input *>(tracked.get()))
+	{
+		return;
+	}
+
+	if (tracked->budget_.lock().get() == this)
+	{
+		return;
+	}
+
+	tracked->budget_ = weak_from_this();
+	tracked->last_use_frame_ = frame_;
+	inputs_.emplace_back(tracked);
+}
+
+size_t texture_budget::next_frame()
+{
+	// Drop the inputs which are not in use anymore
+	inputs_.erase(std::remove_if(inputs_.begin(), inputs_.end(), [](const auto &input) { return input.expired(); }),
+				  inputs_.end());
+
+	size_t resident = resident_bytes(), evicted = 0;
+
+	if (resident > max_size_)
+	{
+		std::vector<std::shared_ptr<inputs::basic_input>> candidates;
+		for (const auto &input : inputs_)
+		{
+			auto ptr(input.lock());
+			if (ptr->texture_bytes_ > 0 && ptr->last_use_frame_ < frame_)
+			{
+				candidates.emplace_back(std::move(ptr));
+			}
+		}
+
+		// Least recently used first
+		std::sort(candidates.begin(), candidates.end(), [](const auto &lhs, const auto &rhs) {
+			return lhs->last_use_frame_ < rhs->last_use_frame_;
+		});
+
+		for (auto &input : candidates)
+		{
+			if (resident - evicted <= max_size_)
+			{
+				break;
+			}
+
+			log::shadertoy()->debug("Evicting input {} ({} bytes, last used at frame {})",
+									static_cast<const void *>(input.get()), input->texture_bytes_,
+									input->last_use_frame_);
+
+			evicted += input->texture_bytes_;
+			input->reset();
+			evictions_++;
+
+			if (decode_pool_)
+			{
+				static_cast<inputs::file_input *>(input.get())->decode_pool(decode_pool_);
+			}
+		}
+
+		if (resident - evicted > max_size_)
+		{
+			log::shadertoy()->debug("Texture budget exceeded by frame {}: {} bytes resident for {} bytes allowed",
+									frame_, resident - evicted, max_size_);
+		}
+	}
+
+	frame_++;
+	return evicted;
+}
+
+size_t texture_budget::resident_bytes() const
+{
+	size_t bytes = 0;
+
+	for (const auto &input : inputs_)
+	{
+		if (auto ptr = input.lock())
+		{
+			bytes += ptr->texture_bytes_;
+		}
+	}
+
+	return bytes;
+}
+
+size_t texture_budget::size() const
+{
+	return std::count_if(inputs_.begin(), inputs_.end(), [](const auto &input) { return !input.expired(); });
+}
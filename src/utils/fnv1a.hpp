@@ -0,0 +1,51 @@
+#ifndef _SHADERTOY_UTILS_FNV1A_HPP_
+#define _SHADERTOY_UTILS_FNV1A_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace shadertoy
+{
+namespace utils
+{
+
+/// Initial value of a 64-bit FNV-1a hash
+constexpr const uint64_t fnv1a_basis = 0xcbf29ce484222325ULL;
+
+/**
+ * @brief Update a 64-bit FNV-1a hash with the given data
+ *
+ * @param hash Current value of the hash
+ * @param data Pointer to the data to hash
+ * @param size Size of the data to hash, in bytes
+ *
+ * @return Updated hash value
+ */
+inline uint64_t fnv1a(uint64_t hash, const void *data, size_t size)
+{
+	auto bytes = static_cast<const unsigned char *>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * @brief Compute the 64-bit FNV-1a hash of the given data
+ *
+ * @param data Pointer to the data to hash
+ * @param size Size of the data to hash, in bytes
+ *
+ * @return Hash value
+ */
+inline uint64_t fnv1a(const void *data, size_t size)
+{
+	return fnv1a(fnv1a_basis, data, size);
+}
+}
+}
+
+#endif /* _SHADERTOY_UTILS_FNV1A_HPP_ */
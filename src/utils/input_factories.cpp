@@ -8,11 +8,15 @@
 #include "shadertoy/utils/input_factories.hpp"
 
 #include "shadertoy/inputs/exr_input.hpp"
+#include "shadertoy/inputs/hdr_input.hpp"
 #include "shadertoy/inputs/jpeg_input.hpp"
+#include "shadertoy/inputs/ktx_input.hpp"
+#include "shadertoy/inputs/qoi_input.hpp"
 #include "shadertoy/inputs/soil_input.hpp"
 
 #include "shadertoy/inputs/checker_input.hpp"
 #include "shadertoy/inputs/noise_input.hpp"
+#include "shadertoy/inputs/sequence_input.hpp"
 
 #if __cpp_lib_filesystem >= 201703
 #include <filesystem>
@@ -33,11 +37,46 @@ std::string file_ext(const std::string &path)
 	return ext;
 }
 
+int get_int(const std::map<std::string, std::string> &spec, const std::string &key, int def)
+{
+	auto it = spec.find(key);
+	if (it != spec.end())
+	{
+		std::istringstream iss(it->second);
+		int result;
+		iss >> result;
+		if (!iss.fail())
+		{
+			return result;
+		}
+	}
+	
+	return def;
+}
+
+double get_double(const std::map<std::string, std::string> &spec, const std::string &key, double def)
+{
+	auto it = spec.find(key);
+	if (it != spec.end())
+	{
+		std::istringstream iss(it->second);
+		double result;
+		iss >> result;
+		if (!iss.fail())
+		{
+			return result;
+		}
+	}
+
+	return def;
+}
+
 bool soil_input_factory::supported(const std::map<std::string, std::string> &spec) const
 {
 	auto ext(file_ext(spec.at("")));
 	return inputs::soil_input::supported() &&
-		(ext == ".bmp" || ext == ".png" || ext == ".jpg" || ext == ".tga" || ext == ".dds" || ext == ".psd" || ext == ".hdr");
+		(ext == ".bmp" || ext == ".png" || ext == ".jpg" || ext == ".tga" || ext == ".dds" || ext == ".psd" ||
+		 (ext == ".hdr" && !inputs::hdr_input::supported()));
 }
 
 std::unique_ptr<inputs::basic_input> soil_input_factory::create(const std::map<std::string, std::string> &spec) const
@@ -58,7 +97,9 @@ bool jpeg_input_factory::supported(const std::map<std::string, std::string> &spe
 
 std::unique_ptr<inputs::basic_input> jpeg_input_factory::create(const std::map<std::string, std::string> &spec) const
 {
-	return std::make_unique<inputs::jpeg_input>(spec.at(""));
+	auto input(std::make_unique<inputs::jpeg_input>(spec.at("")));
+	input->max_dimension(get_int(spec, "max_size", 0));
+	return input;
 }
 
 jpeg_input_factory::jpeg_input_factory()
@@ -73,30 +114,59 @@ bool exr_input_factory::supported(const std::map<std::string, std::string> &spec
 
 std::unique_ptr<inputs::basic_input> exr_input_factory::create(const std::map<std::string, std::string> &spec) const
 {
-	return std::make_unique<inputs::exr_input>(spec.at(""));
+	auto it = spec.find("layer");
+	return std::make_unique<inputs::exr_input>(spec.at(""), it != spec.end() ? it->second : std::string());
 }
 
 exr_input_factory::exr_input_factory()
 	: type_name_("file")
 {}
 
-int get_int(const std::map<std::string, std::string> &spec, const std::string &key, int def)
+bool ktx_input_factory::supported(const std::map<std::string, std::string> &spec) const
 {
-	auto it = spec.find(key);
-	if (it != spec.end())
-	{
-		std::istringstream iss(it->second);
-		int result;
-		iss >> result;
-		if (!iss.fail())
-		{
-			return result;
-		}
-	}
-	
-	return def;
+	auto ext(file_ext(spec.at("")));
+	return inputs::ktx_input::supported() && (ext == ".ktx2" || ext == ".dds");
+}
+
+std::unique_ptr<inputs::basic_input> ktx_input_factory::create(const std::map<std::string, std::string> &spec) const
+{
+	return std::make_unique<inputs::ktx_input>(spec.at(""));
+}
+
+ktx_input_factory::ktx_input_factory()
+	: type_name_("file")
+{}
+
+bool qoi_input_factory::supported(const std::map<std::string, std::string> &spec) const
+{
+	auto ext(file_ext(spec.at("")));
+	return inputs::qoi_input::supported() && ext == ".qoi";
+}
+
+std::unique_ptr<inputs::basic_input> qoi_input_factory::create(const std::map<std::string, std::string> &spec) const
+{
+	return std::make_unique<inputs::qoi_input>(spec.at(""));
+}
+
+qoi_input_factory::qoi_input_factory()
+	: type_name_("file")
+{}
+
+bool hdr_input_factory::supported(const std::map<std::string, std::string> &spec) const
+{
+	auto ext(file_ext(spec.at("")));
+	return inputs::hdr_input::supported() && ext == ".hdr";
 }
 
+std::unique_ptr<inputs::basic_input> hdr_input_factory::create(const std::map<std::string, std::string> &spec) const
+{
+	return std::make_unique<inputs::hdr_input>(spec.at(""));
+}
+
+hdr_input_factory::hdr_input_factory()
+	: type_name_("file")
+{}
+
 std::unique_ptr<inputs::basic_input> noise_input_factory::create(const std::map<std::string, std::string> &spec) const
 {
 	return std::make_unique<inputs::noise_input>(make_size(rsize(get_int(spec, "width", 128),
@@ -118,3 +188,14 @@ checker_input_factory::checker_input_factory()
 	: type_name_("checker")
 {}
 
+std::unique_ptr<inputs::basic_input> sequence_input_factory::create(const std::map<std::string, std::string> &spec) const
+{
+	auto input(std::make_unique<inputs::sequence_input>(spec.at(""), get_double(spec, "fps", 30.0)));
+	input->loop(get_int(spec, "loop", 1) != 0);
+	input->ring_size(get_int(spec, "ring", 4));
+	return input;
+}
+
+sequence_input_factory::sequence_input_factory()
+	: type_name_("sequence")
+{}
@@ -6,9 +6,13 @@
 #include "shadertoy/uri.hpp"
 
 #include "shadertoy/inputs/basic_input.hpp"
+#include "shadertoy/inputs/file_input.hpp"
+#include "shadertoy/inputs/sequence_input.hpp"
+#include "shadertoy/inputs/shared_input.hpp"
 
 #include "shadertoy/utils/input_factories.hpp"
 #include "shadertoy/utils/input_loader.hpp"
+#include "shadertoy/utils/texture_cache.hpp"
 
 #include "shadertoy/utils/assert.hpp"
 
@@ -21,9 +25,13 @@ input_loader::input_loader()
 	add(std::make_unique<soil_input_factory>());
 	add(std::make_unique<jpeg_input_factory>());
 	add(std::make_unique<exr_input_factory>());
+	add(std::make_unique<ktx_input_factory>());
+	add(std::make_unique<qoi_input_factory>());
+	add(std::make_unique<hdr_input_factory>());
 	
 	add(std::make_unique<noise_input_factory>());
 	add(std::make_unique<checker_input_factory>());
+	add(std::make_unique<sequence_input_factory>());
 }
 
 void input_loader::add(std::unique_ptr<input_factory> &&factory)
@@ -37,13 +45,45 @@ std::unique_ptr<inputs::basic_input> input_loader::create(const std::string &inp
 	auto spec(url.get_query_dictionary());
 	spec.emplace(std::string(), url.get_path());
 
+	std::string cache_key;
+	if (cache_)
+	{
+		cache_key = texture_cache::key(url.get_scheme(), spec);
+
+		if (auto source = cache_->find(cache_key))
+		{
+			return std::make_unique<inputs::shared_input>(std::move(source));
+		}
+	}
+
 	for (auto &factory : factories_)
 	{
 		if (factory->type_name() == url.get_scheme())
 		{
 			if (factory->supported(spec))
 			{
-				return factory->create(spec);
+				auto result(factory->create(spec));
+
+				if (decode_pool_)
+				{
+					if (auto file = dynamic_cast<inputs::file_input *>(result.get()))
+					{
+						file->decode_pool(decode_pool_);
+					}
+					else if (auto sequence = dynamic_cast<inputs::sequence_input *>(result.get()))
+					{
+						sequence->decode_pool(decode_pool_);
+					}
+				}
+
+				if (cache_ && dynamic_cast<inputs::image_input *>(result.get()))
+				{
+					std::shared_ptr<inputs::basic_input> source(std::move(result));
+					cache_->emplace(cache_key, source);
+					return std::make_unique<inputs::shared_input>(std::move(source));
+				}
+
+				return result;
 			}
 		}
 	}
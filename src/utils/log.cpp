@@ -3,15 +3,11 @@
 using namespace shadertoy::utils;
 namespace spd = spdlog;
 
-bool log::initialized_ = false;
+std::once_flag log::initialized_;
 
 std::shared_ptr<spd::logger> log::shadertoy()
 {
-	if (!initialized_)
-	{
-		initialized_ = true;
-		return spd::stderr_color_st("shadertoy");
-	}
+	std::call_once(initialized_, []() { spd::stderr_color_mt("shadertoy"); });
 
 	return spd::get("shadertoy");
 }
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <set>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+
+#include "shadertoy/buffers/program_buffer.hpp"
+#include "shadertoy/compiler/file_part.hpp"
+#include "shadertoy/render_context.hpp"
+#include "shadertoy/source_cache.hpp"
+
+#include "shadertoy/utils/assert.hpp"
+#include "shadertoy/utils/shader_reloader.hpp"
+
+#if __cpp_lib_filesystem >= 201703
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem::v1;
+#endif
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define LIBSHADERTOY_INOTIFY 1
+#else
+#define LIBSHADERTOY_INOTIFY 0
+#endif
+
+using namespace shadertoy;
+using namespace shadertoy::utils;
+
+shader_reloader::shader_reloader()
+: fd_(-1), source_generation_(0)
+{
+#if LIBSHADERTOY_INOTIFY
+	fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	warn_assert(fd_ >= 0, "Failed to initialize inotify: {}", std::strerror(errno));
+#endif
+}
+
+shader_reloader::~shader_reloader()
+{
+#if LIBSHADERTOY_INOTIFY
+	if (fd_ >= 0)
+	{
+		close(fd_);
+	}
+#endif
+}
+
+bool shader_reloader::supported()
+{
+	return LIBSHADERTOY_INOTIFY;
+}
+
+void shader_reloader::watch(const std::shared_ptr<buffers::program_buffer> &buffer)
+{
+	auto part = dynamic_cast<const compiler::file_part *>(buffer->source().get());
+	error_assert(part != nullptr && *part, "The source of buffer {} ({}) is not a file",
+				 buffer->id(), static_cast<const void *>(buffer.get()));
+
+	watch(buffer, part->source_file());
+}
+
+void shader_reloader::watch_directory(const std::string &directory)
+{
+#if LIBSHADERTOY_INOTIFY
+	if (fd_ >= 0)
+	{
+		if (std::any_of(directories_.begin(), directories_.end(),
+						[&](const auto &pair) { return pair.second == directory; }))
+		{
+			return;
+		}
+
+		int wd = inotify_add_watch(fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+		error_assert(wd >= 0, "Failed to watch {}: {}", directory, std::strerror(errno));
+
+		directories_[wd] = directory;
+	}
+#endif
+}
+
+void shader_reloader::watch(const std::shared_ptr<buffers::program_buffer> &buffer, const std::string &path)
+{
+	// Editors often replace files instead of writing to them, so we watch the
+	// parent directory instead of the file itself
+	fs::path file(fs::canonical(path));
+	watch_directory(file.parent_path().string());
+
+	buffers_.emplace(file.string(), buffer);
+
+	log::shadertoy()->debug("Watching {} for buffer {} ({})", file.string(), buffer->id(),
+							static_cast<const void *>(buffer.get()));
+}
+
+size_t shader_reloader::update(const render_context &context)
+{
+	std::set<std::string> changed;
+
+#if LIBSHADERTOY_INOTIFY
+	if (fd_ >= 0)
+	{
+		alignas(inotify_event) char buffer[4096];
+		ssize_t len;
+
+		while ((len = read(fd_, buffer, sizeof(buffer))) > 0)
+		{
+			for (char *ptr = buffer; ptr < buffer + len;)
+			{
+				auto event = reinterpret_cast<const inotify_event *>(ptr);
+				ptr += sizeof(inotify_event) + event->len;
+
+				auto it = directories_.find(event->wd);
+				if (it != directories_.end() && event->len > 0)
+				{
+					changed.insert((fs::path(it->second) / event->name).string());
+				}
+			}
+		}
+	}
+#endif
+
+	const auto &sources(context.source_files());
+
+	if (sources)
+	{
+		// Files including a changed file are affected too
+		std::set<std::string> dependents;
+		for (const auto &path : changed)
+		{
+			sources->invalidate(path);
+
+			auto file_dependents(sources->dependents(path));
+			dependents.insert(file_dependents.begin(), file_dependents.end());
+		}
+
+		changed.insert(dependents.begin(), dependents.end());
+
+		// Watch the files included by the watched files
+		if (sources->generation() != source_generation_)
+		{
+			source_generation_ = sources->generation();
+
+			for (auto it = buffers_.begin(); it != buffers_.end(); it = buffers_.upper_bound(it->first))
+			{
+				for (const auto &dependency : sources->dependencies(it->first))
+				{
+					watch_directory(fs::path(dependency).parent_path().string());
+				}
+			}
+		}
+	}
+
+	// Start reloading the affected buffers
+	for (const auto &path : changed)
+	{
+		auto range = buffers_.equal_range(path);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (auto buffer = it->second.lock())
+			{
+				log::shadertoy()->info("{} changed, reloading buffer {}", path, buffer->id());
+				buffer->reload(context);
+
+				if (std::none_of(reloading_.begin(), reloading_.end(),
+								 [&](const auto &ptr) { return ptr.lock() == buffer; }))
+				{
+					reloading_.push_back(buffer);
+				}
+			}
+		}
+	}
+
+	// Swap the programs which are ready
+	size_t swapped = 0;
+	for (auto it = reloading_.begin(); it != reloading_.end();)
+	{
+		auto buffer(it->lock());
+
+		if (buffer && buffer->commit_reload(context))
+		{
+			swapped++;
+		}
+
+		if (!buffer || !buffer->reload_pending())
+		{
+			it = reloading_.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	return swapped;
+}
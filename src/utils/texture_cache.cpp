@@ -0,0 +1,182 @@
+#include <algorithm>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/gl.hpp"
+
+#include "shadertoy/inputs/basic_input.hpp"
+
+#include "shadertoy/utils/log.hpp"
+#include "shadertoy/utils/texture_cache.hpp"
+
+#if __cpp_lib_filesystem >= 201703
+#include <filesystem>
+namespace fs = std::filesystem;
+#else
+#include <experimental/filesystem>
+namespace fs = std::experimental::filesystem::v1;
+#endif
+
+using namespace shadertoy;
+using namespace shadertoy::utils;
+
+texture_cache::texture_cache() : hits_(0), misses_(0) {}
+
+std::string texture_cache::key(const std::string &scheme, const std::map<std::string, std::string> &spec)
+{
+	std::string result(scheme);
+	result += "://";
+
+	auto path(spec.at(""));
+	if (scheme == "file")
+	{
+		std::error_code ec;
+		auto canonical(fs::canonical(fs::path(path), ec));
+		if (!ec)
+		{
+			path = canonical.string();
+		}
+	}
+
+	result += path;
+
+	// Parameters are sorted by name, so the order in the URI does not matter
+	char separator = '?';
+	for (const auto &pair : spec)
+	{
+		if (pair.first.empty())
+		{
+			continue;
+		}
+
+		result += separator;
+		result += pair.first;
+		result += '=';
+		result += pair.second;
+		separator = '&';
+	}
+
+	return result;
+}
+
+std::shared_ptr<inputs::basic_input> texture_cache::find(const std::string &key)
+{
+	auto it = inputs_.find(key);
+	if (it == inputs_.end())
+	{
+		return {};
+	}
+
+	auto input(it->second.lock());
+	if (input)
+	{
+		hits_++;
+	}
+	else
+	{
+		// No buffer is using this input anymore
+		inputs_.erase(it);
+	}
+
+	return input;
+}
+
+void texture_cache::emplace(const std::string &key, const std::shared_ptr<inputs::basic_input> &input)
+{
+	// Drop the inputs which are not in use anymore
+	for (auto it = inputs_.begin(); it != inputs_.end();)
+	{
+		if (it->second.expired())
+			it = inputs_.erase(it);
+		else
+			++it;
+	}
+
+	inputs_[key] = input;
+	misses_++;
+
+	log::shadertoy()->trace("Caching input {} as {}", static_cast<const void *>(input.get()), key);
+}
+
+size_t texture_cache::size() const
+{
+	return std::count_if(inputs_.begin(), inputs_.end(), [](const auto &pair) { return !pair.second.expired(); });
+}
+
+double texture_cache::hit_rate() const
+{
+	size_t lookups = hits_ + misses_;
+	return lookups == 0 ? 0.0 : static_cast<double>(hits_) / lookups;
+}
+
+size_t texture_cache::resident_bytes() const
+{
+	size_t bytes = 0;
+
+	for (const auto &pair : inputs_)
+	{
+		auto input(pair.second.lock());
+		if (!input || !input->loaded())
+		{
+			continue;
+		}
+
+		// Using the input would update its contents and its last use
+		if (auto texture = input->current_texture())
+		{
+			bytes += texture_bytes(*texture);
+		}
+	}
+
+	return bytes;
+}
+
+size_t texture_cache::texture_bytes(const gl::texture &texture)
+{
+	size_t bytes = 0;
+
+	for (GLint level = 0;; ++level)
+	{
+		GLint width, height, depth;
+		texture.get_parameter(level, GL_TEXTURE_WIDTH, &width);
+		texture.get_parameter(level, GL_TEXTURE_HEIGHT, &height);
+		texture.get_parameter(level, GL_TEXTURE_DEPTH, &depth);
+
+		// Past the last allocated level
+		if (width == 0)
+		{
+			break;
+		}
+
+		GLint compressed;
+		texture.get_parameter(level, GL_TEXTURE_COMPRESSED, &compressed);
+
+		if (compressed)
+		{
+			GLint size;
+			texture.get_parameter(level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+			bytes += size;
+		}
+		else
+		{
+			GLint bits = 0;
+			for (GLenum pname : { GL_TEXTURE_RED_SIZE, GL_TEXTURE_GREEN_SIZE, GL_TEXTURE_BLUE_SIZE,
+								  GL_TEXTURE_ALPHA_SIZE, GL_TEXTURE_DEPTH_SIZE, GL_TEXTURE_STENCIL_SIZE })
+			{
+				GLint size;
+				texture.get_parameter(level, pname, &size);
+				bits += size;
+			}
+
+			bytes += static_cast<size_t>(width) * height * std::max(depth, 1) * bits / 8;
+		}
+
+		// Last level of a complete mipmap chain
+		if (width == 1 && height <= 1 && depth <= 1)
+		{
+			break;
+		}
+	}
+
+	return bytes;
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+
+#include <epoxy/gl.h>
+
+#include "shadertoy/utils/log.hpp"
+#include "shadertoy/utils/thread_pool.hpp"
+
+using namespace shadertoy::utils;
+
+void thread_pool::run()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			condition_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+			if (tasks_.empty())
+			{
+				// Stopping and no more work to do
+				return;
+			}
+
+			task = std::move(tasks_.front());
+			tasks_.pop_front();
+		}
+
+		task();
+	}
+}
+
+thread_pool::thread_pool(unsigned int threads)
+: stopping_(false)
+{
+	if (threads == 0)
+	{
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	workers_.reserve(threads);
+	for (unsigned int i = 0; i < threads; ++i)
+	{
+		workers_.emplace_back(&thread_pool::run, this);
+	}
+
+	log::shadertoy()->debug("Started thread pool {} with {} workers", static_cast<const void *>(this), threads);
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+
+	condition_.notify_all();
+
+	for (auto &worker : workers_)
+	{
+		worker.join();
+	}
+}
+
+void thread_pool::enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		tasks_.emplace_back(std::move(task));
+	}
+
+	condition_.notify_one();
+}